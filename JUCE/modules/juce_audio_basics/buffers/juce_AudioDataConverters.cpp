@@ -462,6 +462,226 @@ void AudioDataConverters::deinterleaveSamples (const float* source, float** dest
                                     numSamples);
 }
 
+//==============================================================================
+namespace AudioDataHelpers
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    // What the conversion loop needs to know about a pair of layouts, worked out once per call
+    struct ConversionPlan
+    {
+        enum class Transform { none, intToFloat, floatToInt };
+
+        uint8 gatherMasks[4][16], scatterMask[16];
+        size_t numGathers, gatherStep;
+        size_t sourceBytesPerSample, sourceStride, destBytesPerSample, destStride;
+        Transform transform;
+        bool gatherIsIdentity, scatterIsIdentity;
+    };
+
+    namespace SSE41
+    {
+        struct Ops
+        {
+            using Vec = __m128i;
+            static constexpr size_t numLanes = 4;
+
+            JUCE_SSE41_TARGET static forcedinline Vec load (const uint8* src, size_t) noexcept  { return _mm_loadu_si128 ((const __m128i*) src); }
+            JUCE_SSE41_TARGET static forcedinline Vec loadMask (const uint8* mask) noexcept   { return _mm_loadu_si128 ((const __m128i*) mask); }
+            JUCE_SSE41_TARGET static forcedinline void store (uint8* dest, Vec v) noexcept    { _mm_storeu_si128 ((__m128i*) dest, v); }
+            JUCE_SSE41_TARGET static forcedinline Vec shuffle (Vec v, Vec mask) noexcept      { return _mm_shuffle_epi8 (v, mask); }
+            JUCE_SSE41_TARGET static forcedinline Vec bitOr (Vec a, Vec b) noexcept           { return _mm_or_si128 (a, b); }
+
+            // Stores the first 8, 12 or 16 bytes of v
+            JUCE_SSE41_TARGET static forcedinline void storePacked (uint8* dest, Vec v, size_t numBytes) noexcept
+            {
+                if (numBytes == 16)
+                {
+                    store (dest, v);
+                    return;
+                }
+
+                _mm_storel_epi64 ((__m128i*) dest, v);
+
+                if (numBytes == 12)
+                {
+                    const auto top = _mm_cvtsi128_si32 (_mm_srli_si128 (v, 8));
+                    memcpy (dest + 8, &top, 4);
+                }
+            }
+
+            // The ints are exact in a float, or round the same way as the double that getAsFloat() uses,
+            // and scaling by a power of two doesn't change that.
+            JUCE_SSE41_TARGET static forcedinline Vec intToFloat (Vec v) noexcept
+            {
+                return _mm_castps_si128 (_mm_mul_ps (_mm_cvtepi32_ps (v), _mm_set1_ps (1.0f / 2147483648.0f)));
+            }
+
+            // Float32::getAsInt32() clips and scales in double precision, so this has to as well
+            JUCE_SSE41_TARGET static forcedinline Vec scaleAndRound (__m128d v) noexcept
+            {
+                const auto clipped = _mm_min_pd (_mm_max_pd (v, _mm_set1_pd (-1.0)), _mm_set1_pd (1.0));
+                return _mm_cvtpd_epi32 (_mm_mul_pd (clipped, _mm_set1_pd ((double) 0x7fffffff)));
+            }
+
+            JUCE_SSE41_TARGET static forcedinline Vec floatToInt (Vec v) noexcept
+            {
+                const auto f = _mm_castsi128_ps (v);
+                return _mm_unpacklo_epi64 (scaleAndRound (_mm_cvtps_pd (f)),
+                                           scaleAndRound (_mm_cvtps_pd (_mm_movehl_ps (f, f))));
+            }
+        };
+
+        #define JUCE_SIMD_TARGET JUCE_SSE41_TARGET
+        #include "juce_AudioDataConverters_simd.h"
+        #undef JUCE_SIMD_TARGET
+    }
+
+    namespace AVX2
+    {
+        struct Ops
+        {
+            using Vec = __m256i;
+            static constexpr size_t numLanes = 8;
+
+            // The two halves come from separate loads, as the byte shuffles can't cross between them
+            JUCE_AVX2_TARGET static forcedinline Vec load (const uint8* src, size_t halfStep) noexcept
+            {
+                return _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((const __m128i*) src)),
+                                                _mm_loadu_si128 ((const __m128i*) (src + halfStep)), 1);
+            }
+
+            JUCE_AVX2_TARGET static forcedinline Vec loadMask (const uint8* mask) noexcept    { return _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*) mask)); }
+            JUCE_AVX2_TARGET static forcedinline void store (uint8* dest, Vec v) noexcept     { _mm256_storeu_si256 ((__m256i*) dest, v); }
+            JUCE_AVX2_TARGET static forcedinline Vec shuffle (Vec v, Vec mask) noexcept       { return _mm256_shuffle_epi8 (v, mask); }
+            JUCE_AVX2_TARGET static forcedinline Vec bitOr (Vec a, Vec b) noexcept            { return _mm256_or_si256 (a, b); }
+
+            JUCE_AVX2_TARGET static forcedinline void storePacked (uint8* dest, Vec v, size_t numBytesPerHalf) noexcept
+            {
+                SSE41::Ops::storePacked (dest, _mm256_castsi256_si128 (v), numBytesPerHalf);
+                SSE41::Ops::storePacked (dest + numBytesPerHalf, _mm256_extracti128_si256 (v, 1), numBytesPerHalf);
+            }
+
+            JUCE_AVX2_TARGET static forcedinline Vec intToFloat (Vec v) noexcept
+            {
+                return _mm256_castps_si256 (_mm256_mul_ps (_mm256_cvtepi32_ps (v), _mm256_set1_ps (1.0f / 2147483648.0f)));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline __m128i scaleAndRound (__m256d v) noexcept
+            {
+                const auto clipped = _mm256_min_pd (_mm256_max_pd (v, _mm256_set1_pd (-1.0)), _mm256_set1_pd (1.0));
+                return _mm256_cvtpd_epi32 (_mm256_mul_pd (clipped, _mm256_set1_pd ((double) 0x7fffffff)));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline Vec floatToInt (Vec v) noexcept
+            {
+                const auto f = _mm256_castsi256_ps (v);
+                return _mm256_inserti128_si256 (_mm256_castsi128_si256 (scaleAndRound (_mm256_cvtps_pd (_mm256_castps256_ps128 (f)))),
+                                                scaleAndRound (_mm256_cvtps_pd (_mm256_extractf128_ps (f, 1))), 1);
+            }
+        };
+
+        #define JUCE_SIMD_TARGET JUCE_AVX2_TARGET
+        #include "juce_AudioDataConverters_simd.h"
+        #undef JUCE_SIMD_TARGET
+    }
+
+    enum class InstructionSet { none, sse41, avx2 };
+
+    static InstructionSet findInstructionSet() noexcept
+    {
+        if (SystemStats::hasAVX2() && isRegisterStateEnabledByOS (xcr0AVXState))
+            return InstructionSet::avx2;
+
+        if (SystemStats::hasSSE41())
+            return InstructionSet::sse41;
+
+        return InstructionSet::none;
+    }
+
+    // Chosen while the statics are initialised, so the CPU is never queried on the audio thread.
+    static std::atomic<InstructionSet> instructionSet { InstructionSet::none };
+
+    static const struct InstructionSetInitialiser
+    {
+        InstructionSetInitialiser() noexcept  { instructionSet = findInstructionSet(); }
+    } instructionSetInitialiser;
+   #endif
+}
+
+int AudioData::convertSamplesWithSIMD (SampleLayout dest, SampleLayout source, int numSamples) noexcept
+{
+   #if JUCE_USE_SSE_INTRINSICS
+    using namespace AudioDataHelpers;
+
+    const auto set = instructionSet.load (std::memory_order_relaxed);
+
+    if (set == InstructionSet::none || numSamples < 8 || ! (dest.isSupportedBySIMD && source.isSupportedBySIMD))
+        return 0;
+
+    ConversionPlan plan;
+    plan.sourceBytesPerSample = (size_t) source.bytesPerSample;
+    plan.sourceStride         = (size_t) source.bytesBetweenSamples;
+    plan.destBytesPerSample   = (size_t) dest.bytesPerSample;
+    plan.destStride           = (size_t) dest.bytesBetweenSamples;
+
+    auto* src = static_cast<const uint8*> (source.data);
+    auto* dst = static_cast<uint8*> (const_cast<void*> (dest.data));
+
+    // Conversions that write over their own source are left to the scalar code
+    if (src < dst + ((size_t) numSamples - 1) * plan.destStride + plan.destBytesPerSample
+         && dst < src + ((size_t) numSamples - 1) * plan.sourceStride + plan.sourceBytesPerSample)
+        return 0;
+
+    // Each gather is one 16-byte load and shuffle, which can pick out as many samples
+    // as fit inside it, so interleaved data may need several per block of four.
+    const auto samplesPerGather = jmin ((size_t) 4, (16 - plan.sourceBytesPerSample) / plan.sourceStride + 1);
+    plan.numGathers = (4 + samplesPerGather - 1) / samplesPerGather;
+    plan.gatherStep = samplesPerGather * plan.sourceStride;
+
+    std::fill_n (&plan.gatherMasks[0][0], sizeof (plan.gatherMasks), (uint8) 0x80);
+    std::fill_n (plan.scatterMask, sizeof (plan.scatterMask), (uint8) 0x80);
+
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+        auto* mask = plan.gatherMasks[lane / samplesPerGather];
+        const auto offset = (lane % samplesPerGather) * plan.sourceStride;
+        const auto numBytes = plan.sourceBytesPerSample;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            mask[lane * 4 + 4 - numBytes + i] = (uint8) (offset + (source.isBigEndian ? numBytes - 1 - i : i));
+    }
+
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+        const auto numBytes = plan.destBytesPerSample;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            plan.scatterMask[lane * numBytes + i] = (uint8) (lane * 4 + (dest.isBigEndian ? 3 - i : 4 - numBytes + i));
+    }
+
+    const auto isNative32Bit = [] (const SampleLayout& l) { return l.bytesPerSample == 4 && l.bytesBetweenSamples == 4 && ! l.isBigEndian; };
+    plan.gatherIsIdentity  = isNative32Bit (source);
+    plan.scatterIsIdentity = isNative32Bit (dest);
+
+    plan.transform = source.isFloat == dest.isFloat ? ConversionPlan::Transform::none
+                                                    : (source.isFloat ? ConversionPlan::Transform::floatToInt
+                                                                      : ConversionPlan::Transform::intToFloat);
+
+    int numDone = 0;
+
+    if (set == InstructionSet::avx2)
+        numDone = AVX2::convert (plan, dst, src, (size_t) numSamples);
+
+    return numDone + SSE41::convert (plan,
+                                     dst + (size_t) numDone * plan.destStride,
+                                     src + (size_t) numDone * plan.sourceStride,
+                                     (size_t) (numSamples - numDone));
+   #else
+    ignoreUnused (dest, source, numSamples);
+    return 0;
+   #endif
+}
+
 //==============================================================================
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -577,6 +797,129 @@ public:
         }
     };
 
+   #if JUCE_USE_SSE_INTRINSICS
+    using InstructionSet = AudioDataHelpers::InstructionSet;
+
+    struct ScopedInstructionSet
+    {
+        explicit ScopedInstructionSet (InstructionSet set)
+            : previous (AudioDataHelpers::instructionSet.exchange (set)) {}
+
+        ~ScopedInstructionSet()  { AudioDataHelpers::instructionSet = previous; }
+
+        const InstructionSet previous;
+    };
+
+    static std::vector<InstructionSet> getAvailableInstructionSets()
+    {
+        switch (AudioDataHelpers::findInstructionSet())
+        {
+            case InstructionSet::avx2:   return { InstructionSet::sse41, InstructionSet::avx2 };
+            case InstructionSet::sse41:  return { InstructionSet::sse41 };
+            case InstructionSet::none:   break;
+        }
+
+        return {};
+    }
+
+    static String getName (InstructionSet set)
+    {
+        switch (set)
+        {
+            case InstructionSet::avx2:   return "AVX2";
+            case InstructionSet::sse41:  return "SSE4.1";
+            case InstructionSet::none:   break;
+        }
+
+        return "Scalar";
+    }
+
+    template <typename Callback>
+    static void forEachSIMDFormat (Callback&& callback)
+    {
+        callback (AudioData::Format<AudioData::Int16,   AudioData::LittleEndian>{});
+        callback (AudioData::Format<AudioData::Int16,   AudioData::BigEndian>{});
+        callback (AudioData::Format<AudioData::Int24,   AudioData::LittleEndian>{});
+        callback (AudioData::Format<AudioData::Int24,   AudioData::BigEndian>{});
+        callback (AudioData::Format<AudioData::Int32,   AudioData::LittleEndian>{});
+        callback (AudioData::Format<AudioData::Int32,   AudioData::BigEndian>{});
+        callback (AudioData::Format<AudioData::Float32, AudioData::LittleEndian>{});
+        callback (AudioData::Format<AudioData::Float32, AudioData::BigEndian>{});
+    }
+
+    template <typename Format, typename Interleaving = AudioData::NonInterleaved, typename Constness = AudioData::NonConst>
+    using PointerFor = AudioData::Pointer<typename Format::DataFormat, typename Format::Endianness, Interleaving, Constness>;
+
+    template <typename Format>
+    using ElementFor = std::remove_pointer_t<decltype (Format::DataFormat::data)>;
+
+    // Floats go a little out of range, so that the clipping gets checked too
+    template <typename Format>
+    static void fillWithTestSamples (void* data, int numSamples, Random& r)
+    {
+        PointerFor<Format> p (data);
+
+        for (int i = 0; i < numSamples; ++i, ++p)
+        {
+            if (p.isFloatingPoint())
+                p.setAsFloat (r.nextFloat() * 3.0f - 1.5f);
+            else
+                p.setAsInt32 (r.nextInt());
+        }
+    }
+
+    template <typename SourceFormat, typename DestFormat>
+    void checkSIMDMatchesPerSampleCode (Random& r)
+    {
+        const auto sourceBytes = PointerFor<SourceFormat>::getBytesPerSample();
+        const auto destBytes   = PointerFor<DestFormat>::getBytesPerSample();
+
+        for (auto numChannels : { 1, 2, 3, 6 })
+        {
+            for (auto numSamples : { 5, 8, 9, 61, 517 })
+            {
+                const auto total = numChannels * numSamples;
+                HeapBlock<char> interleaved ((size_t) (total * jmax (sourceBytes, destBytes))),
+                                expectedInterleaved ((size_t) (total * destBytes));
+                AudioBuffer<float> planar { numChannels, numSamples * 2 },
+                                   expectedPlanar { numChannels, numSamples * 2 };
+
+                // Deinterleaving: the per-sample code is used for runs shorter than a vector
+                fillWithTestSamples<SourceFormat> (interleaved, total, r);
+
+                AudioData::deinterleaveSamples (AudioData::InterleavedSource<SourceFormat> { reinterpret_cast<const ElementFor<SourceFormat>*> (interleaved.get()), numChannels },
+                                                AudioData::NonInterleavedDest<DestFormat>  { reinterpret_cast<ElementFor<DestFormat>* const*> (planar.getArrayOfWritePointers()), numChannels },
+                                                numSamples);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        (PointerFor<DestFormat> (expectedPlanar.getWritePointer (ch)) + i)
+                            .convertSamples (PointerFor<SourceFormat, AudioData::Interleaved, AudioData::Const> (interleaved + (i * numChannels + ch) * sourceBytes, numChannels), 1);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    expect (memcmp (planar.getReadPointer (ch), expectedPlanar.getReadPointer (ch), (size_t) (numSamples * destBytes)) == 0,
+                            "Deinterleaving " + String (numChannels) + " channels of " + String (numSamples) + " samples");
+
+                // Interleaving
+                for (int ch = 0; ch < numChannels; ++ch)
+                    fillWithTestSamples<SourceFormat> (planar.getWritePointer (ch), numSamples, r);
+
+                AudioData::interleaveSamples (AudioData::NonInterleavedSource<SourceFormat> { reinterpret_cast<const ElementFor<SourceFormat>* const*> (planar.getArrayOfReadPointers()), numChannels },
+                                              AudioData::InterleavedDest<DestFormat>        { reinterpret_cast<ElementFor<DestFormat>*> (interleaved.get()), numChannels },
+                                              numSamples);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        PointerFor<DestFormat, AudioData::Interleaved> (expectedInterleaved + (i * numChannels + ch) * destBytes, numChannels)
+                            .convertSamples (PointerFor<SourceFormat, AudioData::NonInterleaved, AudioData::Const> (addBytesToPointer (planar.getReadPointer (ch), i * sourceBytes)), 1);
+
+                expect (memcmp (interleaved, expectedInterleaved, (size_t) (total * destBytes)) == 0,
+                        "Interleaving " + String (numChannels) + " channels of " + String (numSamples) + " samples");
+            }
+        }
+    }
+   #endif
+
     void runTest() override
     {
         auto r = getRandom();
@@ -634,11 +977,104 @@ public:
                 for (int i = 0; i < numSamples; ++i)
                     expectEquals (sourceBuffer.getSample (0, ch + (i * numChannels)), destBuffer.getSample (ch, i));
         }
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto sets = getAvailableInstructionSets();
+
+        for (auto set : sets)
+        {
+            beginTest (getName (set) + " conversions match the per-sample code");
+
+            const ScopedInstructionSet scope (set);
+
+            forEachSIMDFormat ([&] (auto sourceFormat)
+            {
+                forEachSIMDFormat ([&] (auto destFormat)
+                {
+                    checkSIMDMatchesPerSampleCode<decltype (sourceFormat), decltype (destFormat)> (r);
+                });
+            });
+        }
+       #endif
     }
 };
 
 static AudioConversionTests audioConversionUnitTests;
 
+#if JUCE_USE_SSE_INTRINSICS
+
+//==============================================================================
+class AudioConversionBenchmark final : public UnitTestBenchmark
+{
+public:
+    AudioConversionBenchmark()
+        : UnitTestBenchmark ("Audio data conversion benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost of decoding 24-bit stereo per instruction set");
+
+        auto sets = Tests::getAvailableInstructionSets();
+        sets.insert (sets.begin(), InstructionSet::none);
+        logCostOfDecoding24BitStereo (sets);
+    }
+
+private:
+    using Tests = AudioConversionTests;
+    using InstructionSet = Tests::InstructionSet;
+
+    void logCostOfDecoding24BitStereo (const std::vector<InstructionSet>& sets)
+    {
+        using Source = AudioData::Format<AudioData::Int24, AudioData::LittleEndian>;
+
+        const auto numSamples = 4096;
+        const auto repeats = 200;
+
+        HeapBlock<char> source ((size_t) numSamples * 6);
+        auto r = getRandom();
+        Tests::fillWithTestSamples<Source> (source, numSamples * 2, r);
+
+        AudioBuffer<float> dest { 2, numSamples };
+
+        const auto time = [&] (auto destFormat)
+        {
+            using Dest = decltype (destFormat);
+
+            const auto fastest = measureFastestSeconds (5, [&]
+            {
+                for (int i = 0; i < repeats; ++i)
+                    AudioData::deinterleaveSamples (AudioData::InterleavedSource<Source> { source.get(), 2 },
+                                                    AudioData::NonInterleavedDest<Dest> { reinterpret_cast<Tests::ElementFor<Dest>* const*> (dest.getArrayOfWritePointers()), 2 },
+                                                    numSamples);
+            });
+
+            return fastest * 1.0e9 / (repeats * numSamples);
+        };
+
+        String toFloat, toInt;
+        toFloat << String ("To float").paddedRight (' ', 20);
+        toInt   << String ("To 32-bit int").paddedRight (' ', 20);
+
+        for (auto set : sets)
+        {
+            const Tests::ScopedInstructionSet scope (set);
+            toFloat << Tests::getName (set) << " " << String (time (AudioData::Format<AudioData::Float32, AudioData::NativeEndian>{}), 3) << " ns  ";
+            toInt   << Tests::getName (set) << " " << String (time (AudioData::Format<AudioData::Int32,   AudioData::NativeEndian>{}), 3) << " ns  ";
+        }
+
+        logMessage ("24-bit little-endian stereo, ns per frame:");
+        logMessage (toFloat);
+        logMessage (toInt);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static AudioConversionBenchmark audioConversionBenchmark;
+#endif
+
+#endif
+
 #endif
 
 JUCE_END_IGNORE_WARNINGS_MSVC
@@ -480,6 +480,11 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                const auto numDone = convertSamplesWithSIMD (getSampleLayout (dest), getSampleLayout (source), numSamples);
+                dest += numDone;
+                source += numDone;
+                numSamples -= numDone;
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -669,6 +674,34 @@ public:
     };
 
 private:
+    //==============================================================================
+    // Where a run of samples lives and how it's encoded, which is all that the
+    // vectorised conversion code needs to know about a Pointer.
+    struct SampleLayout
+    {
+        const void* data;
+        int bytesPerSample, bytesBetweenSamples;
+        bool isFloat, isBigEndian, isSupportedBySIMD;
+    };
+
+    template <class PointerType>
+    static SampleLayout getSampleLayout (const PointerType& p) noexcept
+    {
+        const auto bytesPerSample = PointerType::getBytesPerSample();
+
+        // 8-bit and 24-in-32-bit samples are rare enough to leave to the scalar code
+        const auto isSupported = bytesPerSample > 1
+                                  && (bytesPerSample < 4 || PointerType::isFloatingPoint() || PointerType::get32BitResolution() == 1);
+
+        return { p.getRawData(), bytesPerSample, p.getNumBytesBetweenSamples(),
+                 PointerType::isFloatingPoint(), PointerType::isBigEndian(), isSupported };
+    }
+
+    // Converts as many of the samples as it can with SIMD instructions, giving exactly the
+    // same results as the per-sample code, and returns how many that was. The rest are
+    // left for the caller.
+    static int convertSamplesWithSIMD (SampleLayout dest, SampleLayout source, int numSamples) noexcept;
+
     template <bool IsInterleaved, bool IsConst, typename...>
     struct ChannelDataSubtypes;
 
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/*  The sample conversion loop for one of the x86 instruction sets.
+
+    juce_AudioDataConverters.cpp includes this once per instruction set, inside
+    a namespace that defines Ops for it, with JUCE_SIMD_TARGET set to the
+    attribute that lets the compiler use it.
+
+    Each block of samples is gathered into 32-bit lanes with byte shuffles,
+    left-aligned the way getAsInt32() returns them (floats keep their bits),
+    converted between the integer and float domains if need be, then shuffled
+    back out into the destination's byte layout.
+*/
+
+JUCE_SIMD_TARGET static forcedinline void storeSample (uint8* dest, const uint8* packed, int numBytes) noexcept
+{
+    switch (numBytes)
+    {
+        case 2:  memcpy (dest, packed, 2); break;
+        case 3:  memcpy (dest, packed, 3); break;
+        default: memcpy (dest, packed, 4); break;
+    }
+}
+
+// The number of gathers and the transform are template parameters so that the loop
+// has nothing to decide per block except how to store the result.
+template <size_t numGathers, ConversionPlan::Transform transform>
+JUCE_SIMD_TARGET static void convertBlocks (const ConversionPlan& plan, uint8* dest, const uint8* source, size_t numBlocks) noexcept
+{
+    using Vec = Ops::Vec;
+    constexpr size_t numLanes = Ops::numLanes;
+
+    // Copied out of the plan, as the byte stores below could otherwise alias it
+    const auto sourceStride = plan.sourceStride, destStride = plan.destStride;
+    const auto destBytesPerSample = plan.destBytesPerSample;
+    const auto gatherStep = plan.gatherStep, halfStep = 4 * sourceStride;
+    const auto gatherIsIdentity = plan.gatherIsIdentity, scatterIsIdentity = plan.scatterIsIdentity;
+    const auto destIsPacked = destStride == destBytesPerSample;
+
+    Vec gatherMasks[numGathers];
+
+    for (size_t i = 0; i < numGathers; ++i)
+        gatherMasks[i] = Ops::loadMask (plan.gatherMasks[i]);
+
+    const auto scatterMask = Ops::loadMask (plan.scatterMask);
+
+    for (size_t block = 0; block < numBlocks; ++block)
+    {
+        const auto* in = source + block * numLanes * sourceStride;
+        auto* out = dest + block * numLanes * destStride;
+
+        auto v = Ops::load (in, halfStep);
+
+        if (! gatherIsIdentity)
+        {
+            v = Ops::shuffle (v, gatherMasks[0]);
+
+            for (size_t i = 1; i < numGathers; ++i)
+                v = Ops::bitOr (v, Ops::shuffle (Ops::load (in + i * gatherStep, halfStep), gatherMasks[i]));
+        }
+
+        if constexpr (transform == ConversionPlan::Transform::intToFloat)
+            v = Ops::intToFloat (v);
+        else if constexpr (transform == ConversionPlan::Transform::floatToInt)
+            v = Ops::floatToInt (v);
+
+        if (scatterIsIdentity)
+        {
+            Ops::store (out, v);
+            continue;
+        }
+
+        v = Ops::shuffle (v, scatterMask);
+
+        if (destIsPacked)
+        {
+            Ops::storePacked (out, v, 4 * destBytesPerSample);
+            continue;
+        }
+
+        alignas (32) uint8 packed[numLanes * 4];
+        Ops::store (packed, v);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            storeSample (out + lane * destStride,
+                         packed + (lane / 4) * 16 + (lane % 4) * destBytesPerSample,
+                         (int) destBytesPerSample);
+    }
+}
+
+template <size_t numGathers>
+JUCE_SIMD_TARGET static void convertBlocks (const ConversionPlan& plan, uint8* dest, const uint8* source, size_t numBlocks) noexcept
+{
+    switch (plan.transform)
+    {
+        case ConversionPlan::Transform::intToFloat:  return convertBlocks<numGathers, ConversionPlan::Transform::intToFloat> (plan, dest, source, numBlocks);
+        case ConversionPlan::Transform::floatToInt:  return convertBlocks<numGathers, ConversionPlan::Transform::floatToInt> (plan, dest, source, numBlocks);
+        case ConversionPlan::Transform::none:        return convertBlocks<numGathers, ConversionPlan::Transform::none>       (plan, dest, source, numBlocks);
+    }
+}
+
+JUCE_SIMD_TARGET static int convert (const ConversionPlan& plan, uint8* dest, const uint8* source, size_t numSamples) noexcept
+{
+    constexpr size_t numLanes = Ops::numLanes;
+
+    if (numSamples < numLanes)
+        return 0;
+
+    // Each 128-bit half of a vector is loaded separately, and every load reads 16 bytes,
+    // so the last block has to stop short of the end of the source data.
+    const auto halfStep = 4 * plan.sourceStride;
+    const auto bytesReadPerBlock = (numLanes / 4 - 1) * halfStep + (plan.numGathers - 1) * plan.gatherStep + 16;
+    const auto sourceSize = (numSamples - 1) * plan.sourceStride + plan.sourceBytesPerSample;
+
+    if (sourceSize < bytesReadPerBlock)
+        return 0;
+
+    const auto numBlocks = jmin (numSamples / numLanes, (sourceSize - bytesReadPerBlock) / (numLanes * plan.sourceStride) + 1);
+
+    switch (plan.numGathers)
+    {
+        case 1:   convertBlocks<1> (plan, dest, source, numBlocks); break;
+        case 2:   convertBlocks<2> (plan, dest, source, numBlocks); break;
+        default:  convertBlocks<4> (plan, dest, source, numBlocks); break;
+    }
+
+    return (int) (numBlocks * numLanes);
+}
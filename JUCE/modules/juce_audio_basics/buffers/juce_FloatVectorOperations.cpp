@@ -503,6 +503,231 @@ namespace FloatVectorHelpers
     };
    #endif
 
+    //==============================================================================
+   #if JUCE_USE_AVX_DISPATCH
+    namespace AVX2
+    {
+        struct BasicOps32
+        {
+            using Type = float;
+            using ParallelType = __m256;
+            enum { numParallel = 8 };
+
+            // Selects the first num lanes
+            JUCE_AVX2_TARGET static forcedinline __m256i getMask (size_t num) noexcept
+            {
+                return _mm256_cmpgt_epi32 (_mm256_set1_epi32 ((int) num), _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_ps (v); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_ps (v); }
+            JUCE_AVX2_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_ps (dest, a); }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType loadPartial (const Type* v, size_t num, ParallelType fill) noexcept
+            {
+                const auto mask = getMask (num);
+                return _mm256_blendv_ps (fill, _mm256_maskload_ps (v, mask), _mm256_castsi256_ps (mask));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline void storePartial (Type* dest, ParallelType a, size_t num) noexcept
+            {
+                _mm256_maskstore_ps (dest, getMask (num), a);
+            }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_ps (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_ps (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_ps (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_ps (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_ps (a, b); }
+
+            // a * b + c and c - a * b, each with a single rounding
+            JUCE_AVX2_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept     { return _mm256_fmadd_ps (a, b, c); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType negMulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fnmadd_ps (a, b, c); }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_ps (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType absMask() noexcept  { return _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff)); }
+
+            JUCE_AVX2_TARGET static forcedinline Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            JUCE_AVX2_TARGET static forcedinline Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = double;
+            using ParallelType = __m256d;
+            enum { numParallel = 4 };
+
+            // Selects the first num lanes
+            JUCE_AVX2_TARGET static forcedinline __m256i getMask (size_t num) noexcept
+            {
+                return _mm256_cmpgt_epi64 (_mm256_set1_epi64x ((long long) num), _mm256_setr_epi64x (0, 1, 2, 3));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_pd (v); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_pd (v); }
+            JUCE_AVX2_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_pd (dest, a); }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType loadPartial (const Type* v, size_t num, ParallelType fill) noexcept
+            {
+                const auto mask = getMask (num);
+                return _mm256_blendv_pd (fill, _mm256_maskload_pd (v, mask), _mm256_castsi256_pd (mask));
+            }
+
+            JUCE_AVX2_TARGET static forcedinline void storePartial (Type* dest, ParallelType a, size_t num) noexcept
+            {
+                _mm256_maskstore_pd (dest, getMask (num), a);
+            }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_pd (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_pd (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_pd (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_pd (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_pd (a, b); }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept     { return _mm256_fmadd_pd (a, b, c); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType negMulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fnmadd_pd (a, b, c); }
+
+            JUCE_AVX2_TARGET static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_pd (a, b); }
+            JUCE_AVX2_TARGET static forcedinline ParallelType absMask() noexcept  { return _mm256_castsi256_pd (_mm256_set1_epi64x (0x7fffffffffffffffLL)); }
+
+            JUCE_AVX2_TARGET static forcedinline Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+            JUCE_AVX2_TARGET static forcedinline Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+        };
+
+        #define JUCE_WIDE_TARGET JUCE_AVX2_TARGET
+        #include "juce_FloatVectorOperations_avx.h"
+        #undef JUCE_WIDE_TARGET
+    }
+
+    // GCC's AVX-512 headers start some results from deliberately undefined values
+    JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wmaybe-uninitialized")
+
+    namespace AVX512
+    {
+        struct BasicOps32
+        {
+            using Type = float;
+            using ParallelType = __m512;
+            enum { numParallel = 16 };
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_ps (v); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_ps (v); }
+            JUCE_AVX512_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_ps (dest, a); }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType loadPartial (const Type* v, size_t num, ParallelType fill) noexcept
+            {
+                return _mm512_mask_loadu_ps (fill, (__mmask16) ((1u << num) - 1), v);
+            }
+
+            JUCE_AVX512_TARGET static forcedinline void storePartial (Type* dest, ParallelType a, size_t num) noexcept
+            {
+                _mm512_mask_storeu_ps (dest, (__mmask16) ((1u << num) - 1), a);
+            }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_ps (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_ps (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_ps (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_ps (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_ps (a, b); }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept     { return _mm512_fmadd_ps (a, b, c); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType negMulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm512_fnmadd_ps (a, b, c); }
+
+            // The floating point logic instructions need AVX512DQ, so these go through the integer ones
+            JUCE_AVX512_TARGET static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept
+            {
+                return _mm512_castsi512_ps (_mm512_and_si512 (_mm512_castps_si512 (a), _mm512_castps_si512 (b)));
+            }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType absMask() noexcept  { return _mm512_castsi512_ps (_mm512_set1_epi32 (0x7fffffff)); }
+
+            JUCE_AVX512_TARGET static forcedinline Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            JUCE_AVX512_TARGET static forcedinline Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = double;
+            using ParallelType = __m512d;
+            enum { numParallel = 8 };
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_pd (v); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_pd (v); }
+            JUCE_AVX512_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_pd (dest, a); }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType loadPartial (const Type* v, size_t num, ParallelType fill) noexcept
+            {
+                return _mm512_mask_loadu_pd (fill, (__mmask8) ((1u << num) - 1), v);
+            }
+
+            JUCE_AVX512_TARGET static forcedinline void storePartial (Type* dest, ParallelType a, size_t num) noexcept
+            {
+                _mm512_mask_storeu_pd (dest, (__mmask8) ((1u << num) - 1), a);
+            }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_pd (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_pd (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_pd (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_pd (a, b); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_pd (a, b); }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept     { return _mm512_fmadd_pd (a, b, c); }
+            JUCE_AVX512_TARGET static forcedinline ParallelType negMulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm512_fnmadd_pd (a, b, c); }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept
+            {
+                return _mm512_castsi512_pd (_mm512_and_si512 (_mm512_castpd_si512 (a), _mm512_castpd_si512 (b)));
+            }
+
+            JUCE_AVX512_TARGET static forcedinline ParallelType absMask() noexcept  { return _mm512_castsi512_pd (_mm512_set1_epi64 (0x7fffffffffffffffLL)); }
+
+            JUCE_AVX512_TARGET static forcedinline Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            JUCE_AVX512_TARGET static forcedinline Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        #define JUCE_WIDE_TARGET JUCE_AVX512_TARGET
+        #include "juce_FloatVectorOperations_avx.h"
+        #undef JUCE_WIDE_TARGET
+    }
+
+    JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+    enum class WideInstructionSet
+    {
+        none,
+        avx2,
+        avx512
+    };
+
+    static WideInstructionSet findWideInstructionSet() noexcept
+    {
+        if (! (SystemStats::hasAVX2() && SystemStats::hasFMA3() && isRegisterStateEnabledByOS (xcr0AVXState)))
+            return WideInstructionSet::none;
+
+        return SystemStats::hasAVX512F() && isRegisterStateEnabledByOS (xcr0AVX512State) ? WideInstructionSet::avx512
+                                                                                         : WideInstructionSet::avx2;
+    }
+
+    // Chosen while the statics are initialised, so the CPU is never queried on the audio thread.
+    // Anything that runs before then uses the SSE code.
+    static std::atomic<WideInstructionSet> wideInstructionSet { WideInstructionSet::none };
+
+    static const struct WideInstructionSetInitialiser
+    {
+        WideInstructionSetInitialiser() noexcept  { wideInstructionSet = findWideInstructionSet(); }
+    } wideInstructionSetInitialiser;
+
+    #define JUCE_DISPATCH_WIDE_VEC_OP(name, ...) \
+        switch (FloatVectorHelpers::wideInstructionSet.load (std::memory_order_relaxed)) \
+        { \
+            case FloatVectorHelpers::WideInstructionSet::avx512:  return FloatVectorHelpers::AVX512::name (__VA_ARGS__); \
+            case FloatVectorHelpers::WideInstructionSet::avx2:    return FloatVectorHelpers::AVX2::name (__VA_ARGS__); \
+            case FloatVectorHelpers::WideInstructionSet::none:    break; \
+        }
+   #else
+    #define JUCE_DISPATCH_WIDE_VEC_OP(name, ...)
+   #endif
+
 //==============================================================================
 namespace
 {
@@ -1196,6 +1421,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::fill (FloatT
                                                                           FloatType valueToFill,
                                                                           CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (fill, dest, valueToFill, numValues)
     FloatVectorHelpers::fill (dest, valueToFill, numValues);
 }
 
@@ -1213,6 +1439,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::copyWithMult
                                                                                       FloatType multiplier,
                                                                                       CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (copyWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::copyWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1221,6 +1448,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatTy
                                                                          FloatType amountToAdd,
                                                                          CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (add, dest, amountToAdd, numValues)
     FloatVectorHelpers::add (dest, amountToAdd, numValues);
 }
 
@@ -1230,6 +1458,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatTy
                                                                          FloatType amount,
                                                                          CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (add, dest, src, amount, numValues)
     FloatVectorHelpers::add (dest, src, amount, numValues);
 }
 
@@ -1238,6 +1467,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatTy
                                                                          const FloatType* src,
                                                                          CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (add, dest, src, numValues)
     FloatVectorHelpers::add (dest, src, numValues);
 }
 
@@ -1247,6 +1477,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatTy
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (add, dest, src1, src2, num)
     FloatVectorHelpers::add (dest, src1, src2, num);
 }
 
@@ -1255,6 +1486,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtract (Fl
                                                                               const FloatType* src,
                                                                               CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (subtract, dest, src, numValues)
     FloatVectorHelpers::subtract (dest, src, numValues);
 }
 
@@ -1264,6 +1496,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtract (Fl
                                                                               const FloatType* src2,
                                                                               CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (subtract, dest, src1, src2, num)
     FloatVectorHelpers::subtract (dest, src1, src2, num);
 }
 
@@ -1273,6 +1506,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::addWithMulti
                                                                                      FloatType multiplier,
                                                                                      CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::addWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1282,6 +1516,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::addWithMulti
                                                                                      const FloatType* src2,
                                                                                      CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply, dest, src1, src2, num)
     FloatVectorHelpers::addWithMultiply (dest, src1, src2, num);
 }
 
@@ -1291,6 +1526,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtractWith
                                                                                           FloatType multiplier,
                                                                                           CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::subtractWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1300,6 +1536,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtractWith
                                                                                           const FloatType* src2,
                                                                                           CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply, dest, src1, src2, num)
     FloatVectorHelpers::subtractWithMultiply (dest, src1, src2, num);
 }
 
@@ -1308,6 +1545,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Fl
                                                                               const FloatType* src,
                                                                               CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (multiply, dest, src, numValues)
     FloatVectorHelpers::multiply (dest, src, numValues);
 }
 
@@ -1317,6 +1555,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Fl
                                                                               const FloatType* src2,
                                                                               CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (multiply, dest, src1, src2, numValues)
     FloatVectorHelpers::multiply (dest, src1, src2, numValues);
 }
 
@@ -1325,6 +1564,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Fl
                                                                               FloatType multiplier,
                                                                               CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (multiply, dest, multiplier, numValues)
     FloatVectorHelpers::multiply (dest, multiplier, numValues);
 }
 
@@ -1334,6 +1574,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Fl
                                                                               FloatType multiplier,
                                                                               CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (multiply, dest, src, multiplier, num)
     FloatVectorHelpers::multiply (dest, src, multiplier, num);
 }
 
@@ -1342,6 +1583,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::negate (Floa
                                                                             const FloatType* src,
                                                                             CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (negate, dest, src, numValues)
     FloatVectorHelpers::negate (dest, src, numValues);
 }
 
@@ -1350,6 +1592,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::abs (FloatTy
                                                                          const FloatType* src,
                                                                          CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (abs, dest, src, numValues)
     FloatVectorHelpers::abs (dest, src, numValues);
 }
 
@@ -1359,6 +1602,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::min (FloatTy
                                                                          FloatType comp,
                                                                          CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (min, dest, src, comp, num)
     FloatVectorHelpers::min (dest, src, comp, num);
 }
 
@@ -1368,6 +1612,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::min (FloatTy
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (min, dest, src1, src2, num)
     FloatVectorHelpers::min (dest, src1, src2, num);
 }
 
@@ -1377,6 +1622,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::max (FloatTy
                                                                          FloatType comp,
                                                                          CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (max, dest, src, comp, num)
     FloatVectorHelpers::max (dest, src, comp, num);
 }
 
@@ -1386,6 +1632,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::max (FloatTy
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (max, dest, src1, src2, num)
     FloatVectorHelpers::max (dest, src1, src2, num);
 }
 
@@ -1396,6 +1643,7 @@ void JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::clip (FloatT
                                                                           FloatType high,
                                                                           CountType num) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (clip, dest, src, low, high, num)
     FloatVectorHelpers::clip (dest, src, low, high, num);
 }
 
@@ -1403,6 +1651,7 @@ template <typename FloatType, typename CountType>
 Range<FloatType> JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMinAndMax (const FloatType* src,
                                                                                                CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (findMinAndMax, src, numValues)
     return FloatVectorHelpers::findMinAndMax (src, numValues);
 }
 
@@ -1410,6 +1659,7 @@ template <typename FloatType, typename CountType>
 FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMinimum (const FloatType* src,
                                                                                       CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (findMinimum, src, numValues)
     return FloatVectorHelpers::findMinimum (src, numValues);
 }
 
@@ -1417,6 +1667,7 @@ template <typename FloatType, typename CountType>
 FloatType JUCE_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMaximum (const FloatType* src,
                                                                                       CountType numValues) noexcept
 {
+    JUCE_DISPATCH_WIDE_VEC_OP (findMaximum, src, numValues)
     return FloatVectorHelpers::findMaximum (src, numValues);
 }
 
@@ -1709,6 +1960,136 @@ public:
         }
     };
 
+   #if JUCE_USE_AVX_DISPATCH
+    using WideInstructionSet = FloatVectorHelpers::WideInstructionSet;
+
+    struct ScopedInstructionSet
+    {
+        explicit ScopedInstructionSet (WideInstructionSet set)
+            : previous (FloatVectorHelpers::wideInstructionSet.exchange (set)) {}
+
+        ~ScopedInstructionSet()  { FloatVectorHelpers::wideInstructionSet = previous; }
+
+        const WideInstructionSet previous;
+    };
+
+    static std::vector<WideInstructionSet> getAvailableWideInstructionSets()
+    {
+        switch (FloatVectorHelpers::findWideInstructionSet())
+        {
+            case WideInstructionSet::avx512:  return { WideInstructionSet::avx2, WideInstructionSet::avx512 };
+            case WideInstructionSet::avx2:    return { WideInstructionSet::avx2 };
+            case WideInstructionSet::none:    break;
+        }
+
+        return {};
+    }
+
+    static String getName (WideInstructionSet set)
+    {
+        switch (set)
+        {
+            case WideInstructionSet::avx512:  return "AVX-512";
+            case WideInstructionSet::avx2:    return "AVX2";
+            case WideInstructionSet::none:    break;
+        }
+
+        return "SSE";
+    }
+
+    // Every operation, reading from src1 and src2 and writing to dest
+    template <typename ValueType>
+    struct NamedOp
+    {
+        const char* name;
+        bool isFused;
+        void (*run) (ValueType* dest, const ValueType* src1, const ValueType* src2, int num);
+    };
+
+    template <typename ValueType>
+    static std::vector<NamedOp<ValueType>> getAllOps()
+    {
+        using FVO = FloatVectorOperations;
+        using T = ValueType;
+
+        return {
+            { "fill",                          false, [] (T* d, const T*, const T*, int n)        { FVO::fill (d, (T) 0.25, n); } },
+            { "copyWithMultiply",              false, [] (T* d, const T* a, const T*, int n)      { FVO::copyWithMultiply (d, a, (T) 1.5, n); } },
+            { "add (dest, amount)",            false, [] (T* d, const T*, const T*, int n)        { FVO::add (d, (T) 0.5, n); } },
+            { "add (dest, src, amount)",       false, [] (T* d, const T* a, const T*, int n)      { FVO::add (d, a, (T) 0.5, n); } },
+            { "add (dest, src)",               false, [] (T* d, const T* a, const T*, int n)      { FVO::add (d, a, n); } },
+            { "add (dest, src1, src2)",        false, [] (T* d, const T* a, const T* b, int n)    { FVO::add (d, a, b, n); } },
+            { "subtract (dest, src)",          false, [] (T* d, const T* a, const T*, int n)      { FVO::subtract (d, a, n); } },
+            { "subtract (dest, src1, src2)",   false, [] (T* d, const T* a, const T* b, int n)    { FVO::subtract (d, a, b, n); } },
+            { "addWithMultiply (scalar)",      true,  [] (T* d, const T* a, const T*, int n)      { FVO::addWithMultiply (d, a, (T) 0.3, n); } },
+            { "addWithMultiply (vector)",      true,  [] (T* d, const T* a, const T* b, int n)    { FVO::addWithMultiply (d, a, b, n); } },
+            { "subtractWithMultiply (scalar)", true,  [] (T* d, const T* a, const T*, int n)      { FVO::subtractWithMultiply (d, a, (T) 0.3, n); } },
+            { "subtractWithMultiply (vector)", true,  [] (T* d, const T* a, const T* b, int n)    { FVO::subtractWithMultiply (d, a, b, n); } },
+            { "multiply (dest, src)",          false, [] (T* d, const T* a, const T*, int n)      { FVO::multiply (d, a, n); } },
+            { "multiply (dest, src1, src2)",   false, [] (T* d, const T* a, const T* b, int n)    { FVO::multiply (d, a, b, n); } },
+            { "multiply (dest, multiplier)",   false, [] (T* d, const T*, const T*, int n)        { FVO::multiply (d, (T) 0.7, n); } },
+            { "multiply (dest, src, mult.)",   false, [] (T* d, const T* a, const T*, int n)      { FVO::multiply (d, a, (T) 0.7, n); } },
+            { "negate",                        false, [] (T* d, const T* a, const T*, int n)      { FVO::negate (d, a, n); } },
+            { "abs",                           false, [] (T* d, const T* a, const T*, int n)      { FVO::abs (d, a, n); } },
+            { "min (dest, src, comp)",         false, [] (T* d, const T* a, const T*, int n)      { FVO::min (d, a, (T) 0.1, n); } },
+            { "min (dest, src1, src2)",        false, [] (T* d, const T* a, const T* b, int n)    { FVO::min (d, a, b, n); } },
+            { "max (dest, src, comp)",         false, [] (T* d, const T* a, const T*, int n)      { FVO::max (d, a, (T) 0.1, n); } },
+            { "max (dest, src1, src2)",        false, [] (T* d, const T* a, const T* b, int n)    { FVO::max (d, a, b, n); } },
+            { "clip",                          false, [] (T* d, const T* a, const T*, int n)      { FVO::clip (d, a, (T) -0.5, (T) 0.5, n); } },
+            { "findMinAndMax",                 false, [] (T* d, const T* a, const T*, int n)      { const auto r = FVO::findMinAndMax (a, n); d[0] = r.getStart(); d[1] = r.getEnd(); } },
+            { "findMinimum",                   false, [] (T* d, const T* a, const T*, int n)      { d[0] = FVO::findMinimum (a, n); } },
+            { "findMaximum",                   false, [] (T* d, const T* a, const T*, int n)      { d[0] = FVO::findMaximum (a, n); } }
+        };
+    }
+
+    template <typename ValueType>
+    void checkInstructionSetMatchesSSE (WideInstructionSet set)
+    {
+        auto random = getRandom();
+        const auto maxSize = 70;
+
+        HeapBlock<ValueType> src1 (maxSize + 16), src2 (maxSize + 16), expected (maxSize + 16), actual (maxSize + 16);
+
+        for (const auto& op : getAllOps<ValueType>())
+        {
+            auto maxError = (ValueType) 0;
+
+            for (int num = 0; num <= maxSize; ++num)
+            {
+                // Misaligned on purpose, as in the tests above
+                auto* const a = addBytesToPointer (src1.get(), random.nextInt (4) * (int) sizeof (ValueType));
+                auto* const b = addBytesToPointer (src2.get(), random.nextInt (4) * (int) sizeof (ValueType));
+                const auto offset = random.nextInt (4);
+
+                for (int i = 0; i < maxSize + 8; ++i)
+                {
+                    src1[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                    src2[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                    expected[i] = actual[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+                }
+
+                {
+                    const ScopedInstructionSet scope (WideInstructionSet::none);
+                    op.run (expected + offset, a, b, num);
+                }
+
+                {
+                    const ScopedInstructionSet scope (set);
+                    op.run (actual + offset, a, b, num);
+                }
+
+                // Values past the end must be left alone, so this checks the whole buffer
+                for (int i = 0; i < maxSize + 8; ++i)
+                    maxError = jmax (maxError, std::abs (expected[i] - actual[i]));
+            }
+
+            // The fused multiply-adds round once instead of twice
+            const auto tolerance = op.isFused ? 4 * std::numeric_limits<ValueType>::epsilon() : (ValueType) 0;
+            expect (maxError <= tolerance, getName (set) + " " + op.name + " differs from SSE by " + String (maxError));
+        }
+    }
+   #endif
+
     void runTest() override
     {
         beginTest ("FloatVectorOperations");
@@ -1718,11 +2099,113 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+       #if JUCE_USE_AVX_DISPATCH
+        const auto wideSets = getAvailableWideInstructionSets();
+
+        if (wideSets.empty())
+            logMessage ("No AVX2 or AVX-512 on this CPU, so only the SSE code was tested");
+
+        for (auto set : wideSets)
+        {
+            beginTest ("FloatVectorOperations with " + getName (set));
+
+            const ScopedInstructionSet scope (set);
+
+            for (int i = 1000; --i >= 0;)
+            {
+                TestRunner<float>::runTest (*this, getRandom());
+                TestRunner<double>::runTest (*this, getRandom());
+            }
+        }
+
+        for (auto set : wideSets)
+        {
+            beginTest (getName (set) + " gives the same results as SSE");
+
+            checkInstructionSetMatchesSSE<float> (set);
+            checkInstructionSetMatchesSSE<double> (set);
+        }
+       #endif
     }
 };
 
 static FloatVectorOperationsTests vectorOpTests;
 
+#if JUCE_USE_AVX_DISPATCH
+
+//==============================================================================
+class FloatVectorOperationsBenchmark final : public UnitTestBenchmark
+{
+public:
+    FloatVectorOperationsBenchmark()
+        : UnitTestBenchmark ("FloatVectorOperations Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost of each operation per instruction set");
+
+        auto sets = Tests::getAvailableWideInstructionSets();
+        sets.insert (sets.begin(), WideInstructionSet::none);
+
+        logMessage ("float, 512 values, ns per value:");
+        logCostOfEachOperation<float> (sets);
+
+        logMessage ("double, 512 values, ns per value:");
+        logCostOfEachOperation<double> (sets);
+    }
+
+private:
+    using Tests = FloatVectorOperationsTests;
+    using WideInstructionSet = Tests::WideInstructionSet;
+
+    template <typename ValueType>
+    void logCostOfEachOperation (const std::vector<WideInstructionSet>& sets)
+    {
+        // Running the in-place operations again and again would leave denormals otherwise
+        const ScopedNoDenormals noDenormals;
+
+        const auto num = 512;
+        const auto repeats = 20000;
+
+        HeapBlock<ValueType> src1 (num), src2 (num), dest (num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            src1[i] = (ValueType) std::sin (i * 0.1);
+            src2[i] = (ValueType) std::cos (i * 0.1);
+            dest[i] = (ValueType) 0;
+        }
+
+        for (const auto& op : Tests::getAllOps<ValueType>())
+        {
+            String line;
+            line << String (op.name).paddedRight (' ', 31);
+
+            for (auto set : sets)
+            {
+                const Tests::ScopedInstructionSet scope (set);
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < repeats; ++i)
+                    op.run (dest, src1, src2, num);
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                line << Tests::getName (set) << " " << String (seconds * 1.0e9 / (repeats * num), 3) << " ns  ";
+            }
+
+            logMessage (line);
+        }
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static FloatVectorOperationsBenchmark vectorOpBenchmark;
+#endif
+
+#endif
+
 #endif
 
 } // namespace juce
@@ -0,0 +1,351 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/*  The FloatVectorOperations kernels for one of the wide x86 instruction sets.
+
+    juce_FloatVectorOperations.cpp includes this once per instruction set, inside
+    a namespace that defines BasicOps32 and BasicOps64 for it, with
+    JUCE_WIDE_TARGET set to the attribute that lets the compiler use it. Every
+    function here needs that attribute, as the compiler won't inline the
+    intrinsics into a function that isn't allowed to use them.
+
+    Unlike the SSE code, the last partial vector is handled with a masked load
+    and store, so every value goes through the same instructions.
+*/
+
+template <int typeSize> struct ModeType    { using Mode = BasicOps32; };
+template <>             struct ModeType<8> { using Mode = BasicOps64; };
+
+template <typename Size>
+static forcedinline size_t toCount (Size num) noexcept
+{
+    return num > 0 ? (size_t) num : 0;
+}
+
+// Stores op (the values of each source) into dest
+template <typename Mode, typename Op, typename... Sources>
+JUCE_WIDE_TARGET static forcedinline void perform (typename Mode::Type* dest, size_t num, Op op, const Sources*... sources) noexcept
+{
+    size_t i = 0;
+
+    for (; i + Mode::numParallel <= num; i += Mode::numParallel)
+        Mode::storeU (dest + i, op (Mode::loadU (sources + i)...));
+
+    if (const auto remaining = num - i; remaining > 0)
+    {
+        const auto zero = Mode::load1 ({});
+        Mode::storePartial (dest + i, op (Mode::loadPartial (sources + i, remaining, zero)...), remaining);
+    }
+}
+
+template <typename Mode>
+struct WideOps
+{
+    using ParallelType = typename Mode::ParallelType;
+
+    struct Add { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::add (a, b); } };
+    struct Sub { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::sub (a, b); } };
+    struct Mul { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::mul (a, b); } };
+    struct Min { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::min (a, b); } };
+    struct Max { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::max (a, b); } };
+    struct And { JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a, ParallelType b) const noexcept { return Mode::bit_and (a, b); } };
+
+    struct Constant
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator()() const noexcept  { return value; }
+        ParallelType value;
+    };
+
+    // Applies a two-argument op with a fixed second argument
+    template <typename Op>
+    struct WithConstant
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType a) const noexcept  { return Op{} (a, value); }
+        ParallelType value;
+    };
+
+    struct AddProduct
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType d, ParallelType s1, ParallelType s2) const noexcept  { return Mode::mulAdd (s1, s2, d); }
+    };
+
+    struct SubtractProduct
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType d, ParallelType s1, ParallelType s2) const noexcept  { return Mode::negMulAdd (s1, s2, d); }
+    };
+
+    struct AddScaled
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType d, ParallelType s) const noexcept  { return Mode::mulAdd (s, multiplier, d); }
+        ParallelType multiplier;
+    };
+
+    struct SubtractScaled
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType d, ParallelType s) const noexcept  { return Mode::negMulAdd (s, multiplier, d); }
+        ParallelType multiplier;
+    };
+
+    struct Clip
+    {
+        JUCE_WIDE_TARGET forcedinline ParallelType operator() (ParallelType s) const noexcept  { return Mode::max (Mode::min (s, high), low); }
+        ParallelType low, high;
+    };
+};
+
+#define JUCE_WIDE_OPS                                       \
+    using Mode = typename ModeType<sizeof (Type)>::Mode;   \
+    using Ops = WideOps<Mode>;
+
+//==============================================================================
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void fill (Type* dest, Type valueToFill, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Constant { Mode::load1 (valueToFill) });
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void copyWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Mul> { Mode::load1 (multiplier) }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void add (Type* dest, Type amount, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Add> { Mode::load1 (amount) }, dest);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void add (Type* dest, const Type* src, Type amount, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Add> { Mode::load1 (amount) }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void add (Type* dest, const Type* src, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Add{}, dest, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void add (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Add{}, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void subtract (Type* dest, const Type* src, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Sub{}, dest, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void subtract (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Sub{}, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void addWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::AddScaled { Mode::load1 (multiplier) }, dest, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void addWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::AddProduct{}, dest, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void subtractWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::SubtractScaled { Mode::load1 (multiplier) }, dest, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void subtractWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::SubtractProduct{}, dest, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void multiply (Type* dest, const Type* src, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Mul{}, dest, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void multiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Mul{}, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void multiply (Type* dest, Type multiplier, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Mul> { Mode::load1 (multiplier) }, dest);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void multiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Mul> { Mode::load1 (multiplier) }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void negate (Type* dest, const Type* src, Size num) noexcept
+{
+    copyWithMultiply (dest, src, (Type) -1, num);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void abs (Type* dest, const Type* src, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::And> { Mode::absMask() }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void min (Type* dest, const Type* src, Type comp, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Min> { Mode::load1 (comp) }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void min (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Min{}, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void max (Type* dest, const Type* src, Type comp, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::template WithConstant<typename Ops::Max> { Mode::load1 (comp) }, src);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void max (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Max{}, src1, src2);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET void clip (Type* dest, const Type* src, Type low, Type high, Size num) noexcept
+{
+    jassert (high >= low);
+
+    JUCE_WIDE_OPS
+    perform<Mode> (dest, toCount (num), typename Ops::Clip { Mode::load1 (low), Mode::load1 (high) }, src);
+}
+
+//==============================================================================
+// Finds the minimum and/or maximum with two sets of accumulators, so that consecutive
+// vectors don't wait on each other. The lanes of a partial vector that lie past the
+// end are filled with the first value, which can't change the result. The first value
+// also stands in for a result that wasn't asked for.
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET Range<Type> findMinAndMax (const Type* src, Size numIn, bool wantMinimum, bool wantMaximum) noexcept
+{
+    JUCE_WIDE_OPS
+    const auto num = toCount (numIn);
+
+    if (num == 0)
+        return {};
+
+    const auto first = Mode::load1 (src[0]);
+    auto mn1 = first, mn2 = first, mx1 = first, mx2 = first;
+    size_t i = 0;
+
+    for (; i + 2 * Mode::numParallel <= num; i += 2 * Mode::numParallel)
+    {
+        const auto v1 = Mode::loadU (src + i);
+        const auto v2 = Mode::loadU (src + i + Mode::numParallel);
+
+        if (wantMinimum)  { mn1 = Mode::min (mn1, v1); mn2 = Mode::min (mn2, v2); }
+        if (wantMaximum)  { mx1 = Mode::max (mx1, v1); mx2 = Mode::max (mx2, v2); }
+    }
+
+    for (; i < num; i += Mode::numParallel)
+    {
+        const auto v = Mode::loadPartial (src + i, jmin (num - i, (size_t) Mode::numParallel), first);
+
+        if (wantMinimum)  mn1 = Mode::min (mn1, v);
+        if (wantMaximum)  mx1 = Mode::max (mx1, v);
+    }
+
+    return { wantMinimum ? Mode::min (Mode::min (mn1, mn2)) : src[0],
+             wantMaximum ? Mode::max (Mode::max (mx1, mx2)) : src[0] };
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET Range<Type> findMinAndMax (const Type* src, Size num) noexcept
+{
+    return findMinAndMax (src, num, true, true);
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET Type findMinimum (const Type* src, Size num) noexcept
+{
+    return findMinAndMax (src, num, true, false).getStart();
+}
+
+template <typename Type, typename Size>
+JUCE_WIDE_TARGET Type findMaximum (const Type* src, Size num) noexcept
+{
+    return findMinAndMax (src, num, false, true).getEnd();
+}
+
+#undef JUCE_WIDE_OPS
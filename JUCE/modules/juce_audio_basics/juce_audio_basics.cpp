@@ -45,6 +45,62 @@
 
 #if JUCE_USE_SSE_INTRINSICS
  #include <emmintrin.h>
+ #include <immintrin.h>
+
+ // For functions that use instructions beyond the SSE2 baseline. These are only
+ // called once the CPU has been checked for support.
+ #if JUCE_MSVC
+  #define JUCE_SSE41_TARGET
+  #define JUCE_AVX2_TARGET
+  #define JUCE_AVX512_TARGET
+ #else
+  #define JUCE_SSE41_TARGET   __attribute__ ((target ("sse4.1")))
+  #define JUCE_AVX2_TARGET    __attribute__ ((target ("avx2,fma")))
+  #define JUCE_AVX512_TARGET  __attribute__ ((target ("avx512f,avx2,fma")))
+ #endif
+
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+
+namespace juce
+{
+    // The CPUID feature bits only say what the CPU can do. The AVX registers can only be used if
+    // the OS also saves them on a context switch, which it reports through the XCR0 register.
+    static bool isRegisterStateEnabledByOS (uint64 xcr0Mask) noexcept
+    {
+        constexpr unsigned int osxsaveBit = 1u << 27;
+
+       #if JUCE_MSVC
+        int info[4] = {};
+        __cpuid (info, 1);
+
+        if (((unsigned int) info[2] & osxsaveBit) == 0)
+            return false;
+
+        const auto xcr0 = (uint64) _xgetbv (0);
+       #else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+        if (! __get_cpuid (1, &eax, &ebx, &ecx, &edx) || (ecx & osxsaveBit) == 0)
+            return false;
+
+        unsigned int xcr0Low = 0, xcr0High = 0;
+        __asm__ volatile ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+        const auto xcr0 = ((uint64) xcr0High << 32) | xcr0Low;
+       #endif
+
+        return (xcr0 & xcr0Mask) == xcr0Mask;
+    }
+
+    // XMM and YMM state, needed for AVX and AVX2
+    static constexpr uint64 xcr0AVXState    = 0x06;
+
+    // Also the opmask and both halves of the ZMM state, needed for AVX-512
+    static constexpr uint64 xcr0AVX512State = 0xe6;
+}
 #endif
 
 #if JUCE_MAC || JUCE_IOS
@@ -62,6 +118,10 @@
  #undef JUCE_USE_VDSP_FRAMEWORK
 #endif
 
+#if JUCE_USE_VDSP_FRAMEWORK
+ #undef JUCE_USE_AVX_DISPATCH   // Accelerate already picks the best code for the CPU
+#endif
+
 #if JUCE_USE_ARM_NEON
  #include <arm_neon.h>
 #endif
@@ -78,6 +78,22 @@
  #undef JUCE_USE_SSE_INTRINSICS
 #endif
 
+// Lets FloatVectorOperations switch to AVX2 or AVX-512 code when the CPU it runs on has them,
+// whatever instruction set the rest of the code was compiled for
+#ifndef JUCE_USE_AVX_DISPATCH
+ #define JUCE_USE_AVX_DISPATCH 1
+#endif
+
+#if ! (JUCE_USE_SSE_INTRINSICS && JUCE_64BIT)
+ #undef JUCE_USE_AVX_DISPATCH
+#endif
+
+// Registers the timing tests in the Benchmarks category along with the unit tests. They only
+// take measurements, so they're left out unless a test harness asks for them
+#ifndef JUCE_UNIT_TEST_BENCHMARKS
+ #define JUCE_UNIT_TEST_BENCHMARKS 0
+#endif
+
 #if __ARM_NEON__ && ! (JUCE_USE_VDSP_FRAMEWORK || defined (JUCE_USE_ARM_NEON))
  #define JUCE_USE_ARM_NEON 1
 #endif
@@ -104,6 +120,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "utilities/juce_SmoothedValue.h"
 #include "utilities/juce_Reverb.h"
 #include "utilities/juce_ADSR.h"
+#include "utilities/juce_UnitTestBenchmark.h"
 #include "midi/juce_MidiMessage.h"
 #include "midi/juce_MidiBuffer.h"
 #include "midi/juce_MidiMessageSequence.h"
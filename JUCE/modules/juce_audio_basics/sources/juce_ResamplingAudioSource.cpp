@@ -35,6 +35,539 @@
 namespace juce
 {
 
+namespace ResamplingHelpers
+{
+    struct QualitySettings
+    {
+        int numTaps, numPhases, numHalfBandPairs;
+        double cutoff, kaiserBeta;
+    };
+
+    static QualitySettings getQualitySettings (ResamplingAudioSource::Quality quality) noexcept
+    {
+        switch (quality)
+        {
+            case ResamplingAudioSource::Quality::low:     return { 16,  64,  4,  0.80, 5.0 };
+            case ResamplingAudioSource::Quality::high:    return { 128, 256, 16, 0.94, 10.0 };
+            case ResamplingAudioSource::Quality::medium:  break;
+        }
+
+        return { 48, 128, 8, 0.90, 7.5 };
+    }
+
+    static double besselI0 (double x) noexcept
+    {
+        auto sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 64 && term > sum * 1.0e-12; ++k)
+        {
+            const auto t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static double kaiserWindow (double proportionOfHalfLength, double beta) noexcept
+    {
+        const auto u = jmin (1.0, std::abs (proportionOfHalfLength));
+        return besselI0 (beta * std::sqrt (1.0 - u * u)) / besselI0 (beta);
+    }
+
+    static double sinc (double x) noexcept
+    {
+        return x == 0.0 ? 1.0 : std::sin (MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+    }
+
+    static float dotProduct (const float* a, const float* b, int num) noexcept
+    {
+        int i = 0;
+        auto result = 0.0f;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        auto sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+
+        for (; i + 8 <= num; i += 8)
+        {
+            sum0 = _mm_add_ps (sum0, _mm_mul_ps (_mm_loadu_ps (a + i),     _mm_loadu_ps (b + i)));
+            sum1 = _mm_add_ps (sum1, _mm_mul_ps (_mm_loadu_ps (a + i + 4), _mm_loadu_ps (b + i + 4)));
+        }
+
+        alignas (16) float lanes[4];
+        _mm_store_ps (lanes, _mm_add_ps (sum0, sum1));
+        result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+       #elif JUCE_USE_ARM_NEON
+        auto sum0 = vdupq_n_f32 (0.0f), sum1 = vdupq_n_f32 (0.0f);
+
+        for (; i + 8 <= num; i += 8)
+        {
+            sum0 = vmlaq_f32 (sum0, vld1q_f32 (a + i),     vld1q_f32 (b + i));
+            sum1 = vmlaq_f32 (sum1, vld1q_f32 (a + i + 4), vld1q_f32 (b + i + 4));
+        }
+
+        const auto sum = vaddq_f32 (sum0, sum1);
+        result = (vgetq_lane_f32 (sum, 0) + vgetq_lane_f32 (sum, 1)) + (vgetq_lane_f32 (sum, 2) + vgetq_lane_f32 (sum, 3));
+       #endif
+
+        for (; i < num; ++i)
+            result += a[i] * b[i];
+
+        return result;
+    }
+
+    // dest = a + (b - a) * proportionOfB
+    static void interpolate (float* dest, const float* a, const float* b, float proportionOfB, int num) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto p = _mm_set1_ps (proportionOfB);
+
+        for (; i + 4 <= num; i += 4)
+        {
+            const auto va = _mm_loadu_ps (a + i);
+            _mm_storeu_ps (dest + i, _mm_add_ps (va, _mm_mul_ps (_mm_sub_ps (_mm_loadu_ps (b + i), va), p)));
+        }
+       #elif JUCE_USE_ARM_NEON
+        for (; i + 4 <= num; i += 4)
+        {
+            const auto va = vld1q_f32 (a + i);
+            vst1q_f32 (dest + i, vmlaq_n_f32 (va, vsubq_f32 (vld1q_f32 (b + i), va), proportionOfB));
+        }
+       #endif
+
+        for (; i < num; ++i)
+            dest[i] = a[i] + (b[i] - a[i]) * proportionOfB;
+    }
+
+    static void dropSamples (AudioBuffer<float>& buffer, int numToDrop, int numBuffered) noexcept
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+            std::copy (data + numToDrop, data + numBuffered, data);
+        }
+    }
+
+    // Halving the rate with half-band filters first keeps the polyphase kernel short.
+    // Stopping at 4 rather than 2 leaves room for the half-band filters' transition
+    // bands, which would otherwise alias into the top of the output's spectrum.
+    constexpr double maxPolyphaseRatio = 4.0;
+
+    // Enough half-band filters for a ratio of 1024, which are all made in prepareToPlay()
+    constexpr size_t maxNumHalvings = 8;
+
+    static size_t getNumHalvings (double ratio) noexcept
+    {
+        size_t numHalvings = 0;
+
+        for (; ratio > maxPolyphaseRatio && numHalvings < maxNumHalvings; ratio *= 0.5)
+            ++numHalvings;
+
+        return numHalvings;
+    }
+}
+
+//==============================================================================
+/*  Halves the sample rate with a half-band filter, which has every other tap
+    at zero. Separating the even and odd input samples turns the remaining taps
+    into runs of contiguous multiply-adds. Like the polyphase filter, it reads
+    ahead of its input rather than adding latency.
+
+    Besides the input its taps need, it keeps the last historySize samples, so
+    the polyphase filter can carry on from them if the ratio drops and this is
+    taken out of the chain. All of its buffers are allocated up front.
+*/
+class ResamplingAudioSource::HalfBandDecimator
+{
+public:
+    HalfBandDecimator (int numChannelsToUse, Quality quality, int historySizeToUse, int bufferSize)
+        : numPairs (ResamplingHelpers::getQualitySettings (quality).numHalfBandPairs),
+          historySize (historySizeToUse),
+          maxBlockSize ((bufferSize - historySize - 4 * numPairs + 3) / 2),
+          buffer (numChannelsToUse, bufferSize),
+          even ((size_t) (maxBlockSize + 2 * numPairs - 1)),
+          odd ((size_t) maxBlockSize)
+    {
+        using namespace ResamplingHelpers;
+
+        jassert (maxBlockSize > 0);
+
+        const auto beta = getQualitySettings (quality).kaiserBeta;
+        auto sum = 0.5;
+
+        for (int i = 1; i <= numPairs; ++i)
+        {
+            const auto distance = 2 * i - 1;
+            const auto value = 0.5 * sinc (distance * 0.5) * kaiserWindow (distance / (2.0 * numPairs), beta);
+            coefficients.push_back ((float) value);
+            sum += 2.0 * value;
+        }
+
+        centreCoefficient = (float) (0.5 / sum);
+        FloatVectorOperations::multiply (coefficients.data(), (float) (1.0 / sum), numPairs);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        buffer.clear();
+        numBuffered = historySize + 2 * numPairs - 1;
+    }
+
+    template <typename ReadInput>
+    void process (AudioBuffer<float>& dest, int startSample, int numSamples, ReadInput&& readInput)
+    {
+        // Requests bigger than the buffer was sized for are done in pieces
+        for (int done = 0; done < numSamples;)
+        {
+            const auto num = jmin (numSamples - done, maxBlockSize);
+            const auto numNeeded = historySize + 2 * num + 4 * numPairs - 3;
+
+            if (numNeeded > numBuffered)
+            {
+                readInput (buffer, numBuffered, numNeeded - numBuffered);
+                numBuffered = numNeeded;
+            }
+
+            filter (dest, startSample + done, num);
+            done += num;
+        }
+    }
+
+    // Starts off with input that has already been read: input[centre] becomes the centre
+    // of output number numOutputsBefore. As many outputs as that input is enough for are
+    // written over the start of it, and their number is returned.
+    int takeOver (AudioBuffer<float>& input, int numInput, int centre, int numOutputsBefore) noexcept
+    {
+        const auto shift = getCentreOfNextOutput() + 2 * numOutputsBefore - centre;
+        const auto numSkipped = jlimit (0, numInput, -shift);
+        const auto numPadding = jmax (0, shift);
+
+        numBuffered = jmin (buffer.getNumSamples(), numPadding + numInput - numSkipped);
+        jassert (numBuffered == numPadding + numInput - numSkipped);
+
+        buffer.clear (0, numPadding);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            FloatVectorOperations::copy (buffer.getWritePointer (channel, numPadding),
+                                         input.getReadPointer (channel, numSkipped),
+                                         numBuffered - numPadding);
+
+        const auto numOutputs = jlimit (0, maxBlockSize, (numBuffered - (historySize + 4 * numPairs - 3)) / 2);
+        filter (input, 0, numOutputs);
+        return numOutputs;
+    }
+
+    // Copies everything that's buffered, the history included, and returns how much that was
+    int handBack (AudioBuffer<float>& dest) const noexcept
+    {
+        const auto num = jmin (numBuffered, dest.getNumSamples());
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            FloatVectorOperations::copy (dest.getWritePointer (channel), buffer.getReadPointer (channel), num);
+
+        return num;
+    }
+
+    // Where the input that the next output will be centred on is buffered
+    int getCentreOfNextOutput() const noexcept      { return historySize + 2 * numPairs - 1; }
+
+private:
+    void filter (AudioBuffer<float>& dest, int startSample, int numSamples) noexcept
+    {
+        using namespace ResamplingHelpers;
+
+        const auto numEven = numSamples + 2 * numPairs - 1;
+
+        for (int channel = 0; channel < dest.getNumChannels(); ++channel)
+        {
+            const auto* in = buffer.getReadPointer (channel, historySize);
+            auto* out = dest.getWritePointer (channel, startSample);
+
+            for (int i = 0; i < numEven; ++i)
+                even[(size_t) i] = in[2 * i];
+
+            for (int i = 0; i < numSamples; ++i)
+                odd[(size_t) i] = in[2 * (numPairs + i) - 1];
+
+            FloatVectorOperations::copyWithMultiply (out, odd.data(), centreCoefficient, numSamples);
+
+            for (int i = 1; i <= numPairs; ++i)
+            {
+                const auto c = coefficients[(size_t) i - 1];
+                FloatVectorOperations::addWithMultiply (out, even.data() + numPairs - i,     c, numSamples);
+                FloatVectorOperations::addWithMultiply (out, even.data() + numPairs - 1 + i, c, numSamples);
+            }
+        }
+
+        dropSamples (buffer, 2 * numSamples, numBuffered);
+        numBuffered -= 2 * numSamples;
+    }
+
+    const int numPairs, historySize, maxBlockSize;
+    float centreCoefficient = 0.5f;
+    std::vector<float> coefficients;
+    AudioBuffer<float> buffer;
+    std::vector<float> even, odd;
+    int numBuffered = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (HalfBandDecimator)
+};
+
+//==============================================================================
+/*  Evaluates a windowed-sinc kernel at arbitrary positions in its input.
+
+    The kernel is tabulated at numPhases + 1 fractional offsets, and the two
+    tables either side of each output's offset are interpolated, so only that
+    interpolation and a dot product per channel are needed for each output sample.
+    When downsampling, the kernel is stretched by the ratio so that it cuts off
+    below the output's Nyquist frequency.
+
+    Kernels are made up front for stretches a quarter of an octave apart, plus an
+    exact one for the ratio it is prepared with, so a change of ratio while running
+    only has to pick the shortest kernel that is stretched far enough.
+
+    Each output is centred on its position in the input, which this reads ahead
+    of, so the resampling doesn't add any latency.
+*/
+class ResamplingAudioSource::PolyphaseFilter
+{
+public:
+    PolyphaseFilter (int numChannelsToUse, Quality quality, double initialRatio, int maxBlockSizeToUse)
+        : settings (ResamplingHelpers::getQualitySettings (quality)),
+          maxBlockSize (jmax (1, maxBlockSizeToUse))
+    {
+        using namespace ResamplingHelpers;
+
+        // Half of the kernel, measured as a proportion of its half-length, which
+        // is the same shape whatever the kernel gets stretched to
+        const auto zeroCrossings = settings.cutoff * settings.numTaps * 0.5;
+
+        for (size_t i = 0; i <= prototypeResolution; ++i)
+        {
+            const auto u = (double) i / (double) prototypeResolution;
+            prototype[i] = (float) (sinc (u * zeroCrossings) * kaiserWindow (u, settings.kaiserBeta));
+        }
+
+        for (int i = 0; i <= 8; ++i)
+            addTable (std::pow (2.0, i * 0.25));
+
+        const auto initialStretch = jlimit (1.0, maxPolyphaseRatio, initialRatio);
+
+        if (std::none_of (tables.begin(), tables.end(), [&] (const auto& t) { return isCloseEnough (t.stretch, initialStretch); }))
+            addTable (initialStretch);
+
+        std::sort (tables.begin(), tables.end(), [] (const auto& a, const auto& b) { return a.stretch < b.stretch; });
+
+        const auto maxNumTaps = tables.back().numTaps;
+
+        // Enough history that three half-band filters put in at once can each halve it, and
+        // still leave the longest kernel what it needs
+        maxNumBefore = maxNumTaps / 2 - 1;
+        historySize = 8 * (maxNumBefore + 2 * settings.numHalfBandPairs);
+
+        // A half-band filter keeps enough history for this to carry on from it, even if
+        // two more filters further up the chain were taken out just before
+        decimatorHistorySize = 2 * historySize + 4 * maxNumTaps;
+
+        // Room for a block's worth of input, or for everything a half-band filter hands back
+        const auto numReadAhead = (int) maxPolyphaseRatio * maxBlockSize + maxNumTaps + 3;
+        buffer.setSize (numChannelsToUse, decimatorHistorySize + 4 * settings.numHalfBandPairs + 2 * historySize + numReadAhead);
+        kernel.resize ((size_t) maxNumTaps);
+
+        setRatio (initialRatio);
+        reset();
+    }
+
+    void setRatio (double newRatio) noexcept
+    {
+        ratio = newRatio;
+        const auto stretch = jmax (1.0, ratio);
+
+        // Small changes to a downsampling ratio don't move the cutoff far enough to need a longer kernel
+        const auto found = std::find_if (tables.begin(), tables.end(), [&] (const auto& t) { return t.stretch >= stretch || isCloseEnough (t.stretch, stretch); });
+        table = found != tables.end() ? &*found : &tables.back();
+    }
+
+    void reset() noexcept
+    {
+        buffer.clear();
+        numBuffered = historySize;
+        position = numBuffered;
+    }
+
+    template <typename ReadInput>
+    void process (float* const* dest, int numChannelsToProcess, int numSamples, ReadInput&& readInput)
+    {
+        // Requests bigger than the buffer was sized for are done in pieces
+        for (int done = 0; done < numSamples;)
+        {
+            const auto num = jmin (numSamples - done, maxBlockSize);
+            processBlock (dest, done, numChannelsToProcess, num, readInput);
+            done += num;
+        }
+    }
+
+    // The sizes of buffer a half-band filter in front of this needs
+    int getDecimatorHistorySize() const noexcept    { return decimatorHistorySize; }
+    int getDecimatorBufferSize() const noexcept     { return buffer.getNumSamples() + decimatorHistorySize + 2 * historySize + 4 * settings.numHalfBandPairs; }
+
+    // These change the rate of the input while keeping what's buffered, converted to the new
+    // rate, so the output carries on without a gap
+    void insertDecimator (HalfBandDecimator&) noexcept;
+    void removeDecimator (HalfBandDecimator&) noexcept;
+
+    // A decimator can only be taken out if its history reaches back far enough behind the
+    // position to cover what's buffered here, which is at twice the rate
+    bool canRemoveDecimator (const HalfBandDecimator&) const noexcept;
+
+private:
+    struct Table
+    {
+        double stretch;
+        int numTaps;
+        std::vector<float> coefficients;
+    };
+
+    static constexpr size_t prototypeResolution = 4096;
+
+    static bool isCloseEnough (double stretch, double target) noexcept    { return std::abs (stretch - target) <= target * 0.01; }
+
+    double getPositionAfterRemoving (const HalfBandDecimator& decimator) const noexcept
+    {
+        return decimator.getCentreOfNextOutput() + 2.0 * (position - numBuffered);
+    }
+
+    const float* getRow (int row) const noexcept    { return table->coefficients.data() + (size_t) (row * table->numTaps); }
+
+    template <typename ReadInput>
+    void processBlock (float* const* dest, int offset, int numChannelsToProcess, int numSamples, ReadInput& readInput)
+    {
+        using namespace ResamplingHelpers;
+
+        const auto numTaps = table->numTaps;
+        const auto numBefore = numTaps / 2 - 1;
+        jassert ((int) position >= numBefore);
+
+        // One extra sample, in case rounding moves the last position across a boundary
+        const auto numNeeded = (int) (position + (numSamples - 1) * ratio) + numTaps / 2 + 2;
+        jassert (numNeeded <= buffer.getNumSamples());
+
+        if (numNeeded > numBuffered)
+        {
+            readInput (buffer, numBuffered, numNeeded - numBuffered);
+            numBuffered = numNeeded;
+        }
+
+        if (ratio == 1.0 && position == std::floor (position))
+        {
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                FloatVectorOperations::copy (dest[channel] + offset, buffer.getReadPointer (channel, (int) position), numSamples);
+
+            position += numSamples;
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto centre = (int) position;
+                const auto phase = (position - centre) * settings.numPhases;
+                const auto row = (int) phase;
+
+                interpolate (kernel.data(), getRow (row), getRow (row + 1), (float) (phase - row), numTaps);
+
+                for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                    dest[channel][offset + i] = dotProduct (kernel.data(), buffer.getReadPointer (channel, centre - numBefore), numTaps);
+
+                position += ratio;
+            }
+        }
+
+        // Anything before the history that's kept won't be needed again
+        if (const auto numToDrop = (int) position - historySize; numToDrop > 0)
+        {
+            dropSamples (buffer, numToDrop, numBuffered);
+            numBuffered -= numToDrop;
+            position -= numToDrop;
+        }
+    }
+
+    void addTable (double stretch)
+    {
+        auto& newTable = tables.emplace_back();
+        newTable.stretch = stretch;
+
+        const auto halfLength = settings.numTaps * 0.5 * stretch;
+        const auto numTaps = newTable.numTaps = ((2 * (int) std::ceil (halfLength)) + 7) & ~7;
+        newTable.coefficients.resize ((size_t) ((settings.numPhases + 1) * numTaps));
+
+        for (int row = 0; row <= settings.numPhases; ++row)
+        {
+            auto* coeffs = newTable.coefficients.data() + (size_t) (row * numTaps);
+            const auto centre = (numTaps / 2 - 1) + (double) row / settings.numPhases;
+            auto sum = 0.0;
+
+            for (int i = 0; i < numTaps; ++i)
+            {
+                const auto u = std::abs (i - centre) / halfLength * (double) prototypeResolution;
+                const auto index = (size_t) u;
+                auto value = 0.0f;
+
+                if (index < prototypeResolution)
+                    value = prototype[index] + (float) (u - (double) index) * (prototype[index + 1] - prototype[index]);
+
+                coeffs[i] = value;
+                sum += value;
+            }
+
+            // Every phase has unity gain at DC
+            FloatVectorOperations::multiply (coeffs, (float) (1.0 / sum), numTaps);
+        }
+    }
+
+    const ResamplingHelpers::QualitySettings settings;
+    const int maxBlockSize;
+    int maxNumBefore = 0, historySize = 0, decimatorHistorySize = 0;
+    std::array<float, prototypeResolution + 1> prototype;
+    std::vector<Table> tables;
+    const Table* table = nullptr;
+    std::vector<float> kernel;
+    AudioBuffer<float> buffer;
+    double ratio = 1.0, position = 0.0;
+    int numBuffered = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (PolyphaseFilter)
+};
+
+void ResamplingAudioSource::PolyphaseFilter::insertDecimator (HalfBandDecimator& decimator) noexcept
+{
+    // The decimator starts from what's buffered here, and its output replaces it. Each of
+    // its outputs needs the inputs either side, so a little less than half the history is
+    // left, and only if that's too short for the kernels does it start with some silence.
+    const auto centre = (int) position;
+    const auto numBefore = jmax (maxNumBefore, (centre - 2 * settings.numHalfBandPairs + 1) / 2);
+    numBuffered = decimator.takeOver (buffer, numBuffered, centre, numBefore);
+    position = numBefore + (position - centre) * 0.5;
+}
+
+void ResamplingAudioSource::PolyphaseFilter::removeDecimator (HalfBandDecimator& decimator) noexcept
+{
+    jassert (canRemoveDecimator (decimator));
+
+    // The decimator's input, at twice the rate, takes the place of its output
+    position = getPositionAfterRemoving (decimator);
+    numBuffered = decimator.handBack (buffer);
+}
+
+bool ResamplingAudioSource::PolyphaseFilter::canRemoveDecimator (const HalfBandDecimator& decimator) const noexcept
+{
+    return getPositionAfterRemoving (decimator) >= historySize;
+}
+
+//==============================================================================
 ResamplingAudioSource::ResamplingAudioSource (AudioSource* const inputSource,
                                               const bool deleteInputWhenDeleted,
                                               const int channels)
@@ -42,7 +575,6 @@ ResamplingAudioSource::ResamplingAudioSource (AudioSource* const inputSource,
       numChannels (channels)
 {
     jassert (input != nullptr);
-    zeromem (coefficients, sizeof (coefficients));
 }
 
 ResamplingAudioSource::~ResamplingAudioSource() {}
@@ -55,44 +587,122 @@ void ResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputS
     ratio = jmax (0.0, samplesInPerOutputSample);
 }
 
+void ResamplingAudioSource::setQuality (Quality newQuality)
+{
+    const ScopedLock sl (callbackLock);
+
+    if (std::exchange (quality, newQuality) != newQuality && polyphaseFilter != nullptr)
+        createFilters();
+}
+
 void ResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    const SpinLock::ScopedLockType sl (ratioLock);
+    double localRatio;
+
+    {
+        const SpinLock::ScopedLockType sl (ratioLock);
+        localRatio = ratio;
+    }
 
-    auto scaledBlockSize = roundToInt (samplesPerBlockExpected * ratio);
-    input->prepareToPlay (scaledBlockSize, sampleRate * ratio);
+    auto scaledBlockSize = roundToInt (samplesPerBlockExpected * localRatio);
+    input->prepareToPlay (scaledBlockSize, sampleRate * localRatio);
 
-    buffer.setSize (numChannels, scaledBlockSize + 32);
+    const ScopedLock sl (callbackLock);
 
-    filterStates.calloc (numChannels);
-    srcBuffers.calloc (numChannels);
+    expectedBlockSize = samplesPerBlockExpected;
     destBuffers.calloc (numChannels);
-    createLowPass (ratio);
+    lastRatio = localRatio;
+    createFilters();
+}
+
+void ResamplingAudioSource::createFilters()
+{
+    using namespace ResamplingHelpers;
 
+    // Everything that a change of ratio could need is made here, so that getNextAudioBlock()
+    // never has to allocate
+    const auto numHalvings = getNumHalvings (lastRatio);
+    polyphaseFilter = std::make_unique<PolyphaseFilter> (numChannels, quality, std::ldexp (lastRatio, -(int) numHalvings), expectedBlockSize);
+
+    decimators.clear();
+
+    for (size_t i = 0; i < maxNumHalvings; ++i)
+        decimators.push_back (std::make_unique<HalfBandDecimator> (numChannels, quality,
+                                                                  polyphaseFilter->getDecimatorHistorySize(),
+                                                                  polyphaseFilter->getDecimatorBufferSize()));
+
+    numDecimatorsInUse = numHalvings;
+    setFilterRatios (lastRatio);
     flushBuffers();
 }
 
+void ResamplingAudioSource::setFilterRatios (double newRatio)
+{
+    using namespace ResamplingHelpers;
+
+    const auto numNeeded = getNumHalvings (newRatio);
+
+    // Ratios beyond what the half-band filters cover aren't band-limited properly
+    jassert (newRatio <= std::ldexp (maxPolyphaseRatio, (int) maxNumHalvings));
+
+    for (; numDecimatorsInUse < numNeeded; ++numDecimatorsInUse)
+        polyphaseFilter->insertDecimator (*decimators[numDecimatorsInUse]);
+
+    // Each one taken out doubles what the polyphase filter has read ahead, so after a fall of
+    // several octaves the rest wait until that has been used up
+    while (numDecimatorsInUse > numNeeded && polyphaseFilter->canRemoveDecimator (*decimators[numDecimatorsInUse - 1]))
+        polyphaseFilter->removeDecimator (*decimators[--numDecimatorsInUse]);
+
+    polyphaseFilter->setRatio (jmin (maxPolyphaseRatio, std::ldexp (newRatio, -(int) numDecimatorsInUse)));
+}
+
 void ResamplingAudioSource::flushBuffers()
 {
     const ScopedLock sl (callbackLock);
 
-    buffer.clear();
-    bufferPos = 0;
-    sampsInBuffer = 0;
-    subSampleOffset = 0.0;
-    resetFilters();
+    if (polyphaseFilter != nullptr)
+        polyphaseFilter->reset();
+
+    for (auto& decimator : decimators)
+        decimator->reset();
 }
 
 void ResamplingAudioSource::releaseResources()
 {
     input->releaseResources();
-    buffer.setSize (numChannels, 0);
+
+    const ScopedLock sl (callbackLock);
+    polyphaseFilter.reset();
+    decimators.clear();
+    numDecimatorsInUse = 0;
+}
+
+void ResamplingAudioSource::readInput (size_t numDecimatorsToUse, AudioBuffer<float>& dest, int startSample, int numSamples)
+{
+    if (numDecimatorsToUse == 0)
+    {
+        AudioSourceChannelInfo readInfo (&dest, startSample, numSamples);
+        input->getNextAudioBlock (readInfo);
+        return;
+    }
+
+    decimators[numDecimatorsToUse - 1]->process (dest, startSample, numSamples, [this, numDecimatorsToUse] (AudioBuffer<float>& b, int s, int n)
+    {
+        readInput (numDecimatorsToUse - 1, b, s, n);
+    });
 }
 
 void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
     const ScopedLock sl (callbackLock);
 
+    if (polyphaseFilter == nullptr)
+    {
+        jassertfalse; // prepareToPlay() needs to be called first
+        info.clearActiveBufferRegion();
+        return;
+    }
+
     double localRatio;
 
     {
@@ -100,178 +710,296 @@ void ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& inf
         localRatio = ratio;
     }
 
-    if (! approximatelyEqual (lastRatio, localRatio))
+    // A fall of several octaves can take a few blocks to reach the filters
+    if (! approximatelyEqual (lastRatio, localRatio) || numDecimatorsInUse != ResamplingHelpers::getNumHalvings (localRatio))
     {
-        createLowPass (localRatio);
+        setFilterRatios (localRatio);
         lastRatio = localRatio;
     }
 
-    const int sampsNeeded = roundToInt (info.numSamples * localRatio) + 3;
+    const int channelsToProcess = jmin (numChannels, info.buffer->getNumChannels());
 
-    int bufferSize = buffer.getNumSamples();
+    for (int channel = 0; channel < channelsToProcess; ++channel)
+        destBuffers[channel] = info.buffer->getWritePointer (channel, info.startSample);
 
-    if (bufferSize < sampsNeeded + 8)
+    polyphaseFilter->process (destBuffers, channelsToProcess, info.numSamples, [this] (AudioBuffer<float>& b, int s, int n)
     {
-        bufferPos %= bufferSize;
-        bufferSize = sampsNeeded + 32;
-        buffer.setSize (buffer.getNumChannels(), bufferSize, true, true);
-    }
+        readInput (numDecimatorsInUse, b, s, n);
+    });
+}
 
-    bufferPos %= bufferSize;
+//==============================================================================
+#if JUCE_UNIT_TESTS
 
-    int endOfBufferPos = bufferPos + sampsInBuffer;
-    const int channelsToProcess = jmin (numChannels, info.buffer->getNumChannels());
+#if JUCE_ENABLE_ALLOCATION_HOOKS
+#define JUCE_FAIL_ON_ALLOCATION_IN_SCOPE const UnitTestAllocationChecker checker (*this)
+#else
+#define JUCE_FAIL_ON_ALLOCATION_IN_SCOPE
+#endif
 
-    while (sampsNeeded > sampsInBuffer)
+class ResamplingAudioSourceTests final : public UnitTest
+{
+public:
+    ResamplingAudioSourceTests()
+        : UnitTest ("ResamplingAudioSource", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
     {
-        endOfBufferPos %= bufferSize;
+        beginTest ("A ratio of one passes the input through");
+        {
+            AudioBuffer<float> input (2, 1000);
+            fillWithNoise (input);
 
-        int numToDo = jmin (sampsNeeded - sampsInBuffer,
-                            bufferSize - endOfBufferPos);
+            MemoryAudioSource source (input, false);
+            ResamplingAudioSource resampler (&source, false, 2);
+            resampler.prepareToPlay (256, 44100.0);
 
-        AudioSourceChannelInfo readInfo (&buffer, endOfBufferPos, numToDo);
-        input->getNextAudioBlock (readInfo);
+            AudioBuffer<float> output (2, 900);
+            pullInBlocks (resampler, output, 256);
 
-        if (localRatio > 1.0001)
+            for (int channel = 0; channel < 2; ++channel)
+                expect (std::equal (output.getReadPointer (channel), output.getReadPointer (channel) + 900, input.getReadPointer (channel)));
+        }
+
+        beginTest ("Sine waves are resampled accurately");
         {
-            // for down-sampling, pre-apply the filter..
+            const std::pair<ResamplingAudioSource::Quality, double> tolerances[] { { ResamplingAudioSource::Quality::low,    1.0e-2 },
+                                                                                   { ResamplingAudioSource::Quality::medium, 1.0e-3 },
+                                                                                   { ResamplingAudioSource::Quality::high,   1.0e-4 } };
 
-            for (int i = channelsToProcess; --i >= 0;)
-                applyFilter (buffer.getWritePointer (i, endOfBufferPos), numToDo, filterStates[i]);
+            for (const auto& [quality, tolerance] : tolerances)
+                for (auto ratio : { 44100.0 / 48000.0, 48000.0 / 44100.0, 0.25, 96000.0 / 44100.0, 192000.0 / 44100.0, 10.0 })
+                    expectLessThan (getSineError (quality, ratio, 0.02), tolerance, String (ratio));
         }
 
-        sampsInBuffer += numToDo;
-        endOfBufferPos += numToDo;
-    }
+        beginTest ("Tones above the output's Nyquist frequency are rejected");
+        {
+            const std::pair<ResamplingAudioSource::Quality, double> limits[] { { ResamplingAudioSource::Quality::low,    1.0e-2 },
+                                                                               { ResamplingAudioSource::Quality::medium, 3.0e-4 },
+                                                                               { ResamplingAudioSource::Quality::high,   1.0e-4 } };
+
+            for (const auto& [quality, limit] : limits)
+                for (auto ratio : { 48000.0 / 44100.0, 96000.0 / 44100.0, 192000.0 / 44100.0, 10.0 })
+                    for (auto cyclesPerOutputSample : { 0.52, 0.54 })
+                        expectLessThan (getRejectedLevel (quality, ratio, cyclesPerOutputSample / ratio), limit, String (ratio));
+        }
 
-    for (int channel = 0; channel < channelsToProcess; ++channel)
-    {
-        destBuffers[channel] = info.buffer->getWritePointer (channel, info.startSample);
-        srcBuffers[channel] = buffer.getReadPointer (channel);
-    }
+        beginTest ("The output doesn't depend on the block size");
+        {
+            for (auto ratio : { 0.7, 1.5, 5.3 })
+            {
+                AudioBuffer<float> input (3, 20000);
+                fillWithNoise (input);
+
+                AudioBuffer<float> whole (3, 3000), blocks (3, 3000);
+
+                for (auto* output : { &whole, &blocks })
+                {
+                    MemoryAudioSource source (input, false);
+                    ResamplingAudioSource resampler (&source, false, 3);
+                    resampler.setResamplingRatio (ratio);
+                    resampler.prepareToPlay (512, 44100.0);
+                    pullInBlocks (resampler, *output, output == &whole ? 3000 : 0);
+                }
+
+                for (int channel = 0; channel < 3; ++channel)
+                    for (int i = 0; i < 3000; ++i)
+                        expectWithinAbsoluteError (blocks.getSample (channel, i), whole.getSample (channel, i), 1.0e-4f);
+            }
+        }
 
-    int nextPos = (bufferPos + 1) % bufferSize;
+        beginTest ("The ratio can be changed while running without allocating or a gap in the output");
+        {
+            constexpr auto cyclesPerInputSample = 0.002;
+            constexpr int blockSize = 256, numBlocks = 60;
 
-    for (int m = info.numSamples; --m >= 0;)
-    {
-        jassert (sampsInBuffer > 0 && nextPos != endOfBufferPos);
+            SineSource source (cyclesPerInputSample);
+            ResamplingAudioSource resampler (&source, false, 1);
+            resampler.prepareToPlay (blockSize, 44100.0);
+
+            AudioBuffer<float> output (1, blockSize * numBlocks);
+            std::vector<double> ratios;
+            auto random = getRandom();
 
-        const float alpha = (float) subSampleOffset;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                // Often enough across 4, 8 and 16 to take half-band filters in and out, including
+                // falls of several octaves at once
+                ratios.push_back (random.nextInt (4) == 0 ? 0.5 : 0.5 + random.nextDouble() * 20.0);
+            }
 
-        for (int channel = 0; channel < channelsToProcess; ++channel)
-            *destBuffers[channel]++ = srcBuffers[channel][bufferPos]
-                                        + alpha * (srcBuffers[channel][nextPos] - srcBuffers[channel][bufferPos]);
+            {
+                JUCE_FAIL_ON_ALLOCATION_IN_SCOPE;
 
-        subSampleOffset += localRatio;
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    resampler.setResamplingRatio (ratios[(size_t) block]);
+                    resampler.getNextAudioBlock ({ &output, block * blockSize, blockSize });
+                }
+            }
 
-        while (subSampleOffset >= 1.0)
-        {
-            if (++bufferPos >= bufferSize)
-                bufferPos = 0;
+            // Each output sample is the sine at its position in the input, which moves on by the
+            // ratio of its block. The start is skipped, as the filters see the silence before it.
+            auto inputPosition = 0.0, biggestError = 0.0;
 
-            --sampsInBuffer;
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    if (inputPosition > 1000.0)
+                    {
+                        const auto expected = std::sin (MathConstants<double>::twoPi * cyclesPerInputSample * inputPosition);
+                        biggestError = jmax (biggestError, std::abs (output.getSample (0, block * blockSize + i) - expected));
+                    }
+
+                    inputPosition += ratios[(size_t) block];
+                }
+            }
 
-            nextPos = (bufferPos + 1) % bufferSize;
-            subSampleOffset -= 1.0;
+            expectLessThan (biggestError, 1.0e-3);
         }
     }
 
-    if (localRatio < 0.9999)
+    // An endless sine wave, which starts at the first sample that's read. This is shared with
+    // the benchmark below.
+    struct SineSource final : public AudioSource
     {
-        // for up-sampling, apply the filter after transposing..
-        for (int i = channelsToProcess; --i >= 0;)
-            applyFilter (info.buffer->getWritePointer (i, info.startSample), info.numSamples, filterStates[i]);
+        explicit SineSource (double cyclesPerSampleToUse) : cyclesPerSample (cyclesPerSampleToUse) {}
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int i = 0; i < info.numSamples; ++i)
+            {
+                const auto value = (float) std::sin (MathConstants<double>::twoPi * cyclesPerSample * (double) position++);
+
+                for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+                    info.buffer->setSample (channel, info.startSample + i, value);
+            }
+        }
+
+        const double cyclesPerSample;
+        int64 position = 0;
+    };
+
+private:
+    void fillWithNoise (AudioBuffer<float>& buffer)
+    {
+        auto random = getRandom();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
     }
-    else if (localRatio <= 1.0001 && info.numSamples > 0)
+
+    // Pulls blocks of a fixed size, or of random sizes when blockSize is 0
+    void pullInBlocks (AudioSource& source, AudioBuffer<float>& output, int blockSize)
     {
-        // if the filter's not currently being applied, keep it stoked with the last couple of samples to avoid discontinuities
-        for (int i = channelsToProcess; --i >= 0;)
+        auto random = getRandom();
+
+        for (int start = 0; start < output.getNumSamples();)
         {
-            const float* const endOfBuffer = info.buffer->getReadPointer (i, info.startSample + info.numSamples - 1);
-            FilterState& fs = filterStates[i];
+            const auto num = jmin (output.getNumSamples() - start, blockSize > 0 ? blockSize : random.nextInt (300) + 1);
+            source.getNextAudioBlock ({ &output, start, num });
+            start += num;
+        }
+    }
 
-            if (info.numSamples > 1)
-            {
-                fs.y2 = fs.x2 = *(endOfBuffer - 1);
-            }
-            else
-            {
-                fs.y2 = fs.y1;
-                fs.x2 = fs.x1;
-            }
+    double getSineError (ResamplingAudioSource::Quality quality, double ratio, double cyclesPerOutputSample)
+    {
+        SineSource source (cyclesPerOutputSample / ratio);
+        ResamplingAudioSource resampler (&source, false, 1);
+        resampler.setQuality (quality);
+        resampler.setResamplingRatio (ratio);
+        resampler.prepareToPlay (512, 44100.0);
+
+        AudioBuffer<float> output (1, 4000);
+        pullInBlocks (resampler, output, 512);
 
-            fs.y1 = fs.x1 = *endOfBuffer;
+        // The start is skipped, as the filter sees the silence before the sine began
+        auto biggestError = 0.0;
+
+        for (int i = 500; i < output.getNumSamples(); ++i)
+        {
+            const auto expected = std::sin (MathConstants<double>::twoPi * cyclesPerOutputSample * i);
+            biggestError = jmax (biggestError, std::abs (output.getSample (0, i) - expected));
         }
+
+        return biggestError;
     }
 
-    jassert (sampsInBuffer >= 0);
-}
+    double getRejectedLevel (ResamplingAudioSource::Quality quality, double ratio, double cyclesPerInputSample)
+    {
+        SineSource source (cyclesPerInputSample);
+        ResamplingAudioSource resampler (&source, false, 1);
+        resampler.setQuality (quality);
+        resampler.setResamplingRatio (ratio);
+        resampler.prepareToPlay (512, 44100.0);
 
-void ResamplingAudioSource::createLowPass (const double frequencyRatio)
-{
-    const double proportionalRate = (frequencyRatio > 1.0) ? 0.5 / frequencyRatio
-                                                           : 0.5 * frequencyRatio;
-
-    const double n = 1.0 / std::tan (MathConstants<double>::pi * jmax (0.001, proportionalRate));
-    const double nSquared = n * n;
-    const double c1 = 1.0 / (1.0 + MathConstants<double>::sqrt2 * n + nSquared);
-
-    setFilterCoefficients (c1,
-                           c1 * 2.0f,
-                           c1,
-                           1.0,
-                           c1 * 2.0 * (1.0 - nSquared),
-                           c1 * (1.0 - MathConstants<double>::sqrt2 * n + nSquared));
-}
+        AudioBuffer<float> output (1, 4000);
+        pullInBlocks (resampler, output, 512);
 
-void ResamplingAudioSource::setFilterCoefficients (double c1, double c2, double c3, double c4, double c5, double c6)
-{
-    const double a = 1.0 / c4;
-
-    c1 *= a;
-    c2 *= a;
-    c3 *= a;
-    c5 *= a;
-    c6 *= a;
-
-    coefficients[0] = c1;
-    coefficients[1] = c2;
-    coefficients[2] = c3;
-    coefficients[3] = c4;
-    coefficients[4] = c5;
-    coefficients[5] = c6;
-}
+        return output.getMagnitude (0, 500, output.getNumSamples() - 500);
+    }
+};
 
-void ResamplingAudioSource::resetFilters()
-{
-    if (filterStates != nullptr)
-        filterStates.clear ((size_t) numChannels);
-}
+static ResamplingAudioSourceTests resamplingAudioSourceTests;
 
-void ResamplingAudioSource::applyFilter (float* samples, int num, FilterState& fs)
+//==============================================================================
+class ResamplingAudioSourceBenchmark final : public UnitTestBenchmark
 {
-    while (--num >= 0)
+public:
+    ResamplingAudioSourceBenchmark()
+        : UnitTestBenchmark ("ResamplingAudioSource Benchmark")
+    {}
+
+    void runTest() override
     {
-        const double in = *samples;
+        beginTest ("Cost per frame");
 
-        double out = coefficients[0] * in
-                     + coefficients[1] * fs.x1
-                     + coefficients[2] * fs.x2
-                     - coefficients[4] * fs.y1
-                     - coefficients[5] * fs.y2;
+        for (auto quality : { ResamplingAudioSource::Quality::low, ResamplingAudioSource::Quality::medium, ResamplingAudioSource::Quality::high })
+        {
+            String message;
 
-       #if JUCE_INTEL
-        if (! (out < -1.0e-8 || out > 1.0e-8))
-            out = 0;
-       #endif
+            for (auto ratio : { 44100.0 / 48000.0, 48000.0 / 44100.0, 192000.0 / 44100.0 })
+                message << String (ratio, 3) << ": " << String (measureNanosecondsPerFrame (quality, ratio), 1) << " ns  ";
+
+            logMessage ("Quality " + String ((int) quality) + ", stereo, ns per output frame at each ratio: " + message);
+        }
+    }
+
+private:
+    double measureNanosecondsPerFrame (ResamplingAudioSource::Quality quality, double ratio)
+    {
+        constexpr int blockSize = 512, numBlocks = 200, numRounds = 5;
+
+        ResamplingAudioSourceTests::SineSource source (0.01);
+        ResamplingAudioSource resampler (&source, false, 2);
+        resampler.setQuality (quality);
+        resampler.setResamplingRatio (ratio);
+        resampler.prepareToPlay (blockSize, 44100.0);
+
+        AudioBuffer<float> output (2, blockSize);
 
-        fs.x2 = fs.x1;
-        fs.x1 = in;
-        fs.y2 = fs.y1;
-        fs.y1 = out;
+        const auto seconds = measureFastestSeconds (numRounds, [&]
+        {
+            for (int i = 0; i < numBlocks; ++i)
+                resampler.getNextAudioBlock ({ &output, 0, blockSize });
+        });
 
-        *samples++ = (float) out;
+        return seconds * 1.0e9 / (double) (numBlocks * blockSize);
     }
-}
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static ResamplingAudioSourceBenchmark resamplingAudioSourceBenchmark;
+#endif
+
+#undef JUCE_FAIL_ON_ALLOCATION_IN_SCOPE
+
+#endif
 
 } // namespace juce
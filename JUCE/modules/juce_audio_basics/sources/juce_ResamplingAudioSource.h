@@ -39,6 +39,13 @@ namespace juce
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
+    The input is filtered with a windowed-sinc kernel, evaluated from a table of
+    precomputed polyphase coefficients, so the output stays free from aliasing and
+    imaging. Large downsampling ratios first halve the rate with a series of
+    half-band filters, which keeps the kernel short. The length of the kernels can
+    be traded against CPU with setQuality(). The kernels and filters that any ratio
+    needs are made in prepareToPlay(), so the ratio can be changed while playing.
+
     @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator
 
     @tags{Audio}
@@ -65,6 +72,13 @@ public:
 
         (This value can be changed at any time, even while the source is running).
 
+        Everything that a change of ratio needs is set up by prepareToPlay(), so changing it
+        while running doesn't allocate, and the filters carry on from the input they have
+        already read rather than starting again. A jump of more than three octaves at once
+        can leave a small error in the next few samples while the filters' history fills up,
+        and after a large fall the extra half-band filters are taken out over the next few
+        blocks. Ratios above 1024 are treated as 1024.
+
         @param samplesInPerOutputSample     if set to 1.0, the input is passed through; higher
                                             values will speed it up; lower values will slow it
                                             down. The ratio must be greater than 0
@@ -77,6 +91,25 @@ public:
     */
     double getResamplingRatio() const noexcept                  { return ratio; }
 
+    //==============================================================================
+    /** The lengths of filter that the resampler can use. */
+    enum class Quality
+    {
+        low,        /**< A 16-tap kernel, flat up to about 60% of the lower Nyquist frequency. */
+        medium,     /**< A 48-tap kernel, flat up to about 80% of the lower Nyquist frequency. */
+        high        /**< A 128-tap kernel, flat up to about 90% of the lower Nyquist frequency. */
+    };
+
+    /** Chooses how long the resampling filters are. The default is Quality::medium.
+
+        Longer filters keep more of the top octave and reject aliases further, at the
+        cost of more CPU. Changing the quality of a prepared source clears its buffers.
+    */
+    void setQuality (Quality newQuality);
+
+    /** Returns the quality that was set by setQuality(). */
+    Quality getQuality() const noexcept                         { return quality; }
+
     /** Clears any buffers and filters that the resampler is using. */
     void flushBuffers();
 
@@ -87,30 +120,25 @@ public:
 
 private:
     //==============================================================================
+    class PolyphaseFilter;
+    class HalfBandDecimator;
+
     OptionalScopedPointer<AudioSource> input;
     double ratio = 1.0, lastRatio = 1.0;
-    AudioBuffer<float> buffer;
-    int bufferPos = 0, sampsInBuffer = 0;
-    double subSampleOffset = 0.0;
-    double coefficients[6];
+    Quality quality = Quality::medium;
     SpinLock ratioLock;
     CriticalSection callbackLock;
     const int numChannels;
+    int expectedBlockSize = 0;
     HeapBlock<float*> destBuffers;
-    HeapBlock<const float*> srcBuffers;
-
-    void setFilterCoefficients (double c1, double c2, double c3, double c4, double c5, double c6);
-    void createLowPass (double proportionalRate);
-
-    struct FilterState
-    {
-        double x1, x2, y1, y2;
-    };
 
-    HeapBlock<FilterState> filterStates;
-    void resetFilters();
+    std::unique_ptr<PolyphaseFilter> polyphaseFilter;
+    std::vector<std::unique_ptr<HalfBandDecimator>> decimators;
+    size_t numDecimatorsInUse = 0;
 
-    void applyFilter (float* samples, int num, FilterState& fs);
+    void createFilters();
+    void setFilterRatios (double newRatio);
+    void readInput (size_t numDecimatorsToUse, AudioBuffer<float>& dest, int startSample, int numSamples);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResamplingAudioSource)
 };
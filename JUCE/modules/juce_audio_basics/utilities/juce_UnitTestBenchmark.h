@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_UNIT_TESTS
+
+//==============================================================================
+/**
+    A UnitTest that only takes timing measurements.
+
+    A benchmark goes in the Benchmarks category under a name of its own, next to the
+    tests of the class it measures. The class is always compiled with the tests, but
+    an instance should only be registered when JUCE_UNIT_TEST_BENCHMARKS is enabled,
+    so that ordinary test runs don't pay for the measurements:
+
+    @code
+    #if JUCE_UNIT_TEST_BENCHMARKS
+    static MyClassBenchmark myClassBenchmark;
+    #endif
+    @endcode
+
+    @tags{Audio}
+*/
+class UnitTestBenchmark  : public UnitTest
+{
+public:
+    /** Creates a benchmark, which must have a different name to the tests it goes with. */
+    explicit UnitTestBenchmark (const String& benchmarkName)
+        : UnitTest (benchmarkName, UnitTestCategories::benchmarks)
+    {}
+
+protected:
+    /** Calls a function a number of times and returns the shortest time it took, in seconds.
+
+        Taking the best of several rounds keeps other activity on the machine out of the figure.
+    */
+    template <typename Function>
+    static double measureFastestSeconds (int numRounds, Function&& function)
+    {
+        auto fastest = std::numeric_limits<double>::max();
+
+        for (int round = 0; round < numRounds; ++round)
+        {
+            const auto startTicks = Time::getHighResolutionTicks();
+            function();
+            fastest = jmin (fastest, Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks));
+        }
+
+        return fastest;
+    }
+};
+
+#endif
+
+} // namespace juce
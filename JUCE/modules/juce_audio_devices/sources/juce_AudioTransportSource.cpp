@@ -84,8 +84,12 @@ void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
         newPositionableSource->setNextReadPosition (0);
 
         if (sourceSampleRateToCorrectFor > 0)
+        {
             newMasterSource = newResamplerSource
                 = new ResamplingAudioSource (newPositionableSource, false, maxNumChannels);
+
+            newResamplerSource->setQuality (resamplingQuality);
+        }
         else
             newMasterSource = newPositionableSource;
 
@@ -116,6 +120,15 @@ void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
         oldMasterSource->releaseResources();
 }
 
+void AudioTransportSource::setResamplingQuality (ResamplingAudioSource::Quality newQuality)
+{
+    const ScopedLock sl (callbackLock);
+    resamplingQuality = newQuality;
+
+    if (resamplerSource != nullptr)
+        resamplerSource->setQuality (newQuality);
+}
+
 void AudioTransportSource::start()
 {
     if ((! playing) && masterSource != nullptr)
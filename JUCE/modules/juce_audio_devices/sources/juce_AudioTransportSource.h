@@ -146,6 +146,19 @@ public:
     */
     float getGain() const noexcept      { return gain; }
 
+    //==============================================================================
+    /** Chooses the quality of the resampler that corrects for the source's sample rate.
+
+        This only has an effect when a sourceSampleRateToCorrectFor was passed to setSource().
+        The default is ResamplingAudioSource::Quality::medium.
+
+        @see ResamplingAudioSource::setQuality
+    */
+    void setResamplingQuality (ResamplingAudioSource::Quality newQuality);
+
+    /** Returns the quality that was set by setResamplingQuality(). */
+    ResamplingAudioSource::Quality getResamplingQuality() const noexcept    { return resamplingQuality; }
+
     //==============================================================================
     /** Implementation of the AudioSource method. */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -182,6 +195,7 @@ private:
     std::atomic<bool> playing { false }, stopped { true };
     double sampleRate = 44100.0, sourceSampleRate = 0;
     int blockSize = 128, readAheadBufferSize = 0;
+    ResamplingAudioSource::Quality resamplingQuality = ResamplingAudioSource::Quality::medium;
     bool isPrepared = false;
 
     void releaseMasterResources();
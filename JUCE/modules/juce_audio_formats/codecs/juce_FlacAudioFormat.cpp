@@ -222,9 +222,9 @@ public:
             if (lengthInSamples == 0 && sampleRate > 0)
             {
                 // the length hasn't been stored in the metadata, so we'll need to
-                // work it out the length the hard way, by scanning the whole file..
+                // work it out from the sample numbers in the last frames' headers..
                 scanningForLength = true;
-                FLAC__stream_decoder_process_until_end_of_stream (decoder);
+                findLastFrames();
                 scanningForLength = false;
                 auto tempLength = lengthInSamples;
 
@@ -235,6 +235,40 @@ public:
         }
     }
 
+    /*  Decodes the frames in a window at the end of the stream, starting with one that's
+        twice the maximum frame size so that it must hold at least one whole frame. The
+        decoder finds the first frame in the window by its sync code and drops any frame
+        whose CRC doesn't match, so the length that's found is exact. The window only grows
+        if there's no frame in it, which means the whole stream is only decoded when it's
+        very short, or when the stream's total length isn't known.
+    */
+    void findLastFrames()
+    {
+        FlacNamespace::FLAC__uint64 firstFramePos = 0;
+        const auto streamEnd = input->getTotalLength();
+
+        if (streamEnd < 0 || ! FLAC__stream_decoder_get_decode_position (decoder, &firstFramePos))
+        {
+            FLAC__stream_decoder_process_until_end_of_stream (decoder);
+            return;
+        }
+
+        auto windowSize = maxFrameSize > 0 ? 2 * (int64) maxFrameSize : (int64) 65536;
+
+        for (;;)
+        {
+            const auto windowStart = jmax ((int64) firstFramePos, streamEnd - windowSize);
+            input->setPosition (windowStart);
+            FLAC__stream_decoder_flush (decoder);
+            FLAC__stream_decoder_process_until_end_of_stream (decoder);
+
+            if (lengthInSamples > 0 || windowStart == (int64) firstFramePos)
+                return;
+
+            windowSize *= 4;
+        }
+    }
+
     ~FlacReader() override
     {
         FlacNamespace::FLAC__stream_decoder_delete (decoder);
@@ -246,6 +280,7 @@ public:
         bitsPerSample = info.bits_per_sample;
         lengthInSamples = (unsigned int) info.total_samples;
         numChannels = info.channels;
+        maxFrameSize = info.max_framesize;
 
         reservoir.setSize ((int) numChannels, 2 * (int) info.max_blocksize, false, false, true);
     }
@@ -310,11 +345,11 @@ public:
         return true;
     }
 
-    void useSamples (const FlacNamespace::FLAC__int32* const buffer[], int numSamples)
+    void useSamples (const FlacNamespace::FLAC__int32* const buffer[], int numSamples, int64 firstSampleNumber)
     {
         if (scanningForLength)
         {
-            lengthInSamples += numSamples;
+            lengthInSamples = jmax (lengthInSamples, firstSampleNumber + numSamples);
         }
         else
         {
@@ -353,7 +388,7 @@ public:
 
     static FlacNamespace::FLAC__StreamDecoderSeekStatus seekCallback_ (const FlacNamespace::FLAC__StreamDecoder*, FlacNamespace::FLAC__uint64 absolute_byte_offset, void* client_data)
     {
-        static_cast<const FlacReader*> (client_data)->input->setPosition ((int) absolute_byte_offset);
+        static_cast<const FlacReader*> (client_data)->input->setPosition ((int64) absolute_byte_offset);
         return FlacNamespace::FLAC__STREAM_DECODER_SEEK_STATUS_OK;
     }
 
@@ -379,7 +414,8 @@ public:
                                                                          const FlacNamespace::FLAC__int32* const buffer[],
                                                                          void* client_data)
     {
-        static_cast<FlacReader*> (client_data)->useSamples (buffer, (int) frame->header.blocksize);
+        static_cast<FlacReader*> (client_data)->useSamples (buffer, (int) frame->header.blocksize,
+                                                            (int64) frame->header.number.sample_number);
         return FlacNamespace::FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
     }
 
@@ -398,6 +434,7 @@ private:
     FlacNamespace::FLAC__StreamDecoder* decoder;
     AudioBuffer<float> reservoir;
     Range<int64> bufferedRange;
+    uint32 maxFrameSize = 0;
     bool ok = false, scanningForLength = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacReader)
@@ -623,6 +660,101 @@ StringArray FlacAudioFormat::getQualityOptions()
     return { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)" };
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct FlacAudioFormatTests final : public UnitTest
+{
+    FlacAudioFormatTests()
+        : UnitTest ("FLAC audio format", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Lengths that aren't in the metadata are found without reading the whole stream");
+        {
+            for (auto numSamples : { 1000, 100000, 1000003 })
+            {
+                const auto original = createStream (numSamples);
+
+                for (auto clearMaxFrameSize : { false, true })
+                {
+                    auto data = original;
+                    auto* bytes = static_cast<uint8*> (data.getData());
+
+                    // zero the STREAMINFO block's total_samples and, optionally, max_framesize
+                    bytes[21] &= 0xf0;
+                    zeromem (bytes + 22, 4);
+
+                    if (clearMaxFrameSize)
+                        zeromem (bytes + 15, 3);
+
+                    auto* in = new CountingInputStream (data);
+                    FlacAudioFormat format;
+                    std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (in, true));
+
+                    expectEquals (reader->lengthInSamples, (int64) numSamples);
+
+                    if (numSamples > 100000)
+                        expectLessThan (in->numBytesRead, (int64) data.getSize() / 10);
+
+                    std::unique_ptr<AudioFormatReader> originalReader (format.createReaderFor (new MemoryInputStream (original, false), true));
+                    AudioBuffer<float> expected (1, 5000), buffer (1, 5000);
+
+                    for (auto start : { (int64) 0, (int64) numSamples - 3000 })
+                    {
+                        originalReader->read (&expected, 0, 5000, start, true, false);
+                        reader->read (&buffer, 0, 5000, start, true, false);
+                        expect (buffer == expected);
+                    }
+                }
+            }
+        }
+    }
+
+    struct CountingInputStream final : public MemoryInputStream
+    {
+        explicit CountingInputStream (const MemoryBlock& block)  : MemoryInputStream (block, false) {}
+
+        int read (void* dest, int numBytes) override
+        {
+            const auto numRead = MemoryInputStream::read (dest, numBytes);
+            numBytesRead += numRead;
+            return numRead;
+        }
+
+        int64 numBytesRead = 0;
+    };
+
+    static MemoryBlock createStream (int numSamples)
+    {
+        AudioBuffer<float> buffer (2, numSamples);
+        Random random (numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer.setSample (0, i, 0.5f * std::sin ((float) i * 0.01f) + 0.01f * random.nextFloat());
+            buffer.setSample (1, i, 0.3f * random.nextFloat());
+        }
+
+        MemoryBlock data;
+
+        {
+            FlacAudioFormat format;
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false),
+                                                                               44100.0, 2, 16, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        return data;
+    }
+};
+
+static FlacAudioFormatTests flacAudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
@@ -48,6 +48,8 @@ namespace juce
 */
 #if JUCE_USE_MP3AUDIOFORMAT
 
+struct MP3AudioFormatTests;
+
 namespace MP3Decoder
 {
 
@@ -418,6 +420,19 @@ struct VBRTagData
         else
             sampleRate = sampleRates[type][sampleRateIndex];
 
+        headersize = ((type + 1) * 72000 * bitrate) / sampleRate;
+
+        // The Fraunhofer encoder writes a VBRI header, which always starts 32 bytes after the frame header
+        if (isVbriTag (data + 4 + 32))
+        {
+            const auto* vbri = data + 4 + 32;
+            bytes  = ByteOrder::bigEndianInt (vbri + 10);
+            frames = ByteOrder::bigEndianInt (vbri + 14);
+            flags = 1 | 2;
+            vbrScale = -1;
+            return true;
+        }
+
         data += type != 0 ? (mode != 3 ? (32 + 4) : (17 + 4))
                           : (mode != 3 ? (17 + 4) : (9 + 4));
 
@@ -453,7 +468,6 @@ struct VBRTagData
         if (flags & 8)
             vbrScale = (int) ByteOrder::bigEndianInt (data);
 
-        headersize = ((type + 1) * 72000 * bitrate) / sampleRate;
         return true;
     }
 
@@ -467,6 +481,11 @@ private:
         return (d[0] == 'X' && d[1] == 'i' && d[2] == 'n' && d[3] == 'g')
             || (d[0] == 'I' && d[1] == 'n' && d[2] == 'f' && d[3] == 'o');
     }
+
+    static bool isVbriTag (const uint8* d) noexcept
+    {
+        return d[0] == 'V' && d[1] == 'B' && d[2] == 'R' && d[3] == 'I';
+    }
 };
 
 //==============================================================================
@@ -562,6 +581,126 @@ struct MP3Frame
     const AllocationTable* allocationTable;
 };
 
+//==============================================================================
+/*  Four floats that are processed together. Each lane goes through exactly the same
+    multiplies and additions as the scalar code would, without fusing any of them, so
+    the decoded output doesn't depend on which implementation gets used.
+*/
+struct Float4
+{
+    Float4() = default;
+    Float4 (float v) noexcept   { *this = fill (v); }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    Float4 (__m128 v) noexcept  : value (v) {}
+
+    static forcedinline Float4 load (const float* src) noexcept             { return _mm_loadu_ps (src); }
+    static forcedinline Float4 fill (float v) noexcept                      { return _mm_set1_ps (v); }
+    forcedinline void store (float* dest) const noexcept                    { _mm_storeu_ps (dest, value); }
+    forcedinline Float4 reversed() const noexcept                           { return _mm_shuffle_ps (value, value, _MM_SHUFFLE (0, 1, 2, 3)); }
+
+    friend forcedinline Float4 operator+ (Float4 a, Float4 b) noexcept      { return _mm_add_ps (a.value, b.value); }
+    friend forcedinline Float4 operator- (Float4 a, Float4 b) noexcept      { return _mm_sub_ps (a.value, b.value); }
+    friend forcedinline Float4 operator* (Float4 a, Float4 b) noexcept      { return _mm_mul_ps (a.value, b.value); }
+    friend forcedinline Float4 operator- (Float4 a) noexcept                { return _mm_xor_ps (a.value, _mm_set1_ps (-0.0f)); }
+
+    static forcedinline void transpose (Float4& a, Float4& b, Float4& c, Float4& d) noexcept
+    {
+        _MM_TRANSPOSE4_PS (a.value, b.value, c.value, d.value);
+    }
+
+    __m128 value;
+   #elif JUCE_USE_ARM_NEON
+    Float4 (float32x4_t v) noexcept  : value (v) {}
+
+    static forcedinline Float4 load (const float* src) noexcept             { return vld1q_f32 (src); }
+    static forcedinline Float4 fill (float v) noexcept                      { return vdupq_n_f32 (v); }
+    forcedinline void store (float* dest) const noexcept                    { vst1q_f32 (dest, value); }
+    forcedinline Float4 reversed() const noexcept                           { auto r = vrev64q_f32 (value); return vcombine_f32 (vget_high_f32 (r), vget_low_f32 (r)); }
+
+    friend forcedinline Float4 operator+ (Float4 a, Float4 b) noexcept      { return vaddq_f32 (a.value, b.value); }
+    friend forcedinline Float4 operator- (Float4 a, Float4 b) noexcept      { return vsubq_f32 (a.value, b.value); }
+    friend forcedinline Float4 operator* (Float4 a, Float4 b) noexcept      { return vmulq_f32 (a.value, b.value); }
+    friend forcedinline Float4 operator- (Float4 a) noexcept                { return vnegq_f32 (a.value); }
+
+    static forcedinline void transpose (Float4& a, Float4& b, Float4& c, Float4& d) noexcept
+    {
+        const auto ab = vtrnq_f32 (a.value, b.value);
+        const auto cd = vtrnq_f32 (c.value, d.value);
+        a = vcombine_f32 (vget_low_f32  (ab.val[0]), vget_low_f32  (cd.val[0]));
+        b = vcombine_f32 (vget_low_f32  (ab.val[1]), vget_low_f32  (cd.val[1]));
+        c = vcombine_f32 (vget_high_f32 (ab.val[0]), vget_high_f32 (cd.val[0]));
+        d = vcombine_f32 (vget_high_f32 (ab.val[1]), vget_high_f32 (cd.val[1]));
+    }
+
+    float32x4_t value;
+   #else
+    static Float4 load (const float* src) noexcept                          { Float4 r; for (int i = 0; i < 4; ++i) r.value[i] = src[i]; return r; }
+    static Float4 fill (float v) noexcept                                   { Float4 r; for (auto& x : r.value) x = v; return r; }
+    void store (float* dest) const noexcept                                 { for (int i = 0; i < 4; ++i) dest[i] = value[i]; }
+    Float4 reversed() const noexcept                                        { Float4 r; for (int i = 0; i < 4; ++i) r.value[i] = value[3 - i]; return r; }
+
+    friend Float4 operator+ (Float4 a, Float4 b) noexcept                   { for (int i = 0; i < 4; ++i) a.value[i] += b.value[i]; return a; }
+    friend Float4 operator- (Float4 a, Float4 b) noexcept                   { for (int i = 0; i < 4; ++i) a.value[i] -= b.value[i]; return a; }
+    friend Float4 operator* (Float4 a, Float4 b) noexcept                   { for (int i = 0; i < 4; ++i) a.value[i] *= b.value[i]; return a; }
+    friend Float4 operator- (Float4 a) noexcept                             { for (auto& x : a.value) x = -x; return a; }
+
+    static void transpose (Float4& a, Float4& b, Float4& c, Float4& d) noexcept
+    {
+        Float4* rows[] = { &a, &b, &c, &d };
+
+        for (int i = 0; i < 4; ++i)
+            for (int j = i + 1; j < 4; ++j)
+                std::swap (rows[i]->value[j], rows[j]->value[i]);
+    }
+
+    float value[4];
+   #endif
+
+    Float4& operator+= (Float4 other) noexcept   { return *this = *this + other; }
+    Float4& operator-= (Float4 other) noexcept   { return *this = *this - other; }
+    Float4& operator*= (Float4 other) noexcept   { return *this = *this * other; }
+};
+
+//==============================================================================
+/*  A first-level lookup table for one of the layer 3 Huffman trees. It's indexed by the
+    next 8 bits of the stream, and gives either a complete code word or the node of the
+    tree at which to carry on one bit at a time.
+*/
+struct HuffmanLookup
+{
+    struct Entry
+    {
+        int16 value;      // the decoded value, or the index of the tree node to continue from
+        uint8 numBits;
+        bool isLeaf;
+    };
+
+    enum { numLookupBits = 8 };
+
+    void build (const int16* tree) noexcept
+    {
+        for (int prefix = 0; prefix < (1 << numLookupBits); ++prefix)
+        {
+            auto& entry = entries[prefix];
+            int node = 0;
+            entry.numBits = 0;
+
+            while (tree[node] < 0 && entry.numBits < numLookupBits)
+            {
+                const auto bit = (prefix >> (numLookupBits - 1 - entry.numBits)) & 1;
+                node = bit != 0 ? node + 1 - tree[node] : node + 1;
+                ++entry.numBits;
+            }
+
+            entry.isLeaf = tree[node] >= 0;
+            entry.value = (int16) (entry.isLeaf ? tree[node] : node);
+        }
+    }
+
+    Entry entries[1 << numLookupBits];
+};
+
 //==============================================================================
 struct Constants
 {
@@ -571,6 +710,7 @@ struct Constants
         initDecodeTables();
         initLayer2Tables();
         initLayer3Tables();
+        initVectorTables();
     }
 
     const uint8* getGroupTable (const int16 d1, const uint32 index) const noexcept
@@ -603,8 +743,13 @@ struct Constants
     uint32 iLength2[256];
     float decodeWin[512 + 32];
     float* cosTables[5];
+    float synthesisWindow[32][16];      // decodeWin[x + 32 * row] at [x][row], so that 4 rows can be windowed at once
+    float hybridWindows[4][36 * 4];     // win and win1 interleaved for 4 neighbouring subbands
+    const HuffmanLookup* huffmanLookups[32];
+    HuffmanLookup count1Lookups[2];
 
 private:
+    HuffmanLookup huffmanLookupTables[16];
     int mapbuf0[9][152];
     int mapbuf1[9][156];
     int mapbuf2[9][44];
@@ -648,6 +793,43 @@ private:
         }
     }
 
+    void initVectorTables()
+    {
+        for (int x = 0; x < 32; ++x)
+            for (int row = 0; row < 16; ++row)
+                synthesisWindow[x][row] = decodeWin[x + 32 * row];
+
+        for (int bt = 0; bt < 4; ++bt)
+            for (int i = 0; i < 36; ++i)
+                for (int lane = 0; lane < 4; ++lane)
+                    hybridWindows[bt][4 * i + lane] = (lane & 1) == 0 ? win[bt][i] : win1[bt][i];
+
+        for (int i = 0; i < 2; ++i)
+            count1Lookups[i].build (huffmanTables2[i].table);
+
+        int numTablesBuilt = 0;
+
+        for (int i = 0; i < 32; ++i)
+        {
+            int previous = 0;
+
+            while (previous < i && huffmanTables1[previous].table != huffmanTables1[i].table)
+                ++previous;
+
+            if (previous < i)
+            {
+                huffmanLookups[i] = huffmanLookups[previous];
+            }
+            else
+            {
+                jassert (numTablesBuilt < numElementsInArray (huffmanLookupTables));
+                auto& lookup = huffmanLookupTables[numTablesBuilt++];
+                lookup.build (huffmanTables1[i].table);
+                huffmanLookups[i] = &lookup;
+            }
+        }
+    }
+
     void initLayer2Tables()
     {
         static const uint8 base[3][9] =
@@ -897,18 +1079,20 @@ struct Layer3SideInfo
             else
                 sb = (int) maxb - 1;
 
-            for (; sb != 0; --sb, xr1 += 10)
+            const auto cs0 = Float4::load (constants.antiAliasingCs), cs1 = Float4::load (constants.antiAliasingCs + 4);
+            const auto ca0 = Float4::load (constants.antiAliasingCa), ca1 = Float4::load (constants.antiAliasingCa + 4);
+
+            // The 8 butterflies between each pair of subbands pair the top of the lower
+            // subband, read backwards, with the bottom of the upper one
+            for (; sb != 0; --sb, xr1 += 18)
             {
-                auto* cs = constants.antiAliasingCs;
-                auto* ca = constants.antiAliasingCa;
-                auto* xr2 = xr1;
+                const auto bu0 = Float4::load (xr1 - 4).reversed(), bu1 = Float4::load (xr1 - 8).reversed();
+                const auto bd0 = Float4::load (xr1),                bd1 = Float4::load (xr1 + 4);
 
-                for (int ss = 7; ss >= 0; --ss)
-                {
-                    const float bu = *--xr2, bd = *xr1;
-                    *xr2   = (bu * *cs)   - (bd * *ca);
-                    *xr1++ = (bd * *cs++) + (bu * *ca++);
-                }
+                ((bu0 * cs0) - (bd0 * ca0)).reversed().store (xr1 - 4);
+                ((bu1 * cs1) - (bd1 * ca1)).reversed().store (xr1 - 8);
+                ((bd0 * cs0) + (bu0 * ca0)).store (xr1);
+                ((bd1 * cs1) + (bu1 * ca1)).store (xr1 + 4);
             }
         }
 
@@ -1089,24 +1273,43 @@ namespace DCT
     static constexpr float cos36[] = { 0.501909912f, 0.517638087f, 0.551688969f, 0.610387266f, 0.707106769f, 0.871723413f, 1.18310082f, 1.93185163f, 5.73685646f };
     static constexpr float cos12[] = { 0.517638087f, 0.707106769f, 1.93185163f };
 
-    inline void dct36_0 (int v, float* ts, float* out1, float* out2, const float* wintab, float sum0, float sum1) noexcept
+    // The overlap buffers and the hybrid output are both laid out time-major, so the values for
+    // neighbouring subbands sit next to each other. These let the same dct36 code work on a single
+    // subband at a time, or on four of them in the lanes of a Float4.
+    template <typename Value>
+    forcedinline Value loadLanes (const float* src) noexcept
     {
+        if constexpr (std::is_same_v<Value, float>)  return *src;
+        else                                         return Value::load (src);
+    }
+
+    forcedinline void storeLanes (float* dest, float v) noexcept    { *dest = v; }
+    forcedinline void storeLanes (float* dest, Float4 v) noexcept   { v.store (dest); }
+
+    template <typename Value>
+    forcedinline void dct36_0 (int v, float* ts, float* out1, float* out2, const float* wintab, Value sum0, Value sum1) noexcept
+    {
+        constexpr int numLanes = sizeof (Value) / sizeof (float);
+        const auto window = [wintab] (int i) { return loadLanes<Value> (wintab + numLanes * i); };
+
         auto tmp = sum0 + sum1;
-        out2[9 + v] = tmp * wintab[27 + v];
-        out2[8 - v] = tmp * wintab[26 - v];
+        storeLanes (out2 + subBandLimit * (9 + v), tmp * window (27 + v));
+        storeLanes (out2 + subBandLimit * (8 - v), tmp * window (26 - v));
         sum0 -= sum1;
-        ts[subBandLimit * (8 - v)] = out1[8 - v] + sum0 * wintab[8 - v];
-        ts[subBandLimit * (9 + v)] = out1[9 + v] + sum0 * wintab[9 + v];
+        storeLanes (ts + subBandLimit * (8 - v), loadLanes<Value> (out1 + subBandLimit * (8 - v)) + sum0 * window (8 - v));
+        storeLanes (ts + subBandLimit * (9 + v), loadLanes<Value> (out1 + subBandLimit * (9 + v)) + sum0 * window (9 + v));
     }
 
-    inline void dct36_12 (int v1, int v2, float* ts, float* out1, float* out2, const float* wintab,
-                          float tmp1a, float tmp1b, float tmp2a, float tmp2b) noexcept
+    template <typename Value>
+    forcedinline void dct36_12 (int v1, int v2, float* ts, float* out1, float* out2, const float* wintab,
+                                Value tmp1a, Value tmp1b, Value tmp2a, Value tmp2b) noexcept
     {
-        dct36_0 (v1, ts, out1, out2, wintab, tmp1a + tmp2a, (tmp1b + tmp2b) * cos36[v1]);
-        dct36_0 (v2, ts, out1, out2, wintab, tmp2a - tmp1a, (tmp2b - tmp1b) * cos36[v2]);
+        dct36_0<Value> (v1, ts, out1, out2, wintab, tmp1a + tmp2a, (tmp1b + tmp2b) * cos36[v1]);
+        dct36_0<Value> (v2, ts, out1, out2, wintab, tmp2a - tmp1a, (tmp2b - tmp1b) * cos36[v2]);
     }
 
-    static void dct36 (float* in, float* out1, float* out2, const float* wintab, float* ts) noexcept
+    template <typename Value>
+    static void dct36 (Value* in, float* out1, float* out2, const float* wintab, float* ts) noexcept
     {
         in[17] += in[16]; in[16] += in[15]; in[15] += in[14]; in[14] += in[13]; in[13] += in[12];
         in[12] += in[11]; in[11] += in[10]; in[10] += in[9];  in[9]  += in[8];  in[8]  += in[7];
@@ -1114,38 +1317,55 @@ namespace DCT
         in[2]  += in[1];  in[1]  += in[0];  in[17] += in[15]; in[15] += in[13]; in[13] += in[11];
         in[11] += in[9];  in[9]  += in[7];  in[7]  += in[5];  in[5]  += in[3];  in[3]  += in[1];
 
-        auto ta33 = in[6]  * cos9[3];
-        auto ta66 = in[12] * cos9[6];
-        auto tb33 = in[7]  * cos9[3];
-        auto tb66 = in[13] * cos9[6];
-
-        dct36_12 (0, 8, ts, out1, out2, wintab,
-                  in[2] * cos9[1] + ta33 + in[10] * cos9[5] + in[14] * cos9[7],
-                  in[3] * cos9[1] + tb33 + in[11] * cos9[5] + in[15] * cos9[7],
-                  in[0] + in[4] * cos9[2] + in[8] * cos9[4] + ta66 + in[16] * cos9[8],
-                  in[1] + in[5] * cos9[2] + in[9] * cos9[4] + tb66 + in[17] * cos9[8]);
-
-        dct36_12 (1, 7, ts, out1, out2, wintab,
-                  (in[2] - in[10] - in[14]) * cos9[3],
-                  (in[3] - in[11] - in[15]) * cos9[3],
-                  (in[4] - in[8] - in[16]) * cos9[6] - in[12] + in[0],
-                  (in[5] - in[9] - in[17]) * cos9[6] - in[13] + in[1]);
+        Value ta33 = in[6]  * cos9[3];
+        Value ta66 = in[12] * cos9[6];
+        Value tb33 = in[7]  * cos9[3];
+        Value tb66 = in[13] * cos9[6];
+
+        dct36_12<Value> (0, 8, ts, out1, out2, wintab,
+                         in[2] * cos9[1] + ta33 + in[10] * cos9[5] + in[14] * cos9[7],
+                         in[3] * cos9[1] + tb33 + in[11] * cos9[5] + in[15] * cos9[7],
+                         in[0] + in[4] * cos9[2] + in[8] * cos9[4] + ta66 + in[16] * cos9[8],
+                         in[1] + in[5] * cos9[2] + in[9] * cos9[4] + tb66 + in[17] * cos9[8]);
+
+        dct36_12<Value> (1, 7, ts, out1, out2, wintab,
+                         (in[2] - in[10] - in[14]) * cos9[3],
+                         (in[3] - in[11] - in[15]) * cos9[3],
+                         (in[4] - in[8] - in[16]) * cos9[6] - in[12] + in[0],
+                         (in[5] - in[9] - in[17]) * cos9[6] - in[13] + in[1]);
+
+        dct36_12<Value> (2, 6, ts, out1, out2, wintab,
+                         in[2] * cos9[5] - ta33 - in[10] * cos9[7] + in[14] * cos9[1],
+                         in[3] * cos9[5] - tb33 - in[11] * cos9[7] + in[15] * cos9[1],
+                         in[0] - in[4] * cos9[8] - in[8] * cos9[2] + ta66 + in[16] * cos9[4],
+                         in[1] - in[5] * cos9[8] - in[9] * cos9[2] + tb66 + in[17] * cos9[4]);
+
+        dct36_12<Value> (3, 5, ts, out1, out2, wintab,
+                         in[2] * cos9[7] - ta33 + in[10] * cos9[1] - in[14] * cos9[5],
+                         in[3] * cos9[7] - tb33 + in[11] * cos9[1] - in[15] * cos9[5],
+                         in[0] - in[4] * cos9[4] + in[8] * cos9[8] + ta66 - in[16] * cos9[2],
+                         in[1] - in[5] * cos9[4] + in[9] * cos9[8] + tb66 - in[17] * cos9[2]);
+
+        dct36_0<Value> (4, ts, out1, out2, wintab,
+                        in[0] - in[4] + in[8] - in[12] + in[16],
+                        (in[1] - in[5] + in[9] - in[13] + in[17]) * cos36[4]);
+    }
 
-        dct36_12 (2, 6, ts, out1, out2, wintab,
-                  in[2] * cos9[5] - ta33 - in[10] * cos9[7] + in[14] * cos9[1],
-                  in[3] * cos9[5] - tb33 - in[11] * cos9[7] + in[15] * cos9[1],
-                  in[0] - in[4] * cos9[8] - in[8] * cos9[2] + ta66 + in[16] * cos9[4],
-                  in[1] - in[5] * cos9[8] - in[9] * cos9[2] + tb66 + in[17] * cos9[4]);
+    // Runs dct36 on four neighbouring subbands, starting with an even one
+    static void dct36x4 (const float (*in)[18], float* out1, float* out2, const float* wintab, float* ts) noexcept
+    {
+        Float4 lanes[18];
 
-        dct36_12 (3, 5, ts, out1, out2, wintab,
-                  in[2] * cos9[7] - ta33 + in[10] * cos9[1] - in[14] * cos9[5],
-                  in[3] * cos9[7] - tb33 + in[11] * cos9[1] - in[15] * cos9[5],
-                  in[0] - in[4] * cos9[4] + in[8] * cos9[8] + ta66 - in[16] * cos9[2],
-                  in[1] - in[5] * cos9[4] + in[9] * cos9[8] + tb66 - in[17] * cos9[2]);
+        for (int i = 0; i < 18; i += 4)
+        {
+            const auto offset = jmin (i, 14);
+            auto a = Float4::load (in[0] + offset), b = Float4::load (in[1] + offset);
+            auto c = Float4::load (in[2] + offset), d = Float4::load (in[3] + offset);
+            Float4::transpose (a, b, c, d);
+            lanes[offset] = a; lanes[offset + 1] = b; lanes[offset + 2] = c; lanes[offset + 3] = d;
+        }
 
-        dct36_0 (4, ts, out1, out2, wintab,
-                 in[0] - in[4] + in[8] - in[12] + in[16],
-                 (in[1] - in[5] + in[9] - in[13] + in[17]) * cos36[4]);
+        dct36<Float4> (lanes, out1, out2, wintab, ts);
     }
 
     struct DCT12Inputs
@@ -1180,11 +1400,11 @@ namespace DCT
     {
         {
             ts[0] = out1[0];
-            ts[subBandLimit * 1] = out1[1];
-            ts[subBandLimit * 2] = out1[2];
-            ts[subBandLimit * 3] = out1[3];
-            ts[subBandLimit * 4] = out1[4];
-            ts[subBandLimit * 5] = out1[5];
+            ts[1 * subBandLimit] = out1[1 * subBandLimit];
+            ts[2 * subBandLimit] = out1[2 * subBandLimit];
+            ts[3 * subBandLimit] = out1[3 * subBandLimit];
+            ts[4 * subBandLimit] = out1[4 * subBandLimit];
+            ts[5 * subBandLimit] = out1[5 * subBandLimit];
 
             DCT12Inputs inputs (in);
 
@@ -1194,23 +1414,23 @@ namespace DCT
                 auto tmp0 = tmp1 + tmp2;
                 tmp1 -= tmp2;
 
-                ts[16 * subBandLimit] = out1[16] + tmp0 * wi[10];
-                ts[13 * subBandLimit] = out1[13] + tmp0 * wi[7];
-                ts[7  * subBandLimit] = out1[7]  + tmp1 * wi[1];
-                ts[10 * subBandLimit] = out1[10] + tmp1 * wi[4];
+                ts[16 * subBandLimit] = out1[16 * subBandLimit] + tmp0 * wi[10];
+                ts[13 * subBandLimit] = out1[13 * subBandLimit] + tmp0 * wi[7];
+                ts[7  * subBandLimit] = out1[7  * subBandLimit] + tmp1 * wi[1];
+                ts[10 * subBandLimit] = out1[10 * subBandLimit] + tmp1 * wi[4];
             }
 
             inputs.process();
 
-            ts[17 * subBandLimit] = out1[17] + inputs.in2 * wi[11];
-            ts[12 * subBandLimit] = out1[12] + inputs.in2 * wi[6];
-            ts[14 * subBandLimit] = out1[14] + inputs.in3 * wi[8];
-            ts[15 * subBandLimit] = out1[15] + inputs.in3 * wi[9];
+            ts[17 * subBandLimit] = out1[17 * subBandLimit] + inputs.in2 * wi[11];
+            ts[12 * subBandLimit] = out1[12 * subBandLimit] + inputs.in2 * wi[6];
+            ts[14 * subBandLimit] = out1[14 * subBandLimit] + inputs.in3 * wi[8];
+            ts[15 * subBandLimit] = out1[15 * subBandLimit] + inputs.in3 * wi[9];
 
-            ts[6  * subBandLimit] = out1[6]  + inputs.in0 * wi[0];
-            ts[11 * subBandLimit] = out1[11] + inputs.in0 * wi[5];
-            ts[8  * subBandLimit] = out1[8]  + inputs.in4 * wi[2];
-            ts[9  * subBandLimit] = out1[9]  + inputs.in4 * wi[3];
+            ts[6  * subBandLimit] = out1[6  * subBandLimit] + inputs.in0 * wi[0];
+            ts[11 * subBandLimit] = out1[11 * subBandLimit] + inputs.in0 * wi[5];
+            ts[8  * subBandLimit] = out1[8  * subBandLimit] + inputs.in4 * wi[2];
+            ts[9  * subBandLimit] = out1[9  * subBandLimit] + inputs.in4 * wi[3];
         }
 
         {
@@ -1219,17 +1439,17 @@ namespace DCT
             auto tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
             auto tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
-            out2[4] = tmp0 * wi[10];
-            out2[1] = tmp0 * wi[7];
+            out2[4 * subBandLimit] = tmp0 * wi[10];
+            out2[1 * subBandLimit] = tmp0 * wi[7];
             ts[13 * subBandLimit] += tmp1 * wi[1];
             ts[16 * subBandLimit] += tmp1 * wi[4];
 
             inputs.process();
 
-            out2[5] = inputs.in2 * wi[11];
+            out2[5 * subBandLimit] = inputs.in2 * wi[11];
             out2[0] = inputs.in2 * wi[6];
-            out2[2] = inputs.in3 * wi[8];
-            out2[3] = inputs.in3 * wi[9];
+            out2[2 * subBandLimit] = inputs.in3 * wi[8];
+            out2[3 * subBandLimit] = inputs.in3 * wi[9];
             ts[12 * subBandLimit] += inputs.in0 * wi[0];
             ts[17 * subBandLimit] += inputs.in0 * wi[5];
             ts[14 * subBandLimit] += inputs.in4 * wi[2];
@@ -1238,164 +1458,117 @@ namespace DCT
 
         {
             DCT12Inputs inputs (++in);
-            out2[12] = out2[13] = out2[14] = out2[15] = out2[16] = out2[17] = 0;
+            for (int i = 12; i < 18; ++i)
+                out2[i * subBandLimit] = 0;
 
             auto tmp1 = (inputs.in0 - inputs.in4);
             auto tmp2 = (inputs.in1 - inputs.in5) * cos12[1];
             auto tmp0 = tmp1 + tmp2;
             tmp1 -= tmp2;
 
-            out2[10] = tmp0 * wi[10];
-            out2[7]  = tmp0 * wi[7];
-            out2[1] += tmp1 * wi[1];
-            out2[4] += tmp1 * wi[4];
+            out2[10 * subBandLimit] = tmp0 * wi[10];
+            out2[7 * subBandLimit]  = tmp0 * wi[7];
+            out2[1 * subBandLimit] += tmp1 * wi[1];
+            out2[4 * subBandLimit] += tmp1 * wi[4];
 
             inputs.process();
 
-            out2[11] = inputs.in2 * wi[11];
-            out2[6]  = inputs.in2 * wi[6];
-            out2[8]  = inputs.in3 * wi[8];
-            out2[9]  = inputs.in3 * wi[9];
+            out2[11 * subBandLimit] = inputs.in2 * wi[11];
+            out2[6 * subBandLimit]  = inputs.in2 * wi[6];
+            out2[8 * subBandLimit]  = inputs.in3 * wi[8];
+            out2[9 * subBandLimit]  = inputs.in3 * wi[9];
             out2[0] += inputs.in0 * wi[0];
-            out2[5] += inputs.in0 * wi[5];
-            out2[2] += inputs.in4 * wi[2];
-            out2[3] += inputs.in4 * wi[3];
+            out2[5 * subBandLimit] += inputs.in0 * wi[5];
+            out2[2 * subBandLimit] += inputs.in4 * wi[2];
+            out2[3 * subBandLimit] += inputs.in4 * wi[3];
         }
     }
 
+    // Writes the 17 values for one column of each of the synthesis buffers
     static void dct64 (float* out0, float* out1, const float* samples) noexcept
     {
-        float b1[32], b2[32];
-
-        {
-            auto* costab = constants.cosTables[0];
-            b1[0x00] = samples[0x00] + samples[0x1F];   b1[0x1F] = (samples[0x00] - samples[0x1F]) * costab[0x0];
-            b1[0x01] = samples[0x01] + samples[0x1E];   b1[0x1E] = (samples[0x01] - samples[0x1E]) * costab[0x1];
-            b1[0x02] = samples[0x02] + samples[0x1D];   b1[0x1D] = (samples[0x02] - samples[0x1D]) * costab[0x2];
-            b1[0x03] = samples[0x03] + samples[0x1C];   b1[0x1C] = (samples[0x03] - samples[0x1C]) * costab[0x3];
-            b1[0x04] = samples[0x04] + samples[0x1B];   b1[0x1B] = (samples[0x04] - samples[0x1B]) * costab[0x4];
-            b1[0x05] = samples[0x05] + samples[0x1A];   b1[0x1A] = (samples[0x05] - samples[0x1A]) * costab[0x5];
-            b1[0x06] = samples[0x06] + samples[0x19];   b1[0x19] = (samples[0x06] - samples[0x19]) * costab[0x6];
-            b1[0x07] = samples[0x07] + samples[0x18];   b1[0x18] = (samples[0x07] - samples[0x18]) * costab[0x7];
-            b1[0x08] = samples[0x08] + samples[0x17];   b1[0x17] = (samples[0x08] - samples[0x17]) * costab[0x8];
-            b1[0x09] = samples[0x09] + samples[0x16];   b1[0x16] = (samples[0x09] - samples[0x16]) * costab[0x9];
-            b1[0x0A] = samples[0x0A] + samples[0x15];   b1[0x15] = (samples[0x0A] - samples[0x15]) * costab[0xA];
-            b1[0x0B] = samples[0x0B] + samples[0x14];   b1[0x14] = (samples[0x0B] - samples[0x14]) * costab[0xB];
-            b1[0x0C] = samples[0x0C] + samples[0x13];   b1[0x13] = (samples[0x0C] - samples[0x13]) * costab[0xC];
-            b1[0x0D] = samples[0x0D] + samples[0x12];   b1[0x12] = (samples[0x0D] - samples[0x12]) * costab[0xD];
-            b1[0x0E] = samples[0x0E] + samples[0x11];   b1[0x11] = (samples[0x0E] - samples[0x11]) * costab[0xE];
-            b1[0x0F] = samples[0x0F] + samples[0x10];   b1[0x10] = (samples[0x0F] - samples[0x10]) * costab[0xF];
-        }
-
-        {
-            auto* costab = constants.cosTables[1];
-            b2[0x00] = b1[0x00] + b1[0x0F];   b2[0x0F] = (b1[0x00] - b1[0x0F]) * costab[0];
-            b2[0x01] = b1[0x01] + b1[0x0E];   b2[0x0E] = (b1[0x01] - b1[0x0E]) * costab[1];
-            b2[0x02] = b1[0x02] + b1[0x0D];   b2[0x0D] = (b1[0x02] - b1[0x0D]) * costab[2];
-            b2[0x03] = b1[0x03] + b1[0x0C];   b2[0x0C] = (b1[0x03] - b1[0x0C]) * costab[3];
-            b2[0x04] = b1[0x04] + b1[0x0B];   b2[0x0B] = (b1[0x04] - b1[0x0B]) * costab[4];
-            b2[0x05] = b1[0x05] + b1[0x0A];   b2[0x0A] = (b1[0x05] - b1[0x0A]) * costab[5];
-            b2[0x06] = b1[0x06] + b1[0x09];   b2[0x09] = (b1[0x06] - b1[0x09]) * costab[6];
-            b2[0x07] = b1[0x07] + b1[0x08];   b2[0x08] = (b1[0x07] - b1[0x08]) * costab[7];
-            b2[0x10] = b1[0x10] + b1[0x1F];   b2[0x1F] = (b1[0x1F] - b1[0x10]) * costab[0];
-            b2[0x11] = b1[0x11] + b1[0x1E];   b2[0x1E] = (b1[0x1E] - b1[0x11]) * costab[1];
-            b2[0x12] = b1[0x12] + b1[0x1D];   b2[0x1D] = (b1[0x1D] - b1[0x12]) * costab[2];
-            b2[0x13] = b1[0x13] + b1[0x1C];   b2[0x1C] = (b1[0x1C] - b1[0x13]) * costab[3];
-            b2[0x14] = b1[0x14] + b1[0x1B];   b2[0x1B] = (b1[0x1B] - b1[0x14]) * costab[4];
-            b2[0x15] = b1[0x15] + b1[0x1A];   b2[0x1A] = (b1[0x1A] - b1[0x15]) * costab[5];
-            b2[0x16] = b1[0x16] + b1[0x19];   b2[0x19] = (b1[0x19] - b1[0x16]) * costab[6];
-            b2[0x17] = b1[0x17] + b1[0x18];   b2[0x18] = (b1[0x18] - b1[0x17]) * costab[7];
-        }
-
-        {
-            auto* costab = constants.cosTables[2];
-            b1[0x00] = b2[0x00] + b2[0x07];   b1[0x07] = (b2[0x00] - b2[0x07]) * costab[0];
-            b1[0x01] = b2[0x01] + b2[0x06];   b1[0x06] = (b2[0x01] - b2[0x06]) * costab[1];
-            b1[0x02] = b2[0x02] + b2[0x05];   b1[0x05] = (b2[0x02] - b2[0x05]) * costab[2];
-            b1[0x03] = b2[0x03] + b2[0x04];   b1[0x04] = (b2[0x03] - b2[0x04]) * costab[3];
-            b1[0x08] = b2[0x08] + b2[0x0F];   b1[0x0F] = (b2[0x0F] - b2[0x08]) * costab[0];
-            b1[0x09] = b2[0x09] + b2[0x0E];   b1[0x0E] = (b2[0x0E] - b2[0x09]) * costab[1];
-            b1[0x0A] = b2[0x0A] + b2[0x0D];   b1[0x0D] = (b2[0x0D] - b2[0x0A]) * costab[2];
-            b1[0x0B] = b2[0x0B] + b2[0x0C];   b1[0x0C] = (b2[0x0C] - b2[0x0B]) * costab[3];
-            b1[0x10] = b2[0x10] + b2[0x17];   b1[0x17] = (b2[0x10] - b2[0x17]) * costab[0];
-            b1[0x11] = b2[0x11] + b2[0x16];   b1[0x16] = (b2[0x11] - b2[0x16]) * costab[1];
-            b1[0x12] = b2[0x12] + b2[0x15];   b1[0x15] = (b2[0x12] - b2[0x15]) * costab[2];
-            b1[0x13] = b2[0x13] + b2[0x14];   b1[0x14] = (b2[0x13] - b2[0x14]) * costab[3];
-            b1[0x18] = b2[0x18] + b2[0x1F];   b1[0x1F] = (b2[0x1F] - b2[0x18]) * costab[0];
-            b1[0x19] = b2[0x19] + b2[0x1E];   b1[0x1E] = (b2[0x1E] - b2[0x19]) * costab[1];
-            b1[0x1A] = b2[0x1A] + b2[0x1D];   b1[0x1D] = (b2[0x1D] - b2[0x1A]) * costab[2];
-            b1[0x1B] = b2[0x1B] + b2[0x1C];   b1[0x1C] = (b2[0x1C] - b2[0x1B]) * costab[3];
-        }
-
-        {
-            auto cos0 = constants.cosTables[3][0];
-            auto cos1 = constants.cosTables[3][1];
-            b2[0x00] = b1[0x00] + b1[0x03];   b2[0x03] = (b1[0x00] - b1[0x03]) * cos0;
-            b2[0x01] = b1[0x01] + b1[0x02];   b2[0x02] = (b1[0x01] - b1[0x02]) * cos1;
-            b2[0x04] = b1[0x04] + b1[0x07];   b2[0x07] = (b1[0x07] - b1[0x04]) * cos0;
-            b2[0x05] = b1[0x05] + b1[0x06];   b2[0x06] = (b1[0x06] - b1[0x05]) * cos1;
-            b2[0x08] = b1[0x08] + b1[0x0B];   b2[0x0B] = (b1[0x08] - b1[0x0B]) * cos0;
-            b2[0x09] = b1[0x09] + b1[0x0A];   b2[0x0A] = (b1[0x09] - b1[0x0A]) * cos1;
-            b2[0x0C] = b1[0x0C] + b1[0x0F];   b2[0x0F] = (b1[0x0F] - b1[0x0C]) * cos0;
-            b2[0x0D] = b1[0x0D] + b1[0x0E];   b2[0x0E] = (b1[0x0E] - b1[0x0D]) * cos1;
-            b2[0x10] = b1[0x10] + b1[0x13];   b2[0x13] = (b1[0x10] - b1[0x13]) * cos0;
-            b2[0x11] = b1[0x11] + b1[0x12];   b2[0x12] = (b1[0x11] - b1[0x12]) * cos1;
-            b2[0x14] = b1[0x14] + b1[0x17];   b2[0x17] = (b1[0x17] - b1[0x14]) * cos0;
-            b2[0x15] = b1[0x15] + b1[0x16];   b2[0x16] = (b1[0x16] - b1[0x15]) * cos1;
-            b2[0x18] = b1[0x18] + b1[0x1B];   b2[0x1B] = (b1[0x18] - b1[0x1B]) * cos0;
-            b2[0x19] = b1[0x19] + b1[0x1A];   b2[0x1A] = (b1[0x19] - b1[0x1A]) * cos1;
-            b2[0x1C] = b1[0x1C] + b1[0x1F];   b2[0x1F] = (b1[0x1F] - b1[0x1C]) * cos0;
-            b2[0x1D] = b1[0x1D] + b1[0x1E];   b2[0x1E] = (b1[0x1E] - b1[0x1D]) * cos1;
-        }
-
-        {
-            auto cos0 = constants.cosTables[4][0];
-            b1[0x00] = b2[0x00] + b2[0x01];   b1[0x01] = (b2[0x00] - b2[0x01]) * cos0;
-            b1[0x02] = b2[0x02] + b2[0x03];   b1[0x03] = (b2[0x03] - b2[0x02]) * cos0;  b1[0x02] += b1[0x03];
-            b1[0x04] = b2[0x04] + b2[0x05];   b1[0x05] = (b2[0x04] - b2[0x05]) * cos0;
-            b1[0x06] = b2[0x06] + b2[0x07];   b1[0x07] = (b2[0x07] - b2[0x06]) * cos0;
-            b1[0x06] += b1[0x07];   b1[0x04] += b1[0x06];  b1[0x06] += b1[0x05]; b1[0x05] += b1[0x07];
-            b1[0x08] = b2[0x08] + b2[0x09];   b1[0x09] = (b2[0x08] - b2[0x09]) * cos0;
-            b1[0x0A] = b2[0x0A] + b2[0x0B];   b1[0x0B] = (b2[0x0B] - b2[0x0A]) * cos0;  b1[0x0A] += b1[0x0B];
-            b1[0x0C] = b2[0x0C] + b2[0x0D];   b1[0x0D] = (b2[0x0C] - b2[0x0D]) * cos0;
-            b1[0x0E] = b2[0x0E] + b2[0x0F];   b1[0x0F] = (b2[0x0F] - b2[0x0E]) * cos0;
-            b1[0x0E] += b1[0x0F];   b1[0x0C] += b1[0x0E];  b1[0x0E] += b1[0x0D]; b1[0x0D] += b1[0x0F];
-            b1[0x10] = b2[0x10] + b2[0x11];   b1[0x11] = (b2[0x10] - b2[0x11]) * cos0;
-            b1[0x12] = b2[0x12] + b2[0x13];   b1[0x13] = (b2[0x13] - b2[0x12]) * cos0;  b1[0x12] += b1[0x13];
-            b1[0x14] = b2[0x14] + b2[0x15];   b1[0x15] = (b2[0x14] - b2[0x15]) * cos0;
-            b1[0x16] = b2[0x16] + b2[0x17];   b1[0x17] = (b2[0x17] - b2[0x16]) * cos0;
-            b1[0x16] += b1[0x17];    b1[0x14] += b1[0x16]; b1[0x16] += b1[0x15];  b1[0x15] += b1[0x17];
-            b1[0x18] = b2[0x18] + b2[0x19];   b1[0x19] = (b2[0x18] - b2[0x19]) * cos0;
-            b1[0x1A] = b2[0x1A] + b2[0x1B];   b1[0x1B] = (b2[0x1B] - b2[0x1A]) * cos0;  b1[0x1A] += b1[0x1B];
-            b1[0x1C] = b2[0x1C] + b2[0x1D];   b1[0x1D] = (b2[0x1C] - b2[0x1D]) * cos0;
-            b1[0x1E] = b2[0x1E] + b2[0x1F];   b1[0x1F] = (b2[0x1F] - b2[0x1E]) * cos0;
-            b1[0x1E] += b1[0x1F];    b1[0x1C] += b1[0x1E]; b1[0x1E] += b1[0x1D];  b1[0x1D] += b1[0x1F];
-        }
-
-        out0[0x10 * 16] = b1[0x00];  out0[0x10 * 12] = b1[0x04]; out0[0x10 * 8]  = b1[0x02];  out0[0x10 * 4]  = b1[0x06];
-        out0[0] = b1[0x01];  out1[0]  = b1[0x01]; out1[0x10 * 4]  = b1[0x05];  out1[0x10 * 8]  = b1[0x03];
-        out1[0x10 * 12] = b1[0x07];
-
-        b1[0x08] += b1[0x0C];  out0[0x10 * 14] = b1[0x08];  b1[0x0C] += b1[0x0a];  out0[0x10 * 10] = b1[0x0C];
-        b1[0x0A] += b1[0x0E];  out0[0x10 * 6]  = b1[0x0A];  b1[0x0E] += b1[0x09];  out0[0x10 * 2]  = b1[0x0E];
-        b1[0x09] += b1[0x0D];  out1[0x10 * 2]  = b1[0x09];  b1[0x0D] += b1[0x0B];  out1[0x10 * 6]  = b1[0x0D];
-        b1[0x0B] += b1[0x0F];  out1[0x10 * 10] = b1[0x0B];  out1[0x10 * 14] = b1[0x0F];
-
-        b1[0x18] += b1[0x1C];  out0[0x10 * 15] = b1[0x10] + b1[0x18];   out0[0x10 * 13] = b1[0x18] + b1[0x14];
-        b1[0x1C] += b1[0x1a];  out0[0x10 * 11] = b1[0x14] + b1[0x1C];   out0[0x10 * 9]  = b1[0x1C] + b1[0x12];
-        b1[0x1A] += b1[0x1E];  out0[0x10 * 7]  = b1[0x12] + b1[0x1A];   out0[0x10 * 5]  = b1[0x1A] + b1[0x16];
-        b1[0x1E] += b1[0x19];  out0[0x10 * 3]  = b1[0x16] + b1[0x1E];   out0[0x10 * 1]  = b1[0x1E] + b1[0x11];
-        b1[0x19] += b1[0x1D];  out1[0x10 * 1]  = b1[0x11] + b1[0x19];   out1[0x10 * 3]  = b1[0x19] + b1[0x15];
-        b1[0x1D] += b1[0x1B];  out1[0x10 * 5]  = b1[0x15] + b1[0x1D];   out1[0x10 * 7]  = b1[0x1D] + b1[0x13];
-        b1[0x1B] += b1[0x1F];  out1[0x10 * 9]  = b1[0x13] + b1[0x1B];   out1[0x10 * 11] = b1[0x1B] + b1[0x17];
-        out1[0x10 * 13] = b1[0x17] + b1[0x1F];  out1[0x10 * 15] = b1[0x1F];
+        // The first three stages pair each value in a block with its mirror image. Keeping the
+        // differences in the opposite order to the sums means every lane does exactly the same
+        // subtraction as the scalar version of this did.
+        const auto butterfly = [] (Float4 values, Float4 mirrorImage, const float* cosines, Float4& sums, Float4& differences)
+        {
+            const auto mirrored = mirrorImage.reversed();
+            sums = values + mirrored;
+            differences = (values - mirrored) * Float4::load (cosines);
+        };
+
+        Float4 sums1[4], differences1[4];
+
+        for (int i = 0; i < 4; ++i)
+            butterfly (Float4::load (samples + 4 * i), Float4::load (samples + 28 - 4 * i),
+                       constants.cosTables[0] + 4 * i, sums1[i], differences1[i]);
+
+        Float4 sums2[4], differences2[4];
+        butterfly (sums1[0],        sums1[3],        constants.cosTables[1],     sums2[0],        differences2[0]);
+        butterfly (sums1[1],        sums1[2],        constants.cosTables[1] + 4, sums2[1],        differences2[1]);
+        butterfly (differences1[0], differences1[3], constants.cosTables[1],     sums2[2],        differences2[2]);
+        butterfly (differences1[1], differences1[2], constants.cosTables[1] + 4, sums2[3],        differences2[3]);
+
+        // After this, the sums hold the first half of each block of 8 and the differences
+        // hold the second half, backwards
+        Float4 p0, p1, p2, p3, p4, p5, p6, p7;
+        butterfly (sums2[0],        sums2[1],        constants.cosTables[2], p0, p7);
+        butterfly (differences2[0], differences2[1], constants.cosTables[2], p1, p6);
+        butterfly (sums2[2],        sums2[3],        constants.cosTables[2], p2, p5);
+        butterfly (differences2[2], differences2[3], constants.cosTables[2], p3, p4);
+
+        // The last two stages do the same thing to each block of 8, so give each block a lane
+        Float4::transpose (p0, p1, p2, p3);
+        Float4::transpose (p7, p6, p5, p4);
+
+        {
+            const Float4 cos0 (constants.cosTables[3][0]), cos1 (constants.cosTables[3][1]);
+            const auto r0 = p0 + p3, r3 = (p0 - p3) * cos0, r1 = p1 + p2, r2 = (p1 - p2) * cos1;
+            const auto r4 = p4 + p7, r7 = (p7 - p4) * cos0, r5 = p5 + p6, r6 = (p6 - p5) * cos1;
+
+            const Float4 cos4 (constants.cosTables[4][0]);
+            p0 = r0 + r1;  p1 = (r0 - r1) * cos4;
+            p3 = (r3 - r2) * cos4;  p2 = (r2 + r3) + p3;
+            p5 = (r4 - r5) * cos4;
+            p7 = (r7 - r6) * cos4;  p6 = (r6 + r7) + p7;
+            p4 = (r4 + r5) + p6;  p6 += p5;  p5 += p7;
+        }
+
+        Float4::transpose (p0, p1, p2, p3);
+        Float4::transpose (p4, p5, p6, p7);
+
+        float b1[32];
+        p0.store (b1);       p4.store (b1 + 4);
+        p1.store (b1 + 8);   p5.store (b1 + 12);
+        p2.store (b1 + 16);  p6.store (b1 + 20);
+        p3.store (b1 + 24);  p7.store (b1 + 28);
+
+        out0[16] = b1[0x00];  out0[12] = b1[0x04];  out0[8] = b1[0x02];  out0[4] = b1[0x06];
+        out0[0]  = b1[0x01];  out1[0]  = b1[0x01];  out1[4] = b1[0x05];  out1[8] = b1[0x03];
+        out1[12] = b1[0x07];
+
+        b1[0x08] += b1[0x0C];  out0[14] = b1[0x08];  b1[0x0C] += b1[0x0a];  out0[10] = b1[0x0C];
+        b1[0x0A] += b1[0x0E];  out0[6]  = b1[0x0A];  b1[0x0E] += b1[0x09];  out0[2]  = b1[0x0E];
+        b1[0x09] += b1[0x0D];  out1[2]  = b1[0x09];  b1[0x0D] += b1[0x0B];  out1[6]  = b1[0x0D];
+        b1[0x0B] += b1[0x0F];  out1[10] = b1[0x0B];  out1[14] = b1[0x0F];
+
+        b1[0x18] += b1[0x1C];  out0[15] = b1[0x10] + b1[0x18];   out0[13] = b1[0x18] + b1[0x14];
+        b1[0x1C] += b1[0x1a];  out0[11] = b1[0x14] + b1[0x1C];   out0[9]  = b1[0x1C] + b1[0x12];
+        b1[0x1A] += b1[0x1E];  out0[7]  = b1[0x12] + b1[0x1A];   out0[5]  = b1[0x1A] + b1[0x16];
+        b1[0x1E] += b1[0x19];  out0[3]  = b1[0x16] + b1[0x1E];   out0[1]  = b1[0x1E] + b1[0x11];
+        b1[0x19] += b1[0x1D];  out1[1]  = b1[0x11] + b1[0x19];   out1[3]  = b1[0x19] + b1[0x15];
+        b1[0x1D] += b1[0x1B];  out1[5]  = b1[0x15] + b1[0x1D];   out1[7]  = b1[0x1D] + b1[0x13];
+        b1[0x1B] += b1[0x1F];  out1[9]  = b1[0x13] + b1[0x1B];   out1[11] = b1[0x1B] + b1[0x17];
+        out1[13] = b1[0x17] + b1[0x1F];  out1[15] = b1[0x1F];
     }
 }
 
 //==============================================================================
 struct MP3Stream
 {
-    MP3Stream (InputStream& source)  : stream (source, 8192)
+    MP3Stream (InputStream& source)
+        : bufferedSource (createBufferFor (source)),
+          stream (bufferedSource != nullptr ? *bufferedSource : source)
     {
         reset();
     }
@@ -1499,6 +1672,12 @@ struct MP3Stream
                 if (frame.layer < 3 && frame.crc16FollowsHeader)
                     getBits (16);
 
+                // The synthesis filter's phase follows the frame number rather than the number of
+                // frames that were decoded, so that frames which can't be decoded don't shift it, and
+                // decoding after a seek gives exactly the same output as decoding from the start.
+                const auto slotsPerFrame = frame.layer == 1 ? 12 : (frame.layer == 3 && frame.lsf != 0 ? 18 : 36);
+                synthBo = (1 - slotsPerFrame * (currentFrameIndex - 1 - firstAudioFrame)) & 15;
+
                 switch (frame.layer)
                 {
                     case 1:  decodeLayer1Frame (out0, out1, done); break;
@@ -1567,17 +1746,8 @@ struct MP3Stream
     {
         frameIndex = jmax (0, frameIndex);
 
-        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
-        {
-            int dummy = 0;
-            auto result = decodeNextBlock (nullptr, nullptr, dummy);
-
-            if (result < 0)
-                return false;
-
-            if (result > 0)
-                break;
-        }
+        if (! indexFramesUpTo (frameIndex))
+            return false;
 
         frameIndex = jmin (frameIndex & ~(storedStartPosInterval - 1),
                            (frameStreamPositions.size() - 1) * storedStartPosInterval);
@@ -1588,13 +1758,83 @@ struct MP3Stream
         return true;
     }
 
+    /*  Makes sure that the start of the given frame is in the seek index, finding any
+        missing frames by reading just their headers. This returns false if the stream
+        ends before the given frame.
+    */
+    bool indexFramesUpTo (int frameIndex)
+    {
+        if (frameStreamPositions.isEmpty())
+            return false;
+
+        auto indexedFrame = (frameStreamPositions.size() - 1) * storedStartPosInterval;
+
+        if (frameIndex < indexedFrame + storedStartPosInterval)
+            return ! frameIndexComplete || frameIndex < numFramesInStream;
+
+        if (frameIndexComplete)
+            return false;
+
+        const auto oldPos = stream.getPosition();
+        auto pos = frameStreamPositions.getLast();
+
+        for (;;)
+        {
+            const auto headerPos = findFrameHeader (pos);
+
+            if (headerPos < 0)
+            {
+                frameIndexComplete = true;
+                numFramesInStream = indexedFrame;
+                break;
+            }
+
+            if ((indexedFrame & (storedStartPosInterval - 1)) == 0)
+            {
+                frameStreamPositions.set (indexedFrame / storedStartPosInterval, headerPos);
+
+                if (frameIndex < indexedFrame + storedStartPosInterval)
+                    break;
+            }
+
+            MP3Frame header;
+            header.decodeHeader ((uint32) stream.readIntBigEndian());
+            pos = headerPos + 4 + header.frameSize;
+            ++indexedFrame;
+        }
+
+        stream.setPosition (oldPos);
+        return ! frameIndexComplete || frameIndex < numFramesInStream;
+    }
+
+    /*  The positions of every storedStartPosInterval'th frame, which will be complete once
+        indexFramesUpTo() has reached the end of the stream.
+    */
+    const Array<int64>& getFrameStreamPositions() const noexcept    { return frameStreamPositions; }
+    int getNumFramesInStream() const noexcept                        { return frameIndexComplete ? numFramesInStream : -1; }
+
+    void setCompleteFrameIndex (const Array<int64>& positions, int numFramesToUse)
+    {
+        frameStreamPositions = positions;
+        numFramesInStream = numFramesToUse;
+        frameIndexComplete = true;
+    }
+
     MP3Frame frame;
     VBRTagData vbrTagData;
-    BufferedInputStream stream;
+    std::unique_ptr<BufferedInputStream> bufferedSource;
+    InputStream& stream;
     int numFrames = 0, currentFrameIndex = 0;
     bool vbrHeaderFound = false;
 
+    // This is 1 when the first frame holds a VBR header rather than audio
+    int firstAudioFrame = 0;
+
+    enum { storedStartPosInterval = 4 };
+
 private:
+    friend struct juce::MP3AudioFormatTests;
+
     bool headerParsed, sideParsed, dataParsed, needToSyncBitStream;
     bool isFreeFormat, wasFreeFormat;
     int sideInfoSize, dataSize;
@@ -1604,9 +1844,10 @@ private:
     uint8 bufferSpace[2][2880 + 1024];
     uint8* bufferPointer;
     int bitIndex, synthBo;
-    float hybridBlock[2][2][32 * 18];
+    float hybridBlock[2][2][18 * 32];
     int hybridBlockIndex[2];
-    float synthBuffers[2][2][0x110];
+    enum { synthRows = 17 };
+    float synthBuffers[2][2][16 * synthRows];
     float hybridIn[2][32][18];
     float hybridOut[2][18][32];
 
@@ -1627,8 +1868,9 @@ private:
         zeromem (synthBuffers, sizeof (synthBuffers));
     }
 
-    enum { storedStartPosInterval = 4 };
     Array<int64> frameStreamPositions;
+    int numFramesInStream = 0;
+    bool frameIndexComplete = false;
 
     struct SideInfoLayer1
     {
@@ -1642,6 +1884,15 @@ private:
         uint8 scaleFactor[32][2][3];
     };
 
+    // Sources that are already in memory are read directly, rather than copied through another buffer
+    static std::unique_ptr<BufferedInputStream> createBufferFor (InputStream& source)
+    {
+        if (dynamic_cast<MemoryInputStream*> (&source) != nullptr || dynamic_cast<MemoryMappedFileInputStream*> (&source) != nullptr)
+            return {};
+
+        return std::make_unique<BufferedInputStream> (source, 8192);
+    }
+
     static bool isValidHeader (uint32 header, int oldLayer) noexcept
     {
         auto newLayer = (int) (4 - ((header >> 17) & 3));
@@ -1700,6 +1951,73 @@ private:
         return result;
     }
 
+    uint32 peekBitsUnchecked (int numBits) const noexcept
+    {
+        return (uint32) (((((bufferPointer[0] << 8) | bufferPointer[1]) << bitIndex) & 0xffff) >> (16 - numBits));
+    }
+
+    void skipBits (int numBits) noexcept
+    {
+        bitIndex += numBits;
+        bufferPointer += (bitIndex >> 3);
+        bitIndex &= 7;
+    }
+
+    // Reads one big-values code word, looking up as many of its bits as possible at once.
+    // This consumes exactly the same bits as walking the tree one bit at a time.
+    int decodeHuffmanPair (const int16* tree, const HuffmanLookup& lookup, int& part2remain) noexcept
+    {
+        const auto& entry = lookup.entries[peekBitsUnchecked (HuffmanLookup::numLookupBits)];
+        skipBits (entry.numBits);
+        part2remain -= entry.numBits;
+
+        if (entry.isLeaf)
+            return entry.value;
+
+        auto* val = tree + entry.value;
+        int y;
+
+        while ((y = *val++) < 0)
+        {
+            if (getOneBit())
+                val -= y;
+
+            --part2remain;
+        }
+
+        return y;
+    }
+
+    // Reads the code word for a quadruple of values in the count1 region. Close to the end
+    // of the granule's data this goes one bit at a time, so that it stops in the same place.
+    int decodeCount1Quad (int tableIndex, int& part2remain) noexcept
+    {
+        const auto& entry = constants.count1Lookups[tableIndex].entries[peekBitsUnchecked (HuffmanLookup::numLookupBits)];
+
+        if (entry.isLeaf && (int) entry.numBits <= part2remain)
+        {
+            skipBits (entry.numBits);
+            part2remain -= entry.numBits;
+            return entry.value;
+        }
+
+        auto* values = huffmanTables2[tableIndex].table;
+        int16 a;
+
+        while ((a = *values++) < 0)
+        {
+            if (part2remain <= 0)
+                return 0;
+
+            --part2remain;
+
+            if (getOneBit())
+                values -= a;
+        }
+
+        return a;
+    }
+
     inline uint8  getBitsUint8  (int numBits) noexcept  { return (uint8)  getBitsUnchecked (numBits); }
     inline uint16 getBitsUint16 (int numBits) noexcept  { return (uint16) getBitsUnchecked (numBits); }
 
@@ -1750,6 +2068,33 @@ private:
         return offset;
     }
 
+    // Returns the position of the first frame header at or after pos, in the same way as scanForNextFrameHeader()
+    int64 findFrameHeader (int64 pos)
+    {
+        stream.setPosition (pos);
+        uint32 header = 0;
+
+        for (int offset = -3; offset <= 32768; ++offset)
+        {
+            if (stream.isExhausted())
+                break;
+
+            header = (header << 8) | (uint8) stream.readByte();
+
+            // Free-format frames can't be skipped over without decoding them, so the index stops there
+            if (offset >= 0 && isValidHeader (header, frame.layer))
+            {
+                if (((header >> 12) & 15) == 0)
+                    break;
+
+                stream.setPosition (pos + offset);
+                return pos + offset;
+            }
+        }
+
+        return -1;
+    }
+
     void readVBRHeader()
     {
         auto oldPos = stream.getPosition();
@@ -1762,6 +2107,9 @@ private:
         {
             numFrames = (int) vbrTagData.frames;
             oldPos += jmax (vbrTagData.headersize, 1);
+
+            if (currentFrameIndex == 1)
+                firstAudioFrame = 1;
         }
 
         stream.setPosition (oldPos);
@@ -1779,7 +2127,7 @@ private:
             for (int i = 0; i < 12; ++i)
             {
                 layer1Step2 (si, fraction);
-                synthesise (fraction[single], 0, pcm0, samplesDone);
+                synthesise (fraction[single], pcm0, samplesDone);
             }
         }
         else
@@ -1807,7 +2155,7 @@ private:
                 layer2Step2 (si, i >> 2, fraction);
 
                 for (int j = 0; j < 3; ++j)
-                    synthesise (fraction[single][j], 0, pcm0, samplesDone);
+                    synthesise (fraction[single][j], pcm0, samplesDone);
             }
         }
         else
@@ -1913,7 +2261,7 @@ private:
             for (int ss = 0; ss < 18; ++ss)
             {
                 if (single >= 0)
-                    synthesise (hybridOut[0][ss], 0, pcm0, samplesDone);
+                    synthesise (hybridOut[0][ss], pcm0, samplesDone);
                 else
                     synthesiseStereo (hybridOut[0][ss], hybridOut[1][ss], pcm0, pcm1, samplesDone);
             }
@@ -2536,6 +2884,7 @@ private:
             for (int i = 0; i < 2; ++i)
             {
                 auto* h = huffmanTables1 + granule.tableSelect[i];
+                auto* lookup = constants.huffmanLookups[granule.tableSelect[i]];
 
                 for (int lp = l[i]; lp != 0; --lp, --mc)
                 {
@@ -2559,16 +2908,7 @@ private:
                         }
                     }
 
-                    auto* val = h->table;
-
-                    while ((y = *val++) < 0)
-                    {
-                        if (getOneBit())
-                            val -= y;
-
-                        --part2remain;
-                    }
-
+                    y = decodeHuffmanPair (h->table, *lookup, part2remain);
                     x = y >> 4;
                     y &= 15;
 
@@ -2612,23 +2952,7 @@ private:
 
             for (; l3 && (part2remain > 0); --l3)
             {
-                auto* h = huffmanTables2 + granule.count1TableSelect;
-                auto* val = h->table;
-                int16 a;
-
-                while ((a = *val++) < 0)
-                {
-                    if (part2remain <= 0)
-                    {
-                        a = 0;
-                        break;
-                    }
-
-                    --part2remain;
-
-                    if (getOneBit())
-                        val -= a;
-                }
+                const auto a = decodeCount1Quad ((int) granule.count1TableSelect, part2remain);
 
                 for (int i = 0; i < 4; ++i)
                 {
@@ -2710,6 +3034,7 @@ private:
             for (int i = 0; i < 3; ++i)
             {
                 auto* h = huffmanTables1 + granule.tableSelect[i];
+                auto* lookup = constants.huffmanLookups[granule.tableSelect[i]];
 
                 for (int lp = l[i]; lp != 0; --lp, --mc)
                 {
@@ -2720,15 +3045,7 @@ private:
                         cb = *map++;
                     }
 
-                    auto* val = h->table;
-                    int y;
-
-                    while ((y = *val++) < 0)
-                    {
-                        if (getOneBit()) val -= y;
-                        --part2remain;
-                    }
-
+                    auto y = decodeHuffmanPair (h->table, *lookup, part2remain);
                     int x = y >> 4;
                     y &= 15;
 
@@ -2768,23 +3085,7 @@ private:
 
             for (; l3 && part2remain > 0; --l3)
             {
-                auto* h = huffmanTables2 + granule.count1TableSelect;
-                auto* values = h->table;
-                int16 a;
-
-                while ((a = *values++) < 0)
-                {
-                    if (part2remain <= 0)
-                    {
-                        a = 0;
-                        break;
-                    }
-
-                    --part2remain;
-
-                    if (getOneBit())
-                        values -= a;
-                }
+                const auto a = decodeCount1Quad ((int) granule.count1TableSelect, part2remain);
 
                 for (int i = 0; i < 4; ++i)
                 {
@@ -2852,108 +3153,161 @@ private:
         {
             sb = 2;
             DCT::dct36 (fsIn[0], rawout1, rawout2, constants.win[0], ts);
-            DCT::dct36 (fsIn[1], rawout1 + 18, rawout2 + 18, constants.win1[0], ts + 1);
-            rawout1 += 36;
-            rawout2 += 36;
+            DCT::dct36 (fsIn[1], rawout1 + 1, rawout2 + 1, constants.win1[0], ts + 1);
+            rawout1 += 2;
+            rawout2 += 2;
             ts += 2;
         }
 
         auto bt = granule.blockType;
+        const auto maxb = (int) granule.maxb;
 
         if (bt == 2)
         {
-            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
+            for (; sb < maxb; sb += 2, ts += 2, rawout1 += 2, rawout2 += 2)
             {
                 DCT::dct12 (fsIn[sb], rawout1, rawout2, constants.win[2], ts);
-                DCT::dct12 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[2], ts + 1);
+                DCT::dct12 (fsIn[sb + 1], rawout1 + 1, rawout2 + 1, constants.win1[2], ts + 1);
             }
         }
         else
         {
-            for (; sb < (int) granule.maxb; sb += 2, ts += 2, rawout1 += 36, rawout2 += 36)
+            // Only subbands below maxb go through the transform, so the result is the same as
+            // doing them one at a time
+            for (; sb + 4 <= maxb; sb += 4, ts += 4, rawout1 += 4, rawout2 += 4)
+                DCT::dct36x4 (fsIn + sb, rawout1, rawout2, constants.hybridWindows[bt], ts);
+
+            for (; sb < maxb; sb += 2, ts += 2, rawout1 += 2, rawout2 += 2)
             {
                 DCT::dct36 (fsIn[sb], rawout1, rawout2, constants.win[bt], ts);
-                DCT::dct36 (fsIn[sb + 1], rawout1 + 18, rawout2 + 18, constants.win1[bt], ts + 1);
+                DCT::dct36 (fsIn[sb + 1], rawout1 + 1, rawout2 + 1, constants.win1[bt], ts + 1);
             }
         }
 
-        for (; sb < 32; ++sb, ++ts)
+        for (int i = 0; i < 18; ++i)
         {
-            for (int i = 0; i < 18; ++i)
+            for (int j = 0; j < 32 - sb; ++j)
             {
-                ts[i * 32] = *rawout1++;
-                *rawout2++ = 0;
+                ts[i * 32 + j] = rawout1[i * 32 + j];
+                rawout2[i * 32 + j] = 0;
             }
         }
     }
 
     void synthesiseStereo (const float* bandPtr0, const float* bandPtr1, float* out0, float* out1, int& samplesDone) noexcept
     {
-        auto dummy = samplesDone;
-        synthesise (bandPtr0, 0, out0, dummy);
-        synthesise (bandPtr1, 1, out1, samplesDone);
+        const float* bandPtrs[] = { bandPtr0, bandPtr1 };
+        float* outs[] = { out0 + samplesDone, out1 + samplesDone };
+        synthesiseChannels<2> (bandPtrs, outs);
+        samplesDone += 32;
+    }
+
+    void synthesise (const float* bandPtr, float* out, int& samplesDone) noexcept
+    {
+        const float* bandPtrs[] = { bandPtr };
+        float* outs[] = { out + samplesDone };
+        synthesiseChannels<1> (bandPtrs, outs);
+        samplesDone += 32;
     }
 
-    void synthesise (const float* bandPtr, int channel, float* out, int& samplesDone)
+    // Each synthesis buffer holds 16 columns of the 17 values that dct64 produces, and
+    // the window is applied to 4 output samples at a time. Both channels are done
+    // together so that they can share the window coefficients.
+    template <int numChannels>
+    void synthesiseChannels (const float* const* bandPtrs, float* const* outs) noexcept
     {
-        out += samplesDone;
-        const int bo = channel == 0 ? ((synthBo - 1) & 15) : synthBo;
-        float (*buf)[0x110] = synthBuffers[channel];
-        float* b0;
-        auto bo1 = bo;
+        const int bo = (synthBo - 1) & 15;
+        const int bo1 = (bo & 1) != 0 ? bo : bo + 1;
+        const float* b0[numChannels];
+        synthBo = bo;
 
-        if (bo & 1)
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            b0 = buf[0];
-            DCT::dct64 (buf[1] + ((bo + 1) & 15), buf[0] + bo, bandPtr);
+            auto* buf = synthBuffers[ch];
+
+            if (bo & 1)
+            {
+                b0[ch] = buf[0];
+                DCT::dct64 (buf[1] + synthRows * ((bo + 1) & 15), buf[0] + synthRows * bo, bandPtrs[ch]);
+            }
+            else
+            {
+                b0[ch] = buf[1];
+                DCT::dct64 (buf[0] + synthRows * bo, buf[1] + synthRows * bo1, bandPtrs[ch]);
+            }
         }
-        else
+
+        // All 16 rows are summed together, which gives four independent chains of additions
+        // per channel rather than one long one
+        Float4 sums[numChannels][4];
+
+        const auto accumulate = [&] (int x, int k, auto&& op)
         {
-            ++bo1;
-            b0 = buf[1];
-            DCT::dct64 (buf[0] + bo, buf[1] + bo1, bandPtr);
-        }
+            const auto* w = constants.synthesisWindow[x];
+            const auto w0 = Float4::load (w),     w1 = Float4::load (w + 4);
+            const auto w2 = Float4::load (w + 8), w3 = Float4::load (w + 12);
 
-        synthBo = bo;
-        const float* window = constants.decodeWin + 16 - bo1;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* b = b0[ch] + synthRows * k;
+                op (sums[ch][0], w0 * Float4::load (b));
+                op (sums[ch][1], w1 * Float4::load (b + 4));
+                op (sums[ch][2], w2 * Float4::load (b + 8));
+                op (sums[ch][3], w3 * Float4::load (b + 12));
+            }
+        };
+
+        const auto set    = [] (Float4& sum, Float4 product) { sum = product; };
+        const auto negate = [] (Float4& sum, Float4 product) { sum = -product; };
+        const auto add    = [] (Float4& sum, Float4 product) { sum += product; };
+        const auto sub    = [] (Float4& sum, Float4 product) { sum -= product; };
+
+        accumulate (16 - bo1, 0, set);
 
-        for (int j = 16; j != 0; --j, b0 += 16, window += 32)
+        for (int k = 1; k < 15; k += 2)
         {
-            auto sum = window[0] * b0[0];  sum -= window[1] * b0[1];
-            sum += window[2]  * b0[2];   sum -= window[3]  * b0[3];
-            sum += window[4]  * b0[4];   sum -= window[5]  * b0[5];
-            sum += window[6]  * b0[6];   sum -= window[7]  * b0[7];
-            sum += window[8]  * b0[8];   sum -= window[9]  * b0[9];
-            sum += window[10] * b0[10];  sum -= window[11] * b0[11];
-            sum += window[12] * b0[12];  sum -= window[13] * b0[13];
-            sum += window[14] * b0[14];  sum -= window[15] * b0[15];
-            *out++ = sum;
+            accumulate (16 - bo1 + k, k, sub);
+            accumulate (17 - bo1 + k, k + 1, add);
         }
 
+        accumulate (31 - bo1, 15, sub);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int group = 0; group < 4; ++group)
+                sums[ch][group].store (outs[ch] + 4 * group);
+
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            auto sum = window[0] * b0[0];   sum += window[2] * b0[2];
-            sum += window[4]  * b0[4];   sum += window[6]  * b0[6];
-            sum += window[8]  * b0[8];   sum += window[10] * b0[10];
-            sum += window[12] * b0[12];  sum += window[14] * b0[14];
-            *out++ = sum;
-            b0 -= 16; window -= 32;
-            window += (ptrdiff_t) bo1 << 1;
+            auto* w = constants.decodeWin + 16 - bo1 + 512;
+            auto* b = b0[ch] + 16;
+
+            auto sum = w[0] * b[0];   sum += w[2] * b[2 * synthRows];
+            sum += w[4]  * b[4  * synthRows];   sum += w[6]  * b[6  * synthRows];
+            sum += w[8]  * b[8  * synthRows];   sum += w[10] * b[10 * synthRows];
+            sum += w[12] * b[12 * synthRows];   sum += w[14] * b[14 * synthRows];
+            outs[ch][16] = sum;
         }
 
-        for (int j = 15; j != 0; --j, b0 -= 16, window -= 32)
+        // Rows 15 down to 1 give the last 15 samples, so each group is reversed on the
+        // way out. Row 0 is computed along with them but never used.
+        accumulate (15 + bo1, 0, negate);
+
+        for (int k = 1; k < 15; ++k)
+            accumulate (15 + bo1 - k, k, sub);
+
+        accumulate (16 + bo1, 15, sub);
+
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            auto sum = -window[-1] * b0[0];  sum -= window[-2] * b0[1];
-            sum -= window[-3]  * b0[2];   sum -= window[-4]  * b0[3];
-            sum -= window[-5]  * b0[4];   sum -= window[-6]  * b0[5];
-            sum -= window[-7]  * b0[6];   sum -= window[-8]  * b0[7];
-            sum -= window[-9]  * b0[8];   sum -= window[-10] * b0[9];
-            sum -= window[-11] * b0[10];  sum -= window[-12] * b0[11];
-            sum -= window[-13] * b0[12];  sum -= window[-14] * b0[13];
-            sum -= window[-15] * b0[14];  sum -= window[0]   * b0[15];
-            *out++ = sum;
-        }
+            float firstGroup[4];
+            sums[ch][0].store (firstGroup);
 
-        samplesDone += 32;
+            for (int i = 1; i < 4; ++i)
+                outs[ch][32 - i] = firstGroup[i];
+
+            for (int group = 1; group < 4; ++group)
+                sums[ch][group].reversed().store (outs[ch] + 29 - 4 * group);
+        }
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MP3Stream)
@@ -2962,11 +3316,92 @@ private:
 //==============================================================================
 static const char* const mp3FormatName = "MP3 file";
 
+//==============================================================================
+/*  Stores the frame index of an MP3 file, so that it only has to be built the first time
+    the file is opened. An index is only used if the size and modification time of its
+    file are still the same.
+*/
+struct SeekIndexCache
+{
+    SeekIndexCache (const File& directory, const File& sourceFileToUse)
+        : sourceFile (sourceFileToUse),
+          indexFile (directory.getChildFile (String::toHexString (sourceFile.hashCode64()) + ".mp3index"))
+    {}
+
+    bool load (MP3Stream& stream) const
+    {
+        FileInputStream in (indexFile);
+
+        if (! in.openedOk()
+             || in.readInt() != magicNumber
+             || in.readInt64() != sourceFile.getSize()
+             || in.readInt64() != sourceFile.getLastModificationTime().toMilliseconds())
+            return false;
+
+        const auto numFrames = in.readInt();
+        const auto numPositions = in.readInt();
+
+        if (numFrames < 0 || numPositions <= 0
+             || numPositions != (numFrames + MP3Stream::storedStartPosInterval - 1) / MP3Stream::storedStartPosInterval
+             || in.getNumBytesRemaining() != (int64) numPositions * 8)
+            return false;
+
+        Array<int64> positions;
+        positions.resize (numPositions);
+
+        if (in.read (positions.data(), numPositions * 8) != numPositions * 8)
+            return false;
+
+        for (auto& position : positions)
+            position = (int64) ByteOrder::swapIfBigEndian ((uint64) position);
+
+        stream.setCompleteFrameIndex (positions, numFrames);
+        return true;
+    }
+
+    void save (const MP3Stream& stream) const
+    {
+        const auto& positions = stream.getFrameStreamPositions();
+
+        if (! indexFile.getParentDirectory().createDirectory())
+            return;
+
+        TemporaryFile tempFile (indexFile);
+
+        {
+            FileOutputStream out (tempFile.getFile());
+
+            if (! out.openedOk())
+                return;
+
+            out.writeInt (magicNumber);
+            out.writeInt64 (sourceFile.getSize());
+            out.writeInt64 (sourceFile.getLastModificationTime().toMilliseconds());
+            out.writeInt (stream.getNumFramesInStream());
+            out.writeInt (positions.size());
+
+            for (auto position : positions)
+                out.writeInt64 (position);
+
+            out.flush();
+
+            if (out.getStatus().failed())
+                return;
+        }
+
+        tempFile.overwriteTargetFileWithTemporary();
+    }
+
+    static constexpr int magicNumber = (int) ByteOrder::makeInt ('M', 'P', 'I', '1');
+
+    const File sourceFile, indexFile;
+};
+
 //==============================================================================
 class MP3Reader final : public AudioFormatReader
 {
 public:
-    MP3Reader (InputStream* const in)
+    MP3Reader (InputStream* const in, const SeekIndexCache* seekIndexCache = nullptr)
         : AudioFormatReader (in, mp3FormatName),
           stream (*in), currentPosition (0),
           decodedStart (0), decodedEnd (0)
@@ -2980,6 +3415,15 @@ public:
             usesFloatingPointData = true;
             sampleRate = stream.frame.getFrequency();
             numChannels = (unsigned int) stream.frame.numChannels;
+
+            if (seekIndexCache != nullptr && ! seekIndexCache->load (stream))
+            {
+                stream.indexFramesUpTo (std::numeric_limits<int>::max() - MP3Stream::storedStartPosInterval);
+
+                if (stream.getNumFramesInStream() > 0)
+                    seekIndexCache->save (stream);
+            }
+
             lengthInSamples = findLength (streamPos);
         }
     }
@@ -2995,37 +3439,28 @@ public:
 
         if (currentPosition != startSampleInFile)
         {
-            if (! stream.seek ((int) (startSampleInFile / 1152 - 1)))
+            const auto targetFrame = (int) (startSampleInFile / 1152) + stream.firstAudioFrame;
+
+            if (! stream.seek (targetFrame - numFramesToPrime))
             {
                 currentPosition = -1;
                 createEmptyDecodedData();
             }
             else
             {
-                decodedStart = decodedEnd = 0;
-                const int64 streamPos = stream.currentFrameIndex * 1152;
-                int toSkip = (int) (startSampleInFile - streamPos);
-                jassert (toSkip >= 0);
-
-                while (toSkip > 0)
+                // The frames before the target refill the bit reservoir and synthesis filters. Some
+                // of them may not produce any output, so the frames are counted rather than the samples.
+                do
                 {
                     if (! readNextBlock())
                     {
                         createEmptyDecodedData();
                         break;
                     }
-
-                    const int numReady = decodedEnd - decodedStart;
-
-                    if (numReady > toSkip)
-                    {
-                        decodedStart += toSkip;
-                        break;
-                    }
-
-                    toSkip -= numReady;
                 }
+                while (stream.currentFrameIndex <= targetFrame);
 
+                decodedStart = jmin (decodedEnd, (int) (startSampleInFile % 1152));
                 currentPosition = startSampleInFile;
             }
         }
@@ -3061,6 +3496,9 @@ private:
     MP3Stream stream;
     int64 currentPosition;
     enum { decodedDataSize = 1152 };
+
+    // Enough frames to refill the 511-byte bit reservoir, even at the lowest bitrates
+    static constexpr int numFramesToPrime = 8;
     float decoded0[decodedDataSize], decoded1[decodedDataSize];
     int decodedStart, decodedEnd;
 
@@ -3126,6 +3564,10 @@ private:
     {
         int64 numFrames = stream.numFrames;
 
+        // The frame holding a VBR header doesn't contain any audio
+        if (numFrames <= 0 && stream.getNumFramesInStream() > 0)
+            numFrames = stream.getNumFramesInStream() - stream.firstAudioFrame;
+
         if (numFrames <= 0)
         {
             const int64 streamSize = stream.stream.getTotalLength();
@@ -3160,9 +3602,22 @@ bool MP3AudioFormat::canDoMono()                    { return true; }
 bool MP3AudioFormat::isCompressed()                 { return true; }
 StringArray MP3AudioFormat::getQualityOptions()     { return {}; }
 
+void MP3AudioFormat::setSeekIndexDirectory (const File& directory)    { seekIndexDirectory = directory; }
+File MP3AudioFormat::getSeekIndexDirectory() const                     { return seekIndexDirectory; }
+
 AudioFormatReader* MP3AudioFormat::createReaderFor (InputStream* sourceStream, const bool deleteStreamIfOpeningFails)
 {
-    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream));
+    std::optional<MP3Decoder::SeekIndexCache> seekIndexCache;
+
+    if (seekIndexDirectory != File())
+    {
+        if (auto* fileStream = dynamic_cast<FileInputStream*> (sourceStream))
+            seekIndexCache.emplace (seekIndexDirectory, fileStream->getFile());
+        else if (auto* mappedStream = dynamic_cast<MemoryMappedFileInputStream*> (sourceStream))
+            seekIndexCache.emplace (seekIndexDirectory, mappedStream->getFile());
+    }
+
+    std::unique_ptr<MP3Decoder::MP3Reader> r (new MP3Decoder::MP3Reader (sourceStream, seekIndexCache ? &*seekIndexCache : nullptr));
 
     if (r->lengthInSamples > 0)
         return r.release();
@@ -3181,6 +3636,229 @@ AudioFormatWriter* MP3AudioFormat::createWriterFor (OutputStream*, double /*samp
     return nullptr;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MP3AudioFormatTests final : public UnitTest
+{
+    MP3AudioFormatTests()
+        : UnitTest ("MP3 audio format", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Frame headers are indexed");
+        {
+            const auto stream = createStream (1000);
+            MemoryInputStream in (stream.data, false);
+            MP3Decoder::MP3Stream mp3 (in);
+
+            int samplesDone = 0;
+            expectEquals (mp3.decodeNextBlock (nullptr, nullptr, samplesDone), 1);
+
+            expect (mp3.indexFramesUpTo (500));
+            expectEquals (mp3.getNumFramesInStream(), -1);
+            expect (! mp3.indexFramesUpTo (1000));
+            expectEquals (mp3.getNumFramesInStream(), 1000);
+
+            const auto& positions = mp3.getFrameStreamPositions();
+            expectEquals (positions.size(), 250);
+
+            for (int i = 0; i < positions.size(); ++i)
+                expectEquals (positions[i], stream.framePositions[i * MP3Decoder::MP3Stream::storedStartPosInterval]);
+        }
+
+        beginTest ("Lengths are exact when there's a seek index directory");
+        {
+            const TemporaryFile sourceFile (".mp3"), indexDirectory;
+            const auto stream = createStream (1001);
+            sourceFile.getFile().replaceWithData (stream.data.getData(), stream.data.getSize());
+
+            MP3AudioFormat format;
+            format.setSeekIndexDirectory (indexDirectory.getFile());
+            expectEquals (createReader (format, sourceFile.getFile())->lengthInSamples, (int64) 1001 * 1152);
+            expectEquals (indexDirectory.getFile().getNumberOfChildFiles (File::findFiles), 1);
+
+            // The stored index is used again...
+            const auto indexFile = indexDirectory.getFile().findChildFiles (File::findFiles, false)[0];
+            const auto indexTime = indexFile.getLastModificationTime();
+            expectEquals (createReader (format, sourceFile.getFile())->lengthInSamples, (int64) 1001 * 1152);
+            expect (indexFile.getLastModificationTime() == indexTime);
+
+            // ...until the file changes
+            const auto newStream = createStream (1500);
+            sourceFile.getFile().replaceWithData (newStream.data.getData(), newStream.data.getSize());
+            sourceFile.getFile().setLastModificationTime (sourceFile.getFile().getLastModificationTime() + RelativeTime::seconds (10.0));
+            expectEquals (createReader (format, sourceFile.getFile())->lengthInSamples, (int64) 1500 * 1152);
+
+            auto reader = createReader (format, sourceFile.getFile());
+            AudioBuffer<float> buffer (1, 3000);
+
+            for (auto start : { (int64) 1499 * 1152 - 1000, (int64) 7, (int64) 1000 * 1152 })
+                expect (reader->read (&buffer, 0, buffer.getNumSamples(), start, true, false));
+        }
+
+        beginTest ("Huffman lookups read the same bits as walking the trees");
+        {
+            using namespace MP3Decoder;
+            MemoryInputStream in (nullptr, 0, false);
+            auto mp3 = std::make_unique<MP3Stream> (in);
+            Random random (1);
+
+            for (int tableIndex = 0; tableIndex < 34; ++tableIndex)
+            {
+                const auto isCount1 = tableIndex >= 32;
+                const auto* tree = isCount1 ? huffmanTables2[tableIndex - 32].table : huffmanTables1[tableIndex].table;
+                auto* data = mp3->bufferSpace[0] + 512;
+
+                for (int i = 0; i < 1024; ++i)
+                    data[i] = (uint8) random.nextInt (256);
+
+                mp3->bufferPointer = data;
+                mp3->bitIndex = 0;
+                int part2remain = isCount1 ? 2000 : 0, expectedPart2remain = part2remain, bitPosition = 0;
+
+                for (int i = 0; i < 200; ++i)
+                {
+                    const auto value = isCount1 ? mp3->decodeCount1Quad (tableIndex - 32, part2remain)
+                                                : mp3->decodeHuffmanPair (tree, *constants.huffmanLookups[tableIndex], part2remain);
+
+                    expectEquals (value, walkTree (tree, data, bitPosition, expectedPart2remain, isCount1));
+                    expectEquals (part2remain, expectedPart2remain);
+                    expectEquals ((int) (mp3->bufferPointer - data) * 8 + mp3->bitIndex, bitPosition);
+                }
+            }
+        }
+
+        beginTest ("Vectorised IMDCT matches the scalar one");
+        {
+            using namespace MP3Decoder;
+            Random random (2);
+
+            for (int blockType : { 0, 1, 3 })
+            {
+                float in[4][18], scalarIn[4][18], out1[18 * 32], out2[18 * 32], scalarOut2[18 * 32], ts[18 * 32], scalarTs[18 * 32];
+
+                for (auto* array : { &in[0][0], out1 })
+                    for (int i = 0; i < (array == out1 ? 18 * 32 : 4 * 18); ++i)
+                        array[i] = random.nextFloat() * 2.0f - 1.0f;
+
+                memcpy (scalarIn, in, sizeof (in));
+                DCT::dct36x4 (in, out1, out2, constants.hybridWindows[blockType], ts);
+
+                for (int sb = 0; sb < 4; ++sb)
+                    DCT::dct36 (scalarIn[sb], out1 + sb, scalarOut2 + sb,
+                                (sb & 1) == 0 ? constants.win[blockType] : constants.win1[blockType], scalarTs + sb);
+
+                for (int i = 0; i < 18; ++i)
+                {
+                    for (int sb = 0; sb < 4; ++sb)
+                    {
+                        expectEquals (ts[32 * i + sb], scalarTs[32 * i + sb]);
+                        expectEquals (out2[32 * i + sb], scalarOut2[32 * i + sb]);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Stereo synthesis matches synthesising each channel separately");
+        {
+            MemoryInputStream in (nullptr, 0, false);
+            auto stereo = std::make_unique<MP3Decoder::MP3Stream> (in);
+            auto left   = std::make_unique<MP3Decoder::MP3Stream> (in);
+            auto right  = std::make_unique<MP3Decoder::MP3Stream> (in);
+            Random random (3);
+
+            float bands[2][32], stereoOut[2][32 * 40], leftOut[32 * 40], rightOut[32 * 40];
+            int stereoDone = 0, leftDone = 0, rightDone = 0;
+
+            for (int slot = 0; slot < 40; ++slot)
+            {
+                for (auto& band : bands)
+                    for (auto& x : band)
+                        x = random.nextFloat() * 2.0f - 1.0f;
+
+                stereo->synthesiseStereo (bands[0], bands[1], stereoOut[0], stereoOut[1], stereoDone);
+                left->synthesise (bands[0], leftOut, leftDone);
+                right->synthesise (bands[1], rightOut, rightDone);
+            }
+
+            expectEquals (stereoDone, 32 * 40);
+            expect (memcmp (stereoOut[0], leftOut, sizeof (leftOut)) == 0);
+            expect (memcmp (stereoOut[1], rightOut, sizeof (rightOut)) == 0);
+        }
+    }
+
+private:
+    struct TestStream
+    {
+        MemoryBlock data;
+        Array<int64> framePositions;
+    };
+
+    // Creates silent mono frames, with a variety of bitrates and some junk between them
+    TestStream createStream (int numFrames)
+    {
+        static constexpr int bitrates[] = { 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+
+        TestStream result;
+        MemoryOutputStream out (result.data, false);
+        Random random (numFrames);
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if (i % 97 == 50)
+                out.writeRepeatedByte (0, (size_t) random.nextInt (100) + 1);
+
+            const auto bitrateIndex = random.nextInt (numElementsInArray (bitrates));
+            const auto padding = random.nextInt (2);
+            const auto frameSize = 144000 * bitrates[bitrateIndex] / 44100 + padding;
+
+            result.framePositions.add (out.getPosition());
+            out.writeByte ((char) 0xff);
+            out.writeByte ((char) 0xfb);
+            out.writeByte ((char) (((bitrateIndex + 1) << 4) | (padding << 1)));
+            out.writeByte ((char) 0xc0);
+            out.writeRepeatedByte (0, (size_t) frameSize - 4);
+        }
+
+        out.flush();
+        return result;
+    }
+
+    // Reads a code word one bit at a time, as the decoder used to
+    static int walkTree (const int16* tree, const uint8* data, int& bitPosition, int& part2remain, bool stopAtEnd)
+    {
+        int value;
+
+        while ((value = *tree++) < 0)
+        {
+            if (stopAtEnd && part2remain <= 0)
+                return 0;
+
+            const auto bit = (data[bitPosition >> 3] >> (7 - (bitPosition & 7))) & 1;
+            ++bitPosition;
+            --part2remain;
+
+            if (bit != 0)
+                tree -= value;
+        }
+
+        return value;
+    }
+
+    std::unique_ptr<AudioFormatReader> createReader (AudioFormat& format, const File& file)
+    {
+        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (file.createInputStream().release(), true));
+        expect (reader != nullptr);
+        return reader;
+    }
+};
+
+static MP3AudioFormatTests mp3AudioFormatTests;
+
+#endif
+
 #endif
 
 } // namespace juce
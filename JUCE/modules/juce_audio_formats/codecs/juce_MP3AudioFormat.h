@@ -68,6 +68,26 @@ public:
     bool isCompressed() override;
     StringArray getQualityOptions() override;
 
+    //==============================================================================
+    /** Sets a directory in which readers will keep an index of the frames in each file they open.
+
+        Seeking in an MP3 file means finding the frame that holds the target sample, and
+        without an index this involves reading the header of every frame before it. When
+        a directory is set, the first reader to open a file reads all of its frame headers
+        and stores their positions, so that seeking becomes a constant-time operation and
+        getLengthInSamples() is exact even for files without a VBR header. Later readers of
+        the same file load the stored index, as long as the file's size and modification
+        time haven't changed.
+
+        This only applies to readers created from a FileInputStream or a
+        MemoryMappedFileInputStream. By default no directory is set, and files are
+        indexed in memory as far as they're read.
+    */
+    void setSeekIndexDirectory (const File& directory);
+
+    /** Returns the directory that was set with setSeekIndexDirectory(). */
+    File getSeekIndexDirectory() const;
+
     //==============================================================================
     AudioFormatReader* createReaderFor (InputStream*, bool deleteStreamIfOpeningFails) override;
 
@@ -75,6 +95,9 @@ public:
                                         unsigned int numberOfChannels, int bitsPerSample,
                                         const StringPairArray& metadataValues, int qualityOptionIndex) override;
     using AudioFormat::createWriterFor;
+
+private:
+    File seekIndexDirectory;
 };
 
 #endif
@@ -126,21 +126,40 @@ String AudioFormatManager::getWildcardForAllFormats() const
 }
 
 //==============================================================================
-AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
+template <typename CreateStream>
+static AudioFormatReader* createReaderForFile (const OwnedArray<AudioFormat>& knownFormats, const File& file, CreateStream&& createStream)
 {
     // you need to actually register some formats before the manager can
     // use them to open a file!
-    jassert (getNumKnownFormats() > 0);
+    jassert (! knownFormats.isEmpty());
 
     for (auto* af : knownFormats)
         if (af->canHandleFile (file))
-            if (auto in = file.createInputStream())
+            if (auto in = createStream())
                 if (auto* r = af->createReaderFor (in.release(), true))
                     return r;
 
     return nullptr;
 }
 
+AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
+{
+    return createReaderForFile (knownFormats, file, [&] { return file.createInputStream(); });
+}
+
+AudioFormatReader* AudioFormatManager::createReaderForMappedFile (const File& file)
+{
+    return createReaderForFile (knownFormats, file, [&]() -> std::unique_ptr<InputStream>
+    {
+        auto mapped = std::make_unique<MemoryMappedFileInputStream> (file);
+
+        if (mapped->openedOk())
+            return mapped;
+
+        return file.createInputStream();
+    });
+}
+
 AudioFormatReader* AudioFormatManager::createReaderFor (std::unique_ptr<InputStream> audioFileStream)
 {
     // you need to actually register some formats before the manager can
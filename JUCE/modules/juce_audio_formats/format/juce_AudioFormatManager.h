@@ -134,6 +134,23 @@ public:
     */
     AudioFormatReader* createReaderFor (const File& audioFile);
 
+    /** Searches through the known formats to try to create a suitable reader for
+        this file, which it reads through a MemoryMappedFileInputStream.
+
+        The decoders for compressed formats make many small reads and seeks, and when
+        the file is mapped these are copies from the OS's page cache rather than system
+        calls. If the file can't be mapped (e.g. because there isn't enough address
+        space), this falls back to reading it with a FileInputStream.
+
+        The file mustn't be truncated while the reader exists.
+
+        If none of the registered formats can open the file, it'll return nullptr.
+        It's the caller's responsibility to delete the reader that is returned.
+
+        @see AudioFormat::createMemoryMappedReader
+    */
+    AudioFormatReader* createReaderForMappedFile (const File& audioFile);
+
     /** Searches through the known formats to try to create a suitable reader for
         this stream.
 
@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+/*  The state shared between the thread that calls read() and the pool jobs that help it.
+    Jobs that start after every segment has been claimed return without touching anything
+    else, so the caller only has to wait for the segments, not for the jobs.
+*/
+struct ParallelDecodingReader::SegmentJob
+{
+    explicit SegmentJob (std::function<bool (size_t)> fn, size_t num)
+        : decodeSegment (std::move (fn)), numSegments (num)
+    {
+    }
+
+    void run()
+    {
+        for (size_t index; (index = nextSegment++) < numSegments;)
+        {
+            if (! decodeSegment (index))
+                allSucceeded = false;
+
+            if (++numFinished == numSegments)
+                finished.signal();
+        }
+    }
+
+    const std::function<bool (size_t)> decodeSegment;
+    const size_t numSegments;
+    std::atomic<size_t> nextSegment { 0 }, numFinished { 0 };
+    std::atomic<bool> allSucceeded { true };
+    WaitableEvent finished;
+};
+
+//==============================================================================
+ParallelDecodingReader::ParallelDecodingReader (ReaderFactory createReader,
+                                                ThreadPool& threadPool,
+                                                int64 minimumSegmentLengthToUse)
+    : ParallelDecodingReader (createReader, createReader(), threadPool, minimumSegmentLengthToUse)
+{
+}
+
+ParallelDecodingReader::ParallelDecodingReader (const ReaderFactory& createReader,
+                                                std::unique_ptr<AudioFormatReader> firstReader,
+                                                ThreadPool& threadPool,
+                                                int64 minimumSegmentLengthToUse)
+    : AudioFormatReader (nullptr, firstReader != nullptr ? firstReader->getFormatName() : String()),
+      factory (createReader),
+      pool (threadPool),
+      minimumSegmentLength (jmax (segmentAlignment, minimumSegmentLengthToUse))
+{
+    if (firstReader != nullptr)
+    {
+        sampleRate            = firstReader->sampleRate;
+        bitsPerSample         = firstReader->bitsPerSample;
+        lengthInSamples       = firstReader->lengthInSamples;
+        numChannels           = firstReader->numChannels;
+        usesFloatingPointData = firstReader->usesFloatingPointData;
+        metadataValues        = firstReader->metadataValues;
+        channelLayout         = firstReader->getChannelLayout();
+
+        returnReader (std::move (firstReader));
+    }
+}
+
+ParallelDecodingReader::~ParallelDecodingReader() = default;
+
+//==============================================================================
+bool ParallelDecodingReader::readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                          int64 startSampleInFile, int numSamples)
+{
+    const auto segments = getSegments ({ startSampleInFile, startSampleInFile + numSamples });
+
+    return decodeSegments (segments, [&] (AudioFormatReader* reader, size_t, Range<int64> segment)
+    {
+        const auto offset = startOffsetInDestBuffer + (int) (segment.getStart() - startSampleInFile);
+
+        if (reader != nullptr)
+            return reader->readSamples (destSamples, numDestChannels, offset, segment.getStart(), (int) segment.getLength());
+
+        for (int i = numDestChannels; --i >= 0;)
+            if (destSamples[i] != nullptr)
+                zeromem (destSamples[i] + offset, (size_t) segment.getLength() * sizeof (int));
+
+        return false;
+    });
+}
+
+void ParallelDecodingReader::readMaxLevels (int64 startSample, int64 numSamples,
+                                            Range<float>* results, int numChannelsToRead)
+{
+    jassert (numChannelsToRead > 0 && numChannelsToRead <= (int) numChannels);
+
+    const auto segments = getSegments ({ startSample, startSample + jmax ((int64) 0, numSamples) });
+    std::vector<Range<float>> levels (segments.size() * (size_t) numChannelsToRead);
+
+    decodeSegments (segments, [&] (AudioFormatReader* reader, size_t index, Range<int64> segment)
+    {
+        if (reader == nullptr)
+            return false;
+
+        reader->readMaxLevels (segment.getStart(), segment.getLength(), levels.data() + index * (size_t) numChannelsToRead, numChannelsToRead);
+        return true;
+    });
+
+    for (int i = 0; i < numChannelsToRead; ++i)
+    {
+        results[i] = levels[(size_t) i];
+
+        for (size_t segment = 1; segment < segments.size(); ++segment)
+            results[i] = results[i].getUnionWith (levels[segment * (size_t) numChannelsToRead + (size_t) i]);
+    }
+}
+
+//==============================================================================
+std::vector<Range<int64>> ParallelDecodingReader::getSegments (Range<int64> range) const
+{
+    const auto numSegments = jlimit ((int64) 1, (int64) pool.getNumThreads() + 1, range.getLength() / minimumSegmentLength);
+
+    std::vector<Range<int64>> segments;
+    auto start = range.getStart();
+
+    for (int64 i = 1; i <= numSegments; ++i)
+    {
+        auto end = range.getEnd();
+
+        if (i < numSegments)
+        {
+            end = range.getStart() + range.getLength() * i / numSegments;
+            end = jlimit (start, range.getEnd(), end - ((end % segmentAlignment) + segmentAlignment) % segmentAlignment);
+        }
+
+        if (end > start || segments.empty())
+        {
+            segments.push_back ({ start, end });
+            start = end;
+        }
+    }
+
+    return segments;
+}
+
+bool ParallelDecodingReader::decodeSegments (const std::vector<Range<int64>>& segments, const SegmentDecoder& decode)
+{
+    const auto decodeSegment = [this, &segments, &decode] (size_t index)
+    {
+        auto reader = takeReader();
+        const auto ok = decode (reader.get(), index, segments[index]);
+
+        if (reader != nullptr)
+            returnReader (std::move (reader));
+
+        return ok;
+    };
+
+    if (segments.size() == 1)
+        return decodeSegment (0);
+
+    auto job = std::make_shared<SegmentJob> (decodeSegment, segments.size());
+
+    for (size_t i = 1; i < segments.size(); ++i)
+        pool.addJob ([job] { job->run(); });
+
+    job->run();
+    job->finished.wait();
+
+    return job->allSucceeded;
+}
+
+std::unique_ptr<AudioFormatReader> ParallelDecodingReader::takeReader()
+{
+    {
+        const ScopedLock sl (readerLock);
+
+        if (! idleReaders.empty())
+        {
+            auto reader = std::move (idleReaders.back());
+            idleReaders.pop_back();
+            return reader;
+        }
+    }
+
+    return factory != nullptr ? factory() : nullptr;
+}
+
+void ParallelDecodingReader::returnReader (std::unique_ptr<AudioFormatReader> reader)
+{
+    const ScopedLock sl (readerLock);
+    idleReaders.push_back (std::move (reader));
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelDecodingReaderTests final : public UnitTest
+{
+public:
+    ParallelDecodingReaderTests()  : UnitTest ("ParallelDecodingReader", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        ThreadPool pool { ThreadPoolOptions{}.withNumberOfThreads (3) };
+
+        WavAudioFormat wav;
+        testFormat (pool, wav, 24);
+
+       #if JUCE_USE_FLAC
+        FlacAudioFormat flac;
+        testFormat (pool, flac, 16);
+       #endif
+
+       #if JUCE_USE_OGGVORBIS
+        OggVorbisAudioFormat ogg;
+        testFormat (pool, ogg, 16);
+       #endif
+    }
+
+private:
+    void testFormat (ThreadPool& pool, AudioFormat& format, int bitDepth)
+    {
+        constexpr int numSamples = 150000;
+        const auto data = createFile (format, bitDepth, numSamples);
+
+        const auto createReader = [&]
+        {
+            return std::unique_ptr<AudioFormatReader> (format.createReaderFor (new MemoryInputStream (data, false), true));
+        };
+
+        const auto sequentialReader = createReader();
+        AudioBuffer<float> expected (2, numSamples + 1000);
+        sequentialReader->read (&expected, 0, expected.getNumSamples(), -500, true, true);
+
+        beginTest (format.getFormatName() + " segments match a sequential read");
+        {
+            ParallelDecodingReader reader (createReader, pool, 10000);
+            expectEquals (reader.lengthInSamples, sequentialReader->lengthInSamples);
+
+            for (auto range : { Range<int64> (-500, numSamples + 500), Range<int64> (7, 120007), Range<int64> (33333, 34000) })
+            {
+                AudioBuffer<float> buffer (2, (int) range.getLength());
+                buffer.clear();
+                reader.read (&buffer, 0, buffer.getNumSamples(), range.getStart(), true, true);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    expect (memcmp (buffer.getReadPointer (channel),
+                                    expected.getReadPointer (channel, (int) range.getStart() + 500),
+                                    (size_t) buffer.getNumSamples() * sizeof (float)) == 0);
+            }
+        }
+
+        beginTest (format.getFormatName() + " levels match a sequential scan");
+        {
+            ParallelDecodingReader reader (createReader, pool, 10000);
+
+            for (auto range : { Range<int64> (0, numSamples), Range<int64> (50000, 140000) })
+            {
+                Range<float> levels[2], expectedLevels[2];
+                reader.readMaxLevels (range.getStart(), range.getLength(), levels, 2);
+                sequentialReader->readMaxLevels (range.getStart(), range.getLength(), expectedLevels, 2);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    expect (levels[channel] == expectedLevels[channel]);
+            }
+        }
+    }
+
+    static MemoryBlock createFile (AudioFormat& format, int bitDepth, int numSamples)
+    {
+        AudioBuffer<float> buffer (2, numSamples);
+        Random random (1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto sine = 0.5f * std::sin ((float) i * 0.01f + 0.00001f * (float) i * (float) i / (float) numSamples);
+            buffer.setSample (0, i, sine + 0.1f * random.nextFloat());
+            buffer.setSample (1, i, -sine * 0.7f);
+        }
+
+        MemoryBlock data;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false),
+                                                                               44100.0, 2, bitDepth, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        return data;
+    }
+};
+
+static ParallelDecodingReaderTests parallelDecodingReaderTests;
+
+#endif
+
+} // namespace juce
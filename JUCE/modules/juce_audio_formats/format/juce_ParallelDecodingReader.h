@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioFormatReader that splits large reads into segments and decodes them
+    concurrently on a ThreadPool.
+
+    Compressed formats can only be decoded sequentially, so reading a whole file
+    into memory normally keeps a single core busy. This reader instead opens several
+    readers of the same source, each of which seeks to the start of its own segment,
+    and decodes the segments in parallel. The thread that calls read() decodes
+    segments too, so it's safe to use this from one of the pool's own threads.
+
+    The output is sample-for-sample the same as reading the source sequentially,
+    provided that the source format's readers seek exactly. This is the case for
+    the WAV, AIFF, FLAC, Ogg-Vorbis and MP3 readers, which all decode whatever
+    leading data they need to recreate the decoder's state at the seek position.
+    Segments begin on multiples of segmentAlignment, which is a whole number of
+    MP3 frames and FLAC seek blocks, so that no decoding is wasted part-way into
+    a frame.
+
+    Reads shorter than twice the minimum segment length are passed straight to a
+    single reader, so there's no overhead for small reads, but there's also no
+    speed-up for clients such as AudioThumbnail which read in small blocks.
+
+    e.g.
+    @code
+    ThreadPool pool;
+
+    ParallelDecodingReader reader ([&]
+    {
+        return std::unique_ptr<AudioFormatReader> (formatManager.createReaderFor (file));
+    }, pool);
+
+    AudioBuffer<float> buffer ((int) reader.numChannels, (int) reader.lengthInSamples);
+    reader.read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    @endcode
+
+    @see AudioFormatReader, BufferingAudioReader
+
+    @tags{Audio}
+*/
+class JUCE_API  ParallelDecodingReader  : public AudioFormatReader
+{
+public:
+    /** A function that opens a new, independent reader of the source.
+
+        It's called from the pool's threads as well as the thread that calls read(),
+        and may return nullptr if the source can't be opened.
+    */
+    using ReaderFactory = std::function<std::unique_ptr<AudioFormatReader>()>;
+
+    /** Creates a reader.
+
+        @param createReader             opens the readers used to decode each segment. The
+                                        first one is opened immediately, and the
+                                        properties of this reader are copied from it. If it
+                                        can't be opened, this reader will have no channels
+                                        and a length of zero.
+        @param threadPool               the pool on which segments are decoded. It must
+                                        outlive this reader
+        @param minimumSegmentLength     the smallest number of samples that's worth decoding
+                                        on a separate thread
+    */
+    ParallelDecodingReader (ReaderFactory createReader,
+                            ThreadPool& threadPool,
+                            int64 minimumSegmentLength = 1 << 17);
+
+    ~ParallelDecodingReader() override;
+
+    //==============================================================================
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples) override;
+
+    void readMaxLevels (int64 startSample, int64 numSamples,
+                        Range<float>* results, int numChannelsToRead) override;
+
+    using AudioFormatReader::readMaxLevels;
+
+    AudioChannelSet getChannelLayout() override     { return channelLayout; }
+
+    //==============================================================================
+    /** Segment boundaries are placed on multiples of this many samples. */
+    static constexpr int64 segmentAlignment = 1152 * 4;
+
+private:
+    struct SegmentJob;
+    using SegmentDecoder = std::function<bool (AudioFormatReader*, size_t, Range<int64>)>;
+
+    ParallelDecodingReader (const ReaderFactory&, std::unique_ptr<AudioFormatReader>, ThreadPool&, int64);
+
+    std::vector<Range<int64>> getSegments (Range<int64> range) const;
+    bool decodeSegments (const std::vector<Range<int64>>& segments, const SegmentDecoder& decode);
+
+    std::unique_ptr<AudioFormatReader> takeReader();
+    void returnReader (std::unique_ptr<AudioFormatReader>);
+
+    ReaderFactory factory;
+    ThreadPool& pool;
+    const int64 minimumSegmentLength;
+    AudioChannelSet channelLayout;
+
+    CriticalSection readerLock;
+    std::vector<std::unique_ptr<AudioFormatReader>> idleReaders;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelDecodingReader)
+};
+
+} // namespace juce
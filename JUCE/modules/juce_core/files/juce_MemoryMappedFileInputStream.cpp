@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+MemoryMappedFileInputStream::MemoryMappedFileInputStream (const File& f)
+    : file (f),
+      map (f, MemoryMappedFile::readOnly),
+      isEmptyFile (map.getData() == nullptr && f.existsAsFile() && f.getSize() == 0)
+{
+}
+
+MemoryMappedFileInputStream::~MemoryMappedFileInputStream() = default;
+
+int64 MemoryMappedFileInputStream::getTotalLength()
+{
+    return (int64) map.getSize();
+}
+
+int MemoryMappedFileInputStream::read (void* buffer, int howMany)
+{
+    // The buffer should never be null, and a negative size is probably a
+    // sign that something is broken!
+    jassert (buffer != nullptr && howMany >= 0);
+
+    if (howMany <= 0 || position >= map.getSize())
+        return 0;
+
+    auto num = jmin ((size_t) howMany, map.getSize() - position);
+    memcpy (buffer, addBytesToPointer (map.getData(), position), num);
+    position += num;
+    return (int) num;
+}
+
+bool MemoryMappedFileInputStream::isExhausted()
+{
+    return position >= map.getSize();
+}
+
+int64 MemoryMappedFileInputStream::getPosition()
+{
+    return (int64) position;
+}
+
+bool MemoryMappedFileInputStream::setPosition (int64 pos)
+{
+    position = (size_t) jlimit ((int64) 0, (int64) map.getSize(), pos);
+    return true;
+}
+
+void MemoryMappedFileInputStream::skipNextBytes (int64 numBytesToSkip)
+{
+    if (numBytesToSkip > 0)
+        setPosition (getPosition() + numBytesToSkip);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MemoryMappedFileInputStreamTests final : public UnitTest
+{
+    MemoryMappedFileInputStreamTests()
+        : UnitTest ("MemoryMappedFileInputStream", UnitTestCategories::streams)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Open stream non-existent file");
+        {
+            auto tempFile = File::createTempFile (".txt");
+            expect (! tempFile.exists());
+
+            MemoryMappedFileInputStream stream (tempFile);
+            expect (stream.failedToOpen());
+        }
+
+        beginTest ("Open stream empty file");
+        {
+            TemporaryFile tempFile (".txt");
+            tempFile.getFile().create();
+
+            MemoryMappedFileInputStream stream (tempFile.getFile());
+            expect (stream.openedOk());
+            expectEquals (stream.getTotalLength(), (int64) 0);
+            expect (stream.isExhausted());
+
+            char c;
+            expectEquals (stream.read (&c, 1), 0);
+        }
+
+        beginTest ("Read and seek");
+        {
+            TemporaryFile tempFile (".bin");
+            auto random = getRandom();
+            MemoryBlock data (12345);
+
+            for (size_t i = 0; i < data.getSize(); ++i)
+                data[i] = (char) random.nextInt (256);
+
+            tempFile.getFile().replaceWithData (data.getData(), data.getSize());
+
+            MemoryMappedFileInputStream stream (tempFile.getFile());
+            expect (stream.openedOk());
+            expectEquals (stream.getTotalLength(), (int64) data.getSize());
+            expect (memcmp (stream.getData(), data.getData(), data.getSize()) == 0);
+
+            MemoryBlock buffer (data.getSize());
+            expectEquals (stream.read (buffer.getData(), 1000), 1000);
+            expectEquals (stream.getPosition(), (int64) 1000);
+            expect (memcmp (buffer.getData(), data.getData(), 1000) == 0);
+
+            expect (stream.setPosition (12000));
+            expectEquals (stream.read (buffer.getData(), 1000), 345);
+            expect (memcmp (buffer.getData(), addBytesToPointer (data.getData(), 12000), 345) == 0);
+            expect (stream.isExhausted());
+
+            stream.setPosition (10);
+            stream.skipNextBytes (90);
+            expectEquals (stream.getPosition(), (int64) 100);
+            expectEquals ((uint8) stream.readByte(), (uint8) data[100]);
+            expect (! stream.isExhausted());
+        }
+    }
+};
+
+static MemoryMappedFileInputStreamTests memoryMappedFileInputStreamTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An input stream that reads from a local file by mapping it into memory.
+
+    Reading from this stream copies data straight out of the OS's page cache, without
+    a system call for each read, and getData() allows the file's contents to be scanned
+    in place. This suits decoders that make many small reads and seeks, but note that
+    as with MemoryMappedFile, the behaviour is undefined if the file is truncated while
+    the stream exists.
+
+    @see InputStream, FileInputStream, MemoryMappedFile
+
+    @tags{Core}
+*/
+class JUCE_API  MemoryMappedFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a stream that maps the whole of the given file.
+
+        After creating the stream, you should use openedOk() or failedToOpen() to make
+        sure that it's OK before trying to read from it. It can fail if the file doesn't
+        exist, or if there isn't enough address space to map it.
+    */
+    explicit MemoryMappedFileInputStream (const File& fileToRead);
+
+    /** Destructor. */
+    ~MemoryMappedFileInputStream() override;
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return ! openedOk(); }
+
+    /** Returns true if the file was mapped without problems. */
+    bool openedOk() const noexcept                      { return map.getData() != nullptr || isEmptyFile; }
+
+    /** Returns a pointer to the file's contents. */
+    const void* getData() const noexcept                { return map.getData(); }
+
+    /** Returns the number of bytes of data that are mapped. */
+    size_t getDataSize() const noexcept                 { return map.getSize(); }
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int read (void*, int) override;
+    bool isExhausted() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    void skipNextBytes (int64) override;
+
+private:
+    //==============================================================================
+    const File file;
+    const MemoryMappedFile map;
+    const bool isEmptyFile;
+    size_t position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedFileInputStream)
+};
+
+} // namespace juce
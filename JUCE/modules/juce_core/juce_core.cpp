@@ -139,6 +139,7 @@
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
+#include "files/juce_MemoryMappedFileInputStream.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
@@ -321,6 +321,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_FileOutputStream.h"
 #include "files/juce_FileSearchPath.h"
 #include "files/juce_MemoryMappedFile.h"
+#include "files/juce_MemoryMappedFileInputStream.h"
 #include "files/juce_TemporaryFile.h"
 #include "files/juce_FileFilter.h"
 #include "files/juce_WildcardFileFilter.h"
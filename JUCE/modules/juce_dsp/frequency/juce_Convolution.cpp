@@ -152,12 +152,370 @@ ConvolutionMessageQueue::~ConvolutionMessageQueue() noexcept
 ConvolutionMessageQueue::ConvolutionMessageQueue (ConvolutionMessageQueue&&) noexcept = default;
 ConvolutionMessageQueue& ConvolutionMessageQueue::operator= (ConvolutionMessageQueue&&) noexcept = default;
 
+//==============================================================================
+// A counting semaphore. Unlike Thread::notify(), which locks the mutex of a WaitableEvent,
+// signalling it doesn't take a lock, so the audio thread can use it to wake the worker pool.
+class WakeSignal
+{
+public:
+   #if JUCE_MAC || JUCE_IOS
+    WakeSignal()                            : semaphore (dispatch_semaphore_create (0)) {}
+    ~WakeSignal()                           { dispatch_release (semaphore); }
+
+    void signal (int count) noexcept        { while (--count >= 0) dispatch_semaphore_signal (semaphore); }
+    void wait() noexcept                    { dispatch_semaphore_wait (semaphore, DISPATCH_TIME_FOREVER); }
+
+   private:
+    dispatch_semaphore_t semaphore;
+   #elif JUCE_WINDOWS
+    WakeSignal()                            : semaphore (CreateSemaphore (nullptr, 0, std::numeric_limits<LONG>::max(), nullptr)) {}
+    ~WakeSignal()                           { CloseHandle (semaphore); }
+
+    void signal (int count) noexcept        { ReleaseSemaphore (semaphore, (LONG) count, nullptr); }
+    void wait() noexcept                    { WaitForSingleObject (semaphore, INFINITE); }
+
+   private:
+    HANDLE semaphore;
+   #else
+    WakeSignal()                            { sem_init (&semaphore, 0, 0); }
+    ~WakeSignal()                           { sem_destroy (&semaphore); }
+
+    void signal (int count) noexcept        { while (--count >= 0) sem_post (&semaphore); }
+
+    void wait() noexcept
+    {
+        while (sem_wait (&semaphore) != 0 && errno == EINTR) {}
+    }
+
+   private:
+    sem_t semaphore;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (WakeSignal)
+};
+
+class WorkerPool;
+
+// A set of jobs that is run again every block, by the calling thread and any
+// threads of a worker pool that are free to help.
+class ParallelJobs
+{
+public:
+    ParallelJobs (WorkerPool& poolIn, std::function<void (int)> jobIn);
+    ~ParallelJobs();
+
+    // Runs job (i) for every i in [0, numJobs), and returns once all of them have finished.
+    // Called on the audio thread.
+    void run (int numJobs) noexcept;
+
+    bool hasUnclaimedJob() const noexcept
+    {
+        const auto current = state.load (std::memory_order_acquire);
+        return (current & 0xffff) < ((current >> 16) & 0xffff);
+    }
+
+    // Runs one job that no other thread has started yet. Returns false if there is none.
+    bool tryRunJob() noexcept
+    {
+        auto current = state.load (std::memory_order_acquire);
+
+        // The state packs the number of the run, the number of jobs and the next job to
+        // claim into one value, so a thread that read it during an earlier run can't claim
+        // a job from the current one
+        for (;;)
+        {
+            const auto index = (int) (current & 0xffff);
+
+            if (index >= (int) ((current >> 16) & 0xffff))
+                return false;
+
+            if (state.compare_exchange_weak (current, current + 1, std::memory_order_acq_rel))
+            {
+                job (index);
+                numFinished.fetch_add (1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+private:
+    WorkerPool& pool;
+    const std::function<void (int)> job;
+
+    std::atomic<uint64> state { 0 };
+    std::atomic<int> numFinished { 0 };
+    uint64 numRuns = 0;
+
+    // Only used by the audio thread
+    int64 ticksPerJob = 0;
+    int numRunsWithoutPool = 0;
+};
+
+class WorkerPool
+{
+public:
+    explicit WorkerPool (int numThreads)
+    {
+        for (int i = 0; i < numThreads; ++i)
+        {
+            auto& worker = *workers.emplace_back (std::make_unique<Worker> (*this));
+
+            if (! worker.startRealtimeThread (Thread::RealtimeOptions{}))
+                worker.startThread (Thread::Priority::highest);
+        }
+    }
+
+    ~WorkerPool()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        wakeSignal.signal ((int) workers.size());
+
+        for (auto& worker : workers)
+            worker->stopThread (-1);
+    }
+
+    void addJobs (ParallelJobs* jobs)
+    {
+        const ScopedWriteLock lock (jobsLock);
+        allJobs.push_back (jobs);
+    }
+
+    // Waits for the workers to finish any job of this set that they are running
+    void removeJobs (ParallelJobs* jobs)
+    {
+        const ScopedWriteLock lock (jobsLock);
+        allJobs.erase (std::remove (allJobs.begin(), allJobs.end(), jobs), allJobs.end());
+    }
+
+    // Wakes up to the given number of idle workers, without locking
+    void wakeWorkers (int maxNumToWake) noexcept
+    {
+        // Pairs with the fence in waitForJobs(): either this sees the worker as idle, or the
+        // worker sees the jobs that were published before calling this
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        const auto numToWake = jmin (maxNumToWake, numIdle.load (std::memory_order_relaxed));
+
+        if (numToWake > 0)
+            wakeSignal.signal (numToWake);
+    }
+
+    int getNumThreads() const noexcept    { return (int) workers.size(); }
+
+private:
+    class Worker  : public Thread
+    {
+    public:
+        explicit Worker (WorkerPool& poolIn)
+            : Thread ("Convolution worker"), pool (poolIn) {}
+
+        void run() override
+        {
+            const ScopedNoDenormals noDenormals;
+
+            while (! threadShouldExit())
+                if (! pool.runAvailableJobs())
+                    pool.waitForJobs();
+        }
+
+    private:
+        WorkerPool& pool;
+    };
+
+    bool runAvailableJobs()
+    {
+        const ScopedReadLock lock (jobsLock);
+        auto ranAny = false;
+
+        for (auto* jobs : allJobs)
+            while (jobs->tryRunJob())
+                ranAny = true;
+
+        return ranAny;
+    }
+
+    bool hasAvailableJobs()
+    {
+        const ScopedReadLock lock (jobsLock);
+        return std::any_of (allJobs.begin(), allJobs.end(), [] (auto* jobs) { return jobs->hasUnclaimedJob(); });
+    }
+
+    void waitForJobs()
+    {
+        numIdle.fetch_add (1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        if (! hasAvailableJobs())
+            wakeSignal.wait();
+
+        numIdle.fetch_sub (1, std::memory_order_relaxed);
+    }
+
+    ReadWriteLock jobsLock;
+    std::vector<ParallelJobs*> allJobs;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    WakeSignal wakeSignal;
+    std::atomic<int> numIdle { 0 };
+};
+
+struct ConvolutionWorkerPool::Impl  : public WorkerPool
+{
+    using WorkerPool::WorkerPool;
+};
+
+ParallelJobs::ParallelJobs (WorkerPool& poolIn, std::function<void (int)> jobIn)
+    : pool (poolIn), job (std::move (jobIn))
+{
+    pool.addJobs (this);
+}
+
+ParallelJobs::~ParallelJobs()
+{
+    pool.removeJobs (this);
+}
+
+void ParallelJobs::run (int newNumJobs) noexcept
+{
+    jassert (isPositiveAndBelow (newNumJobs, 0x10000));
+
+    // A worker was too slow to finish its job recently, so give it some time to catch up
+    if (numRunsWithoutPool > 0)
+    {
+        --numRunsWithoutPool;
+
+        for (int i = 0; i < newNumJobs; ++i)
+            job (i);
+
+        return;
+    }
+
+    numFinished.store (0, std::memory_order_relaxed);
+    state.store ((++numRuns << 32) | ((uint64) newNumJobs << 16), std::memory_order_release);
+
+    pool.wakeWorkers (newNumJobs - 1);
+
+    // Don't wait for the workers to wake up: whatever they haven't claimed by the time
+    // the audio thread gets to it is done here, so late workers only cost a wake-up
+    const auto startTicks = Time::getHighResolutionTicks();
+    auto numRunHere = 0;
+
+    while (tryRunJob())
+        ++numRunHere;
+
+    const auto finishedTicks = Time::getHighResolutionTicks();
+
+    if (numRunHere > 0)
+        ticksPerJob = (finishedTicks - startTicks) / numRunHere;
+
+    // The jobs left have been started by a worker, and can't be taken back. If one takes much
+    // longer than a job takes here, the worker has probably been preempted, so the next blocks
+    // run all their jobs inline rather than risk waiting on it again.
+    constexpr auto numRunsToSkipAfterLateJob = 64;
+    const auto deadline = finishedTicks + jmax (2 * ticksPerJob, Time::secondsToHighResolutionTicks (50.0e-6));
+    auto isLate = false;
+
+    while (numFinished.load (std::memory_order_acquire) < newNumJobs)
+    {
+        isLate = isLate || Time::getHighResolutionTicks() > deadline;
+        Thread::yield();
+    }
+
+    if (isLate)
+        numRunsWithoutPool = numRunsToSkipAfterLateJob;
+}
+
+ConvolutionWorkerPool::ConvolutionWorkerPool (int numThreads)
+    : pimpl (std::make_unique<Impl> (numThreads))
+{}
+
+ConvolutionWorkerPool::~ConvolutionWorkerPool() noexcept = default;
+
+int ConvolutionWorkerPool::getNumThreads() const noexcept    { return pimpl->getNumThreads(); }
+
+//==============================================================================
+// Impulse response partitions that have already been transformed, shared read-only
+// between every engine in the process that convolves with the same samples at the
+// same sample rate and with the same partitioning. Entries only live as long as an
+// engine is using them.
+class ImpulseSegmentCache
+{
+public:
+    using Segments = std::vector<AudioBuffer<float>>;
+
+    struct Key
+    {
+        Key (const float* samples, size_t numSamplesIn, double sampleRateIn, size_t blockSizeIn, size_t fftSizeIn)
+            : numSamples (numSamplesIn), sampleRate (sampleRateIn), blockSize (blockSizeIn), fftSize (fftSizeIn)
+        {
+            // Two independent 64-bit hashes of the sample bits, so that a collision is out of the question
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                uint32 bits;
+                std::memcpy (&bits, samples + i, sizeof (bits));
+
+                hash1 = (hash1 ^ bits) * 0x100000001b3ull;
+                hash2 = ((hash2 ^ bits) * 0xff51afd7ed558ccdull) + (hash2 >> 29);
+            }
+        }
+
+        auto tie() const { return std::tie (hash1, hash2, numSamples, sampleRate, blockSize, fftSize); }
+        bool operator< (const Key& other) const { return tie() < other.tie(); }
+
+        uint64 hash1 = 0xcbf29ce484222325ull, hash2 = 0x9e3779b97f4a7c15ull;
+        size_t numSamples;
+        double sampleRate;
+        size_t blockSize, fftSize;
+    };
+
+    template <typename MakeSegments>
+    std::shared_ptr<const Segments> get (const Key& key, MakeSegments&& makeSegments)
+    {
+        {
+            const std::lock_guard<std::mutex> lock (mutex);
+
+            for (auto it = entries.begin(); it != entries.end();)
+                it = it->second.expired() ? entries.erase (it) : std::next (it);
+
+            if (const auto it = entries.find (key); it != entries.end())
+                if (auto segments = it->second.lock())
+                    return segments;
+        }
+
+        // Transforming is slow, so it's done without holding the lock. If another engine
+        // got there first in the meantime, its copy wins.
+        auto segments = std::make_shared<const Segments> (makeSegments());
+
+        const std::lock_guard<std::mutex> lock (mutex);
+        auto& entry = entries[key];
+
+        if (auto existing = entry.lock())
+            return existing;
+
+        entry = segments;
+        return segments;
+    }
+
+    size_t getNumEntries() const
+    {
+        const std::lock_guard<std::mutex> lock (mutex);
+        return (size_t) std::count_if (entries.begin(), entries.end(), [] (const auto& entry) { return ! entry.second.expired(); });
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<Key, std::weak_ptr<const Segments>> entries;
+};
+
 //==============================================================================
 struct ConvolutionEngine
 {
     ConvolutionEngine (const float* samples,
                        size_t numSamples,
-                       size_t maxBlockSize)
+                       size_t maxBlockSize,
+                       double sampleRate)
         : blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
           fftSize (blockSize > 128 ? 2 * blockSize : 4 * blockSize),
           fftObject (std::make_unique<FFT> (roundToInt (std::log2 (fftSize)))),
@@ -170,44 +528,37 @@ struct ConvolutionEngine
     {
         bufferOutput.clear();
 
-        auto updateSegmentsIfNecessary = [this] (size_t numSegmentsToUpdate,
-                                                 std::vector<AudioBuffer<float>>& segments)
-        {
-            if (numSegmentsToUpdate == 0
-                || numSegmentsToUpdate != (size_t) segments.size()
-                || (size_t) segments[0].getNumSamples() != fftSize * 2)
-            {
-                segments.clear();
-
-                for (size_t i = 0; i < numSegmentsToUpdate; ++i)
-                    segments.push_back ({ 1, static_cast<int> (fftSize * 2) });
-            }
-        };
+        for (size_t i = 0; i < numInputSegments; ++i)
+            buffersInputSegments.push_back ({ 1, static_cast<int> (fftSize * 2) });
 
-        updateSegmentsIfNecessary (numInputSegments, buffersInputSegments);
-        updateSegmentsIfNecessary (numSegments,      buffersImpulseSegments);
+        impulseSegments = impulseSegmentCache->get ({ samples, numSamples, sampleRate, blockSize, fftSize }, [&]
+        {
+            ImpulseSegmentCache::Segments segments;
+            auto FFTTempObject = std::make_unique<FFT> (roundToInt (std::log2 (fftSize)));
+            size_t currentPtr = 0;
 
-        auto FFTTempObject = std::make_unique<FFT> (roundToInt (std::log2 (fftSize)));
-        size_t currentPtr = 0;
+            for (size_t i = 0; i < numSegments; ++i)
+            {
+                auto& buf = segments.emplace_back (1, static_cast<int> (fftSize * 2));
+                buf.clear();
 
-        for (auto& buf : buffersImpulseSegments)
-        {
-            buf.clear();
+                auto* impulseResponse = buf.getWritePointer (0);
 
-            auto* impulseResponse = buf.getWritePointer (0);
+                if (i == 0)
+                    impulseResponse[0] = 1.0f;
 
-            if (&buf == &buffersImpulseSegments.front())
-                impulseResponse[0] = 1.0f;
+                FloatVectorOperations::copy (impulseResponse,
+                                             samples + currentPtr,
+                                             static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
 
-            FloatVectorOperations::copy (impulseResponse,
-                                         samples + currentPtr,
-                                         static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
+                FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
+                prepareForConvolution (impulseResponse);
 
-            FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
-            prepareForConvolution (impulseResponse);
+                currentPtr += (fftSize - blockSize);
+            }
 
-            currentPtr += (fftSize - blockSize);
-        }
+            return segments;
+        });
 
         reset();
     }
@@ -266,7 +617,7 @@ struct ConvolutionEngine
                         index -= numInputSegments;
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
+                                                        (*impulseSegments)[i].getReadPointer (0),
                                                         outputTempData);
                 }
             }
@@ -274,7 +625,7 @@ struct ConvolutionEngine
             FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
             convolutionProcessingAndAccumulate (inputSegmentData,
-                                                buffersImpulseSegments.front().getWritePointer (0),
+                                                impulseSegments->front().getReadPointer (0),
                                                 outputData);
 
             updateSymmetricFrequencyDomainData (outputData);
@@ -306,6 +657,63 @@ struct ConvolutionEngine
         }
     }
 
+    // The same work as processSamples() for exactly one whole block, split into steps so that it
+    // can be spread out over time: the forward transform, one step for each further impulse
+    // segment, and finally the inverse transform. The steps must be run in order, with the same
+    // input and output, and only by a caller that always processes whole blocks.
+    size_t getNumBlockSteps() const noexcept    { return numSegments + 1; }
+
+    void processBlockStep (const float* input, float* output, size_t step)
+    {
+        jassert (inputDataPos == 0 && step < getNumBlockSteps());
+
+        auto* inputData      = bufferInput.getWritePointer (0);
+        auto* outputTempData = bufferTempOutput.getWritePointer (0);
+        auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer (0);
+
+        if (step == 0)
+        {
+            FloatVectorOperations::copy (inputData, input, static_cast<int> (blockSize));
+            FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
+
+            fftObject->performRealOnlyForwardTransform (inputSegmentData);
+            prepareForConvolution (inputSegmentData);
+
+            FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+            return;
+        }
+
+        if (step < numSegments)
+        {
+            const auto index = (currentSegment + step * (numInputSegments / numSegments)) % numInputSegments;
+
+            convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
+                                                (*impulseSegments)[step].getReadPointer (0),
+                                                outputTempData);
+            return;
+        }
+
+        auto* outputData  = bufferOutput.getWritePointer (0);
+        auto* overlapData = bufferOverlap.getWritePointer (0);
+
+        FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+
+        convolutionProcessingAndAccumulate (inputSegmentData,
+                                            impulseSegments->front().getReadPointer (0),
+                                            outputData);
+
+        updateSymmetricFrequencyDomainData (outputData);
+        fftObject->performRealOnlyInverseTransform (outputData);
+
+        FloatVectorOperations::add (output, outputData, overlapData, static_cast<int> (blockSize));
+
+        FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+        FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+        FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+
+        currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
+    }
+
     void processSamplesWithAddedLatency (const float* input, float* output, size_t numSamples)
     {
         // Overlap-add, zero latency convolution algorithm with uniform partitioning
@@ -352,14 +760,14 @@ struct ConvolutionEngine
                         index -= numInputSegments;
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
+                                                        (*impulseSegments)[i].getReadPointer (0),
                                                         outputTempData);
                 }
 
                 FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
                 convolutionProcessingAndAccumulate (inputSegmentData,
-                                                    buffersImpulseSegments.front().getWritePointer (0),
+                                                    impulseSegments->front().getReadPointer (0),
                                                     outputData);
 
                 updateSymmetricFrequencyDomainData (outputData);
@@ -443,9 +851,353 @@ struct ConvolutionEngine
     size_t currentSegment = 0, inputDataPos = 0;
 
     AudioBuffer<float> bufferInput, bufferOutput, bufferTempOutput, bufferOverlap;
-    std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
+    std::vector<AudioBuffer<float>> buffersInputSegments;
+
+    SharedResourcePointer<ImpulseSegmentCache> impulseSegmentCache;
+    std::shared_ptr<const ImpulseSegmentCache::Segments> impulseSegments;
 };
 
+//==============================================================================
+class TailStage;
+
+// Runs the blocks of the tail stages of every convolution in the process on one
+// background thread, always picking the block whose deadline is closest.
+class TailWorker : private Thread
+{
+public:
+    TailWorker()
+        : Thread ("Convolution tail worker")
+    {
+        if (! startRealtimeThread (Thread::RealtimeOptions{}))
+            startThread (Priority::highest);
+    }
+
+    ~TailWorker() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (-1);
+    }
+
+    // The worker only holds on to a stage while it is processing one of its blocks, so a
+    // stage can be deleted from any thread, without waiting for the worker
+    void addStage (std::weak_ptr<TailStage> stage)
+    {
+        const ScopedLock lock (stagesMutex);
+        stages.push_back (std::move (stage));
+    }
+
+    // Wakes the worker up, after a stage has queued a block
+    using Thread::notify;
+
+private:
+    void run() override;
+    bool processMostUrgentBlock();
+
+    CriticalSection stagesMutex;
+    std::vector<std::weak_ptr<TailStage>> stages;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TailWorker)
+};
+
+// Convolves with the part of an impulse response starting `offset` samples in, using
+// partitions that are too large to process on the audio thread.
+//
+// Every time a partition's worth of input has arrived, it's queued for the worker. The
+// result isn't needed until the input has advanced by `offset - partitionSize` further
+// samples. If the worker hasn't started on a block half a partition before then, the
+// audio thread takes it over and does it a step at a time, spread over the callbacks
+// that remain, so the output never depends on the timing and no single callback pays
+// for a whole partition.
+class TailStage
+{
+public:
+    TailStage (const float* samples,
+               size_t numSamples,
+               size_t partitionSizeIn,
+               size_t offsetIn,
+               double sampleRate,
+               TailWorker& workerIn)
+        : engine (samples, numSamples, partitionSizeIn, sampleRate),
+          worker (workerIn),
+          partitionSize (partitionSizeIn),
+          offset (offsetIn),
+          handOverSamples ((int64) partitionSize / 2),
+          slackTicks (Time::secondsToHighResolutionTicks ((double) ((int64) (offset - partitionSize) - handOverSamples) / sampleRate)),
+          numSteps (engine.getNumBlockSteps()),
+          numSlots ((int64) (offset / partitionSize) + 2),
+          inputSlots  ((int) numSlots, (int) partitionSize),
+          outputSlots ((int) numSlots, (int) partitionSize),
+          queuedTicks ((size_t) numSlots)
+    {
+        // A block is queued once its input is complete, and needed from then on after
+        // another offset - partitionSize samples
+        jassert (offset >= 2 * partitionSize);
+
+        inputSlots.clear();
+        outputSlots.clear();
+    }
+
+    // Must not be called concurrently with process()
+    void reset() noexcept
+    {
+        // A block that the audio thread had taken over is simply dropped
+        if (std::exchange (ownsBlock, false))
+            processing.store (false, std::memory_order_release);
+
+        const ScopedProcessingLock lock (*this);
+
+        engine.reset();
+        inputSlots.clear();
+        outputSlots.clear();
+
+        time = 0;
+        stepsDone = 0;
+        numQueued = 0;
+        numProcessed = 0;
+    }
+
+    // Adds the stage's output to the output block. Called on the audio thread.
+    void process (const float* input, float* output, size_t numSamples) noexcept
+    {
+        for (size_t done = 0; done < numSamples;)
+        {
+            const auto position = (size_t) (time % (int64) partitionSize);
+            const auto num = jmin (numSamples - done, partitionSize - position);
+
+            if (time >= (int64) offset)
+            {
+                const auto block = (time - (int64) offset) / (int64) partitionSize;
+                waitForBlock (block);
+
+                FloatVectorOperations::add (output + done,
+                                            outputSlots.getReadPointer (slotFor (block), (int) position),
+                                            (int) num);
+            }
+
+            const auto queued = numQueued.load (std::memory_order_relaxed);
+
+            FloatVectorOperations::copy (inputSlots.getWritePointer (slotFor (queued), (int) position),
+                                         input + done,
+                                         (int) num);
+
+            time += (int64) num;
+            done += num;
+
+            if (position + num == partitionSize)
+            {
+                queuedTicks[(size_t) slotFor (queued)] = Time::getHighResolutionTicks();
+                numQueued.store (queued + 1, std::memory_order_release);
+                worker.notify();
+            }
+        }
+
+        stepHandedOverBlock();
+    }
+
+    // The time by which the worker should start on the next queued block, or nullopt if no
+    // block is waiting for it
+    std::optional<int64> getNextDeadline() const noexcept
+    {
+        // Only the audio thread can be holding this while the worker asks
+        if (processing.load (std::memory_order_acquire))
+            return {};
+
+        const auto next = numProcessed.load (std::memory_order_acquire);
+
+        if (next >= numQueued.load (std::memory_order_acquire))
+            return {};
+
+        return queuedTicks[(size_t) slotFor (next)] + slackTicks;
+    }
+
+    // Processes the next queued block in one go. Called on the worker thread.
+    void processNextBlock() noexcept
+    {
+        if (processing.exchange (true, std::memory_order_acquire))
+            return;
+
+        const auto next = numProcessed.load (std::memory_order_relaxed);
+
+        if (next < numQueued.load (std::memory_order_acquire))
+        {
+            for (size_t step = 0; step < numSteps; ++step)
+                engine.processBlockStep (inputSlots.getReadPointer (slotFor (next)),
+                                         outputSlots.getWritePointer (slotFor (next)),
+                                         step);
+
+            numProcessed.store (next + 1, std::memory_order_release);
+        }
+
+        processing.store (false, std::memory_order_release);
+    }
+
+private:
+    struct ScopedProcessingLock
+    {
+        explicit ScopedProcessingLock (TailStage& s) noexcept
+            : stage (s)
+        {
+            while (stage.processing.exchange (true, std::memory_order_acquire))
+                Thread::yield();
+        }
+
+        ~ScopedProcessingLock() noexcept
+        {
+            stage.processing.store (false, std::memory_order_release);
+        }
+
+        TailStage& stage;
+    };
+
+    int slotFor (int64 block) const noexcept        { return (int) (block % numSlots); }
+    int64 getNeededTime (int64 block) const noexcept { return (int64) offset + block * (int64) partitionSize; }
+
+    // The rest of this is only ever called on the audio thread
+
+    void waitForBlock (int64 block) noexcept
+    {
+        while (numProcessed.load (std::memory_order_acquire) <= block)
+        {
+            if (ownsBlock || tryToTakeOver())
+                runSteps (block, numSteps);
+            else
+                Thread::yield(); // The worker started on this block at least half a partition ago
+        }
+    }
+
+    // Takes over the next block if it's due within half a partition and the worker hasn't
+    // started it yet, and then keeps up a pace that finishes it just as it is needed
+    void stepHandedOverBlock() noexcept
+    {
+        if (! ownsBlock)
+        {
+            const auto next = numProcessed.load (std::memory_order_acquire);
+
+            if (next >= numQueued.load (std::memory_order_relaxed)
+                || getNeededTime (next) - time > handOverSamples
+                || ! tryToTakeOver())
+                return;
+        }
+
+        const auto next = numProcessed.load (std::memory_order_relaxed);
+        const auto remaining = jmax ((int64) 0, getNeededTime (next) - time);
+
+        if (remaining > handOverSamples)
+        {
+            // The worker finished that block just before it was taken over
+            release();
+            return;
+        }
+
+        runSteps (next, numSteps - (size_t) ((int64) numSteps * remaining / handOverSamples));
+    }
+
+    bool tryToTakeOver() noexcept
+    {
+        if (processing.exchange (true, std::memory_order_acquire))
+            return false;
+
+        ownsBlock = true;
+        stepsDone = 0;
+        return true;
+    }
+
+    void runSteps (int64 block, size_t targetSteps) noexcept
+    {
+        if (numProcessed.load (std::memory_order_relaxed) != block)
+        {
+            release();
+            return;
+        }
+
+        for (; stepsDone < targetSteps; ++stepsDone)
+            engine.processBlockStep (inputSlots.getReadPointer (slotFor (block)),
+                                     outputSlots.getWritePointer (slotFor (block)),
+                                     stepsDone);
+
+        if (stepsDone == numSteps)
+        {
+            numProcessed.store (block + 1, std::memory_order_release);
+            release();
+        }
+    }
+
+    void release() noexcept
+    {
+        ownsBlock = false;
+        stepsDone = 0;
+        processing.store (false, std::memory_order_release);
+    }
+
+    ConvolutionEngine engine;
+    TailWorker& worker;
+
+    const size_t partitionSize;
+    const size_t offset;
+    const int64 handOverSamples;
+    const int64 slackTicks;
+    const size_t numSteps;
+
+    // Enough slots that a block's output is still there until the audio thread has read it
+    // all, and its input isn't overwritten before the deadline forces it to be processed
+    const int64 numSlots;
+    AudioBuffer<float> inputSlots, outputSlots;
+    std::vector<int64> queuedTicks;
+
+    int64 time = 0;
+    std::atomic<int64> numQueued { 0 }, numProcessed { 0 };
+    std::atomic<bool> processing { false };
+
+    // Whether the audio thread has taken over the next block, and how far it has got
+    bool ownsBlock = false;
+    size_t stepsDone = 0;
+};
+
+void TailWorker::run()
+{
+    const ScopedNoDenormals noDenormals;
+
+    while (! threadShouldExit())
+        if (! processMostUrgentBlock())
+            wait (10);
+}
+
+bool TailWorker::processMostUrgentBlock()
+{
+    std::shared_ptr<TailStage> mostUrgent;
+
+    {
+        const ScopedLock lock (stagesMutex);
+
+        stages.erase (std::remove_if (stages.begin(), stages.end(), [] (const auto& s) { return s.expired(); }),
+                      stages.end());
+
+        auto earliest = std::numeric_limits<int64>::max();
+
+        for (const auto& weakStage : stages)
+        {
+            if (auto stage = weakStage.lock())
+            {
+                if (const auto deadline = stage->getNextDeadline(); deadline.has_value() && *deadline < earliest)
+                {
+                    mostUrgent = std::move (stage);
+                    earliest = *deadline;
+                }
+            }
+        }
+    }
+
+    if (mostUrgent == nullptr)
+        return false;
+
+    // The stage is kept alive by mostUrgent rather than by the lock, so nobody waits on
+    // the lock for the length of a partition. If it was deleted meanwhile, this is where
+    // it goes away.
+    mostUrgent->processNextBlock();
+    return true;
+}
+
 //==============================================================================
 class MultichannelEngine
 {
@@ -454,8 +1206,10 @@ public:
                         int maxBlockSize,
                         int maxBufferSize,
                         Convolution::NonUniform headSizeIn,
-                        bool isZeroDelayIn)
-        : tailBuffer (1, maxBlockSize),
+                        bool isZeroDelayIn,
+                        double sampleRate,
+                        WorkerPool* pool)
+        : tailBuffer (2, maxBlockSize),
           latency (isZeroDelayIn ? 0 : maxBufferSize),
           irSize (buf.getNumSamples()),
           blockSize (maxBlockSize),
@@ -467,10 +1221,47 @@ public:
         {
             return std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
                                                         length,
-                                                        static_cast<size_t> (thisBlockSize));
+                                                        static_cast<size_t> (thisBlockSize),
+                                                        sampleRate);
         };
 
-        if (headSizeIn.headSizeInSamples == 0)
+        // Zero-latency convolutions with long IRs only process a short head on the audio thread,
+        // and hand the rest to tail stages whose partitions grow four times larger each time
+        auto partitionSize = jmax (256, 4 * nextPowerOfTwo (maxBlockSize));
+        const auto headLength = 2 * partitionSize;
+
+        if (headSizeIn.headSizeInSamples == 0 && isZeroDelay && irSize > headLength)
+        {
+            constexpr auto maxPartitionSize = 16384;
+
+            for (int i = 0; i < numChannels; ++i)
+                head.emplace_back (makeEngine (i, 0, headLength, static_cast<uint32> (maxBufferSize)));
+
+            worker.emplace();
+            stages.resize ((size_t) numChannels);
+
+            for (auto offset = headLength; offset < irSize; partitionSize *= 4)
+            {
+                // Each stage needs to start at least two of its partitions in, so the next one
+                // can start where this one's span of six partitions ends
+                const auto end = partitionSize >= maxPartitionSize ? irSize : jmin (irSize, 4 * offset);
+
+                for (int i = 0; i < numChannels; ++i)
+                {
+                    auto stage = std::make_shared<TailStage> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, i), offset),
+                                                              static_cast<size_t> (end - offset),
+                                                              static_cast<size_t> (partitionSize),
+                                                              static_cast<size_t> (offset),
+                                                              sampleRate,
+                                                              **worker);
+                    (*worker)->addStage (stage);
+                    stages[(size_t) i].push_back (std::move (stage));
+                }
+
+                offset = end;
+            }
+        }
+        else if (headSizeIn.headSizeInSamples == 0)
         {
             for (int i = 0; i < numChannels; ++i)
                 head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<uint32> (maxBufferSize)));
@@ -488,6 +1279,9 @@ public:
                 for (int i = 0; i < numChannels; ++i)
                     tail.emplace_back (makeEngine (i, size, buf.getNumSamples() - size, tailBufferSize));
         }
+
+        if (pool != nullptr)
+            parallelJobs.emplace (*pool, [this] (int channel) { processChannel ((size_t) channel); });
     }
 
     void reset()
@@ -497,6 +1291,10 @@ public:
 
         for (const auto& e : tail)
             e->reset();
+
+        for (const auto& channelStages : stages)
+            for (const auto& stage : channelStages)
+                stage->reset();
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
@@ -504,29 +1302,18 @@ public:
         const auto numChannels = jmin (head.size(), input.getNumChannels(), output.getNumChannels());
         const auto numSamples  = jmin (input.getNumSamples(), output.getNumSamples());
 
-        const AudioBlock<float> fullTailBlock (tailBuffer);
-        const auto tailBlock = fullTailBlock.getSubBlock (0, (size_t) numSamples);
-
-        const auto isUniform = tail.empty();
+        currentInput  = input.getSubBlock (0, numSamples);
+        currentOutput = output.getSubBlock (0, numSamples);
 
-        for (size_t channel = 0; channel < numChannels; ++channel)
+        // The channels share nothing, so they can go to the worker pool as separate jobs
+        if (parallelJobs.has_value() && numChannels > 1)
         {
-            if (! isUniform)
-                tail[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               tailBlock.getChannelPointer (0),
-                                                               numSamples);
-
-            if (isZeroDelay)
-                head[channel]->processSamples (input.getChannelPointer (channel),
-                                               output.getChannelPointer (channel),
-                                               numSamples);
-            else
-                head[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               output.getChannelPointer (channel),
-                                                               numSamples);
-
-            if (! isUniform)
-                output.getSingleChannelBlock (channel) += tailBlock;
+            parallelJobs->run ((int) numChannels);
+        }
+        else
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+                processChannel (channel);
         }
 
         const auto numOutputChannels = output.getNumChannels();
@@ -540,13 +1327,53 @@ public:
     int getBlockSize() const noexcept  { return blockSize; }
 
 private:
+    void processChannel (size_t channel) noexcept
+    {
+        const auto numSamples = currentInput.getNumSamples();
+        const auto* input = currentInput.getChannelPointer (channel);
+        auto* output = currentOutput.getChannelPointer (channel);
+
+        const auto tailBlock = fullTailBlock.getSubsetChannelBlock (channel, 1).getSubBlock (0, numSamples);
+
+        const auto isUniform = tail.empty() && stages.empty();
+
+        if (! stages.empty())
+        {
+            tailBlock.clear();
+
+            for (const auto& stage : stages[channel])
+                stage->process (input, tailBlock.getChannelPointer (0), numSamples);
+        }
+        else if (! isUniform)
+            tail[channel]->processSamplesWithAddedLatency (input, tailBlock.getChannelPointer (0), numSamples);
+
+        if (isZeroDelay)
+            head[channel]->processSamples (input, output, numSamples);
+        else
+            head[channel]->processSamplesWithAddedLatency (input, output, numSamples);
+
+        if (! isUniform)
+            currentOutput.getSingleChannelBlock (channel) += tailBlock;
+    }
+
     std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
+    std::optional<SharedResourcePointer<TailWorker>> worker;
+    std::vector<std::vector<std::shared_ptr<TailStage>>> stages;
     AudioBuffer<float> tailBuffer;
 
+    // Taken once up front, since getting the buffer's write pointers on two threads at once is a race
+    const AudioBlock<float> fullTailBlock { tailBuffer };
+
     const int latency;
     const int irSize;
     const int blockSize;
     const bool isZeroDelay;
+
+    AudioBlock<const float> currentInput;
+    AudioBlock<float> currentOutput;
+
+    // Declared last, so that the pool has stopped running this engine's jobs before anything else goes
+    std::optional<ParallelJobs> parallelJobs;
 };
 
 static AudioBuffer<float> fixNumChannels (const AudioBuffer<float>& buf, Convolution::Stereo stereo)
@@ -774,6 +1601,16 @@ public:
         engine.set (makeEngine());
     }
 
+    // It is safe to call this method simultaneously with other public
+    // member functions.
+    void setWorkerPool (WorkerPool* pool)
+    {
+        const std::lock_guard<std::mutex> lock (mutex);
+        workerPool = pool;
+
+        engine.set (makeEngine());
+    }
+
     // Returns the most recently-created engine, or nullptr
     // if there is no pending engine, or if the engine is currently
     // being updated by one of the setter methods.
@@ -799,7 +1636,9 @@ private:
                                                      processSpec.maximumBlockSize,
                                                      maxBufferSize,
                                                      headSize,
-                                                     shouldBeZeroLatency);
+                                                     shouldBeZeroLatency,
+                                                     processSpec.sampleRate,
+                                                     workerPool);
     }
 
     static AudioBuffer<float> makeImpulseBuffer()
@@ -813,6 +1652,7 @@ private:
     AudioBuffer<float> impulseResponse = makeImpulseBuffer();
     double originalSampleRate = processSpec.sampleRate;
     Convolution::Normalise wantsNormalise = Convolution::Normalise::no;
+    WorkerPool* workerPool = nullptr;
     const Convolution::Latency latency;
     const Convolution::NonUniform headSize;
     const bool shouldBeZeroLatency;
@@ -897,6 +1737,11 @@ public:
         });
     }
 
+    void setWorkerPool (WorkerPool* pool)
+    {
+        callLater ([pool] (ConvolutionEngineFactory& f) { f.setWorkerPool (pool); });
+    }
+
     void prepare (const ProcessSpec& spec)
     {
         factory.setProcessSpec (spec);
@@ -1107,6 +1952,11 @@ public:
         engineQueue->loadImpulseResponse (fileImpulseResponse, stereo, trim, size, normalise);
     }
 
+    void setWorkerPool (ConvolutionWorkerPool* pool)
+    {
+        engineQueue->setWorkerPool (pool != nullptr ? pool->pimpl.get() : nullptr);
+    }
+
 private:
     void destroyPreviousEngine()
     {
@@ -1267,6 +2117,11 @@ void Convolution::loadImpulseResponse (AudioBuffer<float>&& buffer,
     pimpl->loadImpulseResponse (std::move (buffer), originalSampleRate, stereo, trim, normalise);
 }
 
+void Convolution::setWorkerPool (ConvolutionWorkerPool* pool)
+{
+    pimpl->setWorkerPool (pool);
+}
+
 void Convolution::prepare (const ProcessSpec& spec)
 {
     mixer.prepare (spec);
@@ -76,6 +76,48 @@ private:
     friend class Convolution;
 };
 
+/**
+    A pool of threads that Convolutions can use to process their channels in
+    parallel.
+
+    Each block, the channels of a Convolution using the pool are handed out to
+    whichever of the pool's threads are free, and the audio thread takes on any
+    channels that no thread has picked up yet. The audio thread never waits for
+    a thread that hasn't started work, so if the pool's threads are busy or
+    late, processing simply carries on as if there were no pool. If a thread
+    takes much longer to finish a channel than the audio thread would, the
+    next blocks are processed without the pool while it catches up.
+
+    May be shared between multiple Convolution instances.
+
+    @see Convolution::setWorkerPool
+
+    @tags{DSP}
+*/
+class JUCE_API ConvolutionWorkerPool
+{
+public:
+    /** Creates a pool with the given number of threads.
+
+        The threads try to run with realtime priority, and fall back to the
+        highest normal priority where that isn't allowed.
+    */
+    explicit ConvolutionWorkerPool (int numThreads);
+    ~ConvolutionWorkerPool() noexcept;
+
+    /** Returns the number of threads in the pool. */
+    int getNumThreads() const noexcept;
+
+    ConvolutionWorkerPool (const ConvolutionWorkerPool&) = delete;
+    ConvolutionWorkerPool& operator= (const ConvolutionWorkerPool&) = delete;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> pimpl;
+
+    friend class Convolution;
+};
+
 /**
     Performs stereo partitioned convolution of an input signal with an
     impulse response in the frequency domain, using the JUCE FFT class.
@@ -97,6 +139,15 @@ private:
     latency version of the algorithm, or a simple non-uniform partitioned
     convolution algorithm.
 
+    With zero latency and an impulse response longer than a few blocks, only
+    the start of the impulse response is processed in small partitions on the
+    audio thread. The rest is split into stages with partitions that grow
+    larger further into the impulse response. The blocks of these stages are
+    processed on a realtime background thread shared by all Convolutions. If
+    that thread hasn't started a block shortly before it is needed, the audio
+    thread takes it over and does it in small steps spread over the callbacks
+    that remain, so the output is the same either way.
+
     Threading: It is not safe to interleave calls to the methods of this
     class. If you need to load new impulse responses during processing the
     load() calls must be synchronised with process() calls, which in practice
@@ -261,6 +312,17 @@ public:
     void loadImpulseResponse (AudioBuffer<float>&& buffer, double bufferSampleRate,
                               Stereo isStereo, Trim requiresTrimming, Normalise requiresNormalisation);
 
+    /** Processes the channels of the convolution in parallel on the threads of a
+        pool, or on the audio thread alone if the pool is nullptr.
+
+        Like loading a new impulse response, this rebuilds the convolution engine
+        on a background thread and crossfades to it, and is wait-free.
+
+        IMPORTANT: the pool *must* remain alive throughout the lifetime of the
+        Convolution.
+    */
+    void setWorkerPool (ConvolutionWorkerPool* pool);
+
     /** This function returns the size of the current IR in samples. */
     int getCurrentIRSize() const;
 
@@ -250,6 +250,73 @@ class ConvolutionTest final : public UnitTest
             testConvolution (spec, config, ir, irSampleRate, stereo, trim, normalise, expectedResult, sequence);
     }
 
+    // Feeds the same noise through both convolutions in blocks of varying size
+    template <typename Callback>
+    static void processNoise (Convolution& a, Convolution& b, const ProcessSpec& spec, int numSamples, Callback&& checkBlocks)
+    {
+        Random random (0x5678);
+        AudioBuffer<float> bufferA ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        AudioBuffer<float> bufferB ((int) spec.numChannels, (int) spec.maximumBlockSize);
+
+        for (auto done = 0; done < numSamples;)
+        {
+            const auto num = jmin (numSamples - done, 1 + random.nextInt ((int) spec.maximumBlockSize));
+
+            for (auto channel = 0; channel != bufferA.getNumChannels(); ++channel)
+                for (auto sample = 0; sample != num; ++sample)
+                    bufferA.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+            bufferB.makeCopyOf (bufferA, true);
+
+            auto blockA = AudioBlock<float> (bufferA).getSubBlock (0, (size_t) num);
+            auto blockB = AudioBlock<float> (bufferB).getSubBlock (0, (size_t) num);
+
+            a.process (ProcessContextReplacing<float> (blockA));
+            b.process (ProcessContextReplacing<float> (blockB));
+
+            checkBlocks (blockA, blockB);
+            done += num;
+        }
+    }
+
+    void testLongImpulseResponse (const ProcessSpec& spec, int irLength, int numSamples)
+    {
+        // A head as long as the IR forces the engine to process the whole IR uniformly
+        Convolution uniform (Convolution::NonUniform { nextPowerOfTwo (irLength) });
+        Convolution staged;
+
+        for (auto* convolution : { &uniform, &staged })
+        {
+            convolution->loadImpulseResponse (makeDecayingNoise (2, irLength, spec.sampleRate),
+                                              spec.sampleRate,
+                                              Convolution::Stereo::yes,
+                                              Convolution::Trim::no,
+                                              Convolution::Normalise::yes);
+            convolution->prepare (spec);
+        }
+
+        expectEquals (staged.getLatency(), 0);
+        expectEquals (staged.getCurrentIRSize(), irLength);
+
+        auto maxError = 0.0f;
+
+        const auto compare = [&] (const AudioBlock<float>& a, const AudioBlock<float>& b)
+        {
+            for (size_t channel = 0; channel != a.getNumChannels(); ++channel)
+                for (size_t sample = 0; sample != a.getNumSamples(); ++sample)
+                    maxError = jmax (maxError, std::abs (a.getSample ((int) channel, (int) sample)
+                                                          - b.getSample ((int) channel, (int) sample)));
+        };
+
+        processNoise (uniform, staged, spec, numSamples, compare);
+
+        uniform.reset();
+        staged.reset();
+        processNoise (uniform, staged, spec, numSamples, compare);
+
+        expectLessThan (maxError, 1.0e-4f);
+    }
+
 public:
     ConvolutionTest()
         : UnitTest ("Convolution", UnitTestCategories::dsp)
@@ -555,6 +622,114 @@ public:
             }
         }
 
+        beginTest ("Long zero-latency convolutions split into stages match a uniform convolution");
+        {
+            testLongImpulseResponse ({ 44100.0, 64, 2 }, 44100, 88200);
+            testLongImpulseResponse ({ 48000.0, 256, 2 }, 100000, 48000);
+        }
+
+        beginTest ("Engines convolving with the same impulse response share its partitions");
+        {
+            const auto ir = makeDecayingNoise (2, 48000, 48000.0);
+            const auto* samples = ir.getReadPointer (0);
+
+            const auto startTicks = Time::getHighResolutionTicks();
+            ConvolutionEngine first (samples, 48000, 64, 48000.0);
+            const auto middleTicks = Time::getHighResolutionTicks();
+            ConvolutionEngine second (samples, 48000, 64, 48000.0);
+            const auto endTicks = Time::getHighResolutionTicks();
+
+            logMessage ("1 s IR, 64 sample blocks: first engine built in "
+                          + String (Time::highResolutionTicksToSeconds (middleTicks - startTicks) * 1000.0, 2) + " ms, second in "
+                          + String (Time::highResolutionTicksToSeconds (endTicks - middleTicks) * 1000.0, 2) + " ms");
+
+            expect (first.impulseSegments == second.impulseSegments);
+
+            // Anything that changes the partitions gets its own copy
+            ConvolutionEngine otherSamples (ir.getReadPointer (1), 48000, 64, 48000.0);
+            ConvolutionEngine otherLength (samples, 24000, 64, 48000.0);
+            ConvolutionEngine otherBlockSize (samples, 48000, 256, 48000.0);
+            ConvolutionEngine otherSampleRate (samples, 48000, 64, 44100.0);
+
+            for (const auto* engine : { &otherSamples, &otherLength, &otherBlockSize, &otherSampleRate })
+                expect (engine->impulseSegments != first.impulseSegments);
+
+            // A second Convolution loading the same file reuses everything the first one transformed
+            SharedResourcePointer<ImpulseSegmentCache> cache;
+            Convolution a, b;
+            std::vector<size_t> numEntries;
+
+            for (auto* convolution : { &a, &b })
+            {
+                convolution->loadImpulseResponse (makeDecayingNoise (2, 48000, 48000.0),
+                                                  48000.0,
+                                                  Convolution::Stereo::yes,
+                                                  Convolution::Trim::no,
+                                                  Convolution::Normalise::yes);
+                convolution->prepare ({ 48000.0, 64, 2 });
+                numEntries.push_back (cache->getNumEntries());
+            }
+
+            expectEquals (numEntries[1], numEntries[0]);
+
+            auto maxError = 0.0f;
+
+            processNoise (a, b, { 48000.0, 64, 2 }, 4800, [&] (const AudioBlock<float>& x, const AudioBlock<float>& y)
+            {
+                for (size_t channel = 0; channel != x.getNumChannels(); ++channel)
+                    for (size_t sample = 0; sample != x.getNumSamples(); ++sample)
+                        maxError = jmax (maxError, std::abs (x.getSample ((int) channel, (int) sample)
+                                                              - y.getSample ((int) channel, (int) sample)));
+            });
+
+            expectEquals (maxError, 0.0f);
+        }
+
+        beginTest ("Channels processed on a worker pool give the same output");
+        {
+            const ProcessSpec poolSpec { 48000.0, 128, 2 };
+
+            for (auto numThreads : { 0, 1, 3 })
+            {
+                ConvolutionWorkerPool pool (numThreads);
+                expectEquals (pool.getNumThreads(), numThreads);
+
+                const auto checkConfig = [&] (auto makeConvolution, int irLength)
+                {
+                    auto serial = makeConvolution();
+                    auto parallel = makeConvolution();
+                    parallel->setWorkerPool (&pool);
+
+                    for (auto* convolution : { serial.get(), parallel.get() })
+                    {
+                        convolution->loadImpulseResponse (makeDecayingNoise (2, irLength, poolSpec.sampleRate),
+                                                          poolSpec.sampleRate,
+                                                          Convolution::Stereo::yes,
+                                                          Convolution::Trim::no,
+                                                          Convolution::Normalise::yes);
+                        convolution->prepare (poolSpec);
+                    }
+
+                    auto maxError = 0.0f;
+
+                    processNoise (*serial, *parallel, poolSpec, 24000, [&] (const AudioBlock<float>& a, const AudioBlock<float>& b)
+                    {
+                        for (size_t channel = 0; channel != a.getNumChannels(); ++channel)
+                            for (size_t sample = 0; sample != a.getNumSamples(); ++sample)
+                                maxError = jmax (maxError, std::abs (a.getSample ((int) channel, (int) sample)
+                                                                      - b.getSample ((int) channel, (int) sample)));
+                    });
+
+                    expectEquals (maxError, 0.0f);
+                };
+
+                checkConfig ([] { return std::make_unique<Convolution>(); }, 500);
+                checkConfig ([] { return std::make_unique<Convolution>(); }, 20000);
+                checkConfig ([] { return std::make_unique<Convolution> (Convolution::NonUniform { 512 }); }, 20000);
+                checkConfig ([] { return std::make_unique<Convolution> (Convolution::Latency { 1024 }); }, 20000);
+            }
+        }
+
         beginTest ("Convolutions with latency work");
         {
             const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 8);
@@ -577,10 +752,116 @@ public:
             }
         }
     }
+
+    // This is shared with the benchmark below
+    static AudioBuffer<float> makeDecayingNoise (int numChannels, int length, double sampleRate)
+    {
+        Random random (0x1234);
+        AudioBuffer<float> result (numChannels, length);
+
+        for (auto channel = 0; channel != numChannels; ++channel)
+            for (auto sample = 0; sample != length; ++sample)
+                result.setSample (channel, sample, (random.nextFloat() * 2.0f - 1.0f)
+                                                      * std::exp (-3.0f * (float) (sample / sampleRate)));
+
+        return result;
+    }
 };
 
 ConvolutionTest convolutionUnitTest;
 
+//==============================================================================
+class ConvolutionBenchmark final : public UnitTestBenchmark
+{
+public:
+    ConvolutionBenchmark()
+        : UnitTestBenchmark ("Convolution Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost of a long zero-latency convolution split into stages");
+        {
+            const ProcessSpec longSpec { 48000.0, 64, 2 };
+            const auto irLength = 5 * 48000;
+
+            Convolution uniform (Convolution::NonUniform { nextPowerOfTwo (irLength) });
+            Convolution staged;
+
+            for (auto* convolution : { &uniform, &staged })
+            {
+                convolution->loadImpulseResponse (ConvolutionTest::makeDecayingNoise (2, irLength, longSpec.sampleRate),
+                                                  longSpec.sampleRate,
+                                                  Convolution::Stereo::yes,
+                                                  Convolution::Trim::no,
+                                                  Convolution::Normalise::yes);
+                convolution->prepare (longSpec);
+            }
+
+            // This runs much faster than real time, so the audio thread takes over most of the
+            // tail's blocks and the figure is a fair measure of the total cost
+            const auto uniformSeconds = measureProcessingSeconds (uniform, longSpec, 24000);
+            const auto stagedSeconds = measureProcessingSeconds (staged, longSpec, 24000);
+
+            logMessage ("5 s IR, 64 sample blocks: uniform " + String (uniformSeconds * 1000.0, 1) + " ms, staged "
+                          + String (stagedSeconds * 1000.0, 1) + " ms for 0.5 s of stereo audio");
+        }
+
+        beginTest ("Cost of processing channels on a worker pool");
+        {
+            const ProcessSpec poolSpec { 48000.0, 256, 2 };
+            const auto irLength = 48000;
+
+            ConvolutionWorkerPool pool (1);
+            Convolution serial (Convolution::NonUniform { nextPowerOfTwo (irLength) });
+            Convolution parallel (Convolution::NonUniform { nextPowerOfTwo (irLength) });
+            parallel.setWorkerPool (&pool);
+
+            for (auto* convolution : { &serial, &parallel })
+            {
+                convolution->loadImpulseResponse (ConvolutionTest::makeDecayingNoise (2, irLength, poolSpec.sampleRate),
+                                                  poolSpec.sampleRate,
+                                                  Convolution::Stereo::yes,
+                                                  Convolution::Trim::no,
+                                                  Convolution::Normalise::yes);
+                convolution->prepare (poolSpec);
+            }
+
+            const auto serialSeconds = measureProcessingSeconds (serial, poolSpec, 48000);
+            const auto parallelSeconds = measureProcessingSeconds (parallel, poolSpec, 48000);
+
+            logMessage ("1 s uniform stereo IR, 256 sample blocks, " + String (SystemStats::getNumCpus()) + " CPUs: serial "
+                          + String (serialSeconds * 1000.0, 1) + " ms, one worker " + String (parallelSeconds * 1000.0, 1)
+                          + " ms for 1 s of audio");
+        }
+    }
+
+private:
+    static double measureProcessingSeconds (Convolution& convolution, const ProcessSpec& spec, int numSamples)
+    {
+        AudioBuffer<float> buffer ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        AudioBlock<float> block { buffer };
+        ProcessContextReplacing<float> context { block };
+        Random random (0x5678);
+
+        const auto startTicks = Time::getHighResolutionTicks();
+
+        for (auto done = 0; done < numSamples; done += (int) spec.maximumBlockSize)
+        {
+            for (auto channel = 0; channel != buffer.getNumChannels(); ++channel)
+                buffer.setSample (channel, 0, random.nextFloat() * 2.0f - 1.0f);
+
+            convolution.process (context);
+        }
+
+        return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+ConvolutionBenchmark convolutionBenchmark;
+#endif
+
 }
 } // namespace juce::dsp
 
@@ -41,8 +41,16 @@
  #error "Incorrect use of JUCE cpp file"
 #endif
 
+#define JUCE_CORE_INCLUDE_NATIVE_HEADERS 1
+
 #include "juce_dsp.h"
 
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif ! JUCE_WINDOWS
+ #include <semaphore.h>
+#endif
+
 #ifndef JUCE_USE_VDSP_FRAMEWORK
  #define JUCE_USE_VDSP_FRAMEWORK 1
 #endif
@@ -65,6 +73,7 @@
 
 #include "processors/juce_FIRFilter.cpp"
 #include "processors/juce_IIRFilter.cpp"
+#include "processors/juce_IIRBatchedCascade.cpp"
 #include "processors/juce_FirstOrderTPTFilter.cpp"
 #include "processors/juce_Panner.cpp"
 #include "processors/juce_Oversampling.cpp"
@@ -86,6 +95,9 @@
 #include "widgets/juce_Limiter.cpp"
 #include "widgets/juce_Phaser.cpp"
 #include "widgets/juce_Chorus.cpp"
+#include "widgets/juce_SIMDReverb.cpp"
+#include "widgets/juce_ReverbBank.cpp"
+#include "widgets/juce_ReverbBankAudioSource.cpp"
 
 #if JUCE_USE_SIMD
  #if JUCE_INTEL
@@ -113,5 +125,8 @@
  #include "frequency/juce_Convolution_test.cpp"
  #include "frequency/juce_FFT_test.cpp"
  #include "processors/juce_FIRFilter_test.cpp"
+ #include "processors/juce_IIRBatchedCascade_test.cpp"
  #include "processors/juce_ProcessorChain_test.cpp"
+ #include "widgets/juce_SIMDReverb_test.cpp"
+ #include "widgets/juce_ReverbBank_test.cpp"
 #endif
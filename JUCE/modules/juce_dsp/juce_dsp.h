@@ -264,6 +264,7 @@ namespace util
 #include "processors/juce_ProcessorDuplicator.h"
 #include "processors/juce_IIRFilter.h"
 #include "processors/juce_IIRFilter_Impl.h"
+#include "processors/juce_IIRBatchedCascade.h"
 #include "processors/juce_FIRFilter.h"
 #include "processors/juce_StateVariableFilter.h"
 #include "processors/juce_FirstOrderTPTFilter.h"
@@ -278,7 +279,10 @@ namespace util
 #include "frequency/juce_Convolution.h"
 #include "frequency/juce_Windowing.h"
 #include "filter_design/juce_FilterDesign.h"
+#include "widgets/juce_ReverbBank.h"
+#include "widgets/juce_ReverbBankAudioSource.h"
 #include "widgets/juce_Reverb.h"
+#include "widgets/juce_SIMDReverb.h"
 #include "widgets/juce_Bias.h"
 #include "widgets/juce_Gain.h"
 #include "widgets/juce_WaveShaper.h"
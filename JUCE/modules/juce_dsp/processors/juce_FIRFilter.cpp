@@ -164,4 +164,259 @@ void FIR::Coefficients<NumericType>::Coefficients::normalise() noexcept
 template struct FIR::Coefficients<float>;
 template struct FIR::Coefficients<double>;
 
+//==============================================================================
+/*  Applies the coefficients after a filter's first partition with a uniformly
+    partitioned overlap-save convolution.
+
+    Once a block of partitionSize input samples is complete, everything that the
+    later partitions contribute to the next block can be computed, because each
+    of them delays its input by at least partitionSize samples. The spectra of
+    the most recent input windows are kept in a ring, so each block only needs
+    one forward and one inverse FFT.
+*/
+class FIR::detail::PartitionedConvolution
+{
+public:
+    PartitionedConvolution (size_t partitionSizeToUse, size_t numTailCoefficientsToUse)
+        : partitionSize (partitionSizeToUse),
+          numBins (partitionSize + 1),
+          numTailCoefficients (numTailCoefficientsToUse),
+          numPartitions ((numTailCoefficients + partitionSize - 1) / partitionSize),
+          fft (roundToInt (std::log2 (2 * partitionSize))),
+          window (2 * partitionSize),
+          scratch (4 * partitionSize),
+          output (partitionSize),
+          inputSpectra (2 * numBins * numPartitions),
+          filterSpectra (2 * numBins * numPartitions),
+          outputSpectrum (2 * numBins),
+          tailCoefficients (numTailCoefficients)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        std::fill (window.begin(), window.end(), 0.0f);
+        std::fill (output.begin(), output.end(), 0.0f);
+        std::fill (inputSpectra.begin(), inputSpectra.end(), 0.0f);
+        current = position = 0;
+    }
+
+    size_t getNumSamplesUntilBlockEnd() const noexcept   { return partitionSize - position; }
+
+    // Adds what the later partitions contribute to the output, which was
+    // worked out when the previous block was finished
+    void process (const float* coefficients, const float* input, float* destination, size_t numSamples, bool isBypassed) noexcept
+    {
+        jassert (numSamples <= getNumSamplesUntilBlockEnd());
+
+        std::copy (input, input + numSamples, window.data() + partitionSize + position);
+
+        if (! isBypassed)
+            FloatVectorOperations::add (destination, output.data() + position, (int) numSamples);
+
+        position += numSamples;
+
+        if (position == partitionSize)
+            finishBlock (coefficients);
+    }
+
+private:
+    void finishBlock (const float* coefficients) noexcept
+    {
+        // The coefficients may have been changed in place since the last block
+        if (! filterSpectraAreValid || ! std::equal (tailCoefficients.begin(), tailCoefficients.end(), coefficients))
+            updateFilterSpectra (coefficients);
+
+        std::copy (window.begin(), window.end(), scratch.begin());
+        forwardTransform (getInputSpectrum (current));
+
+        std::fill (outputSpectrum.begin(), outputSpectrum.end(), 0.0f);
+
+        for (size_t i = 0; i < numPartitions; ++i)
+            multiplyAndAccumulate (getInputSpectrum ((current + numPartitions - i) % numPartitions),
+                                   filterSpectra.data() + 2 * numBins * i);
+
+        // Back to interleaved bins, for the inverse transform
+        for (size_t bin = 0; bin < numBins; ++bin)
+        {
+            scratch[2 * bin]     = outputSpectrum[bin];
+            scratch[2 * bin + 1] = outputSpectrum[numBins + bin];
+        }
+
+        fft.performRealOnlyInverseTransform (scratch.data());
+
+        // Only the second half of the window is free from circular wrap-around
+        std::copy (scratch.begin() + (ptrdiff_t) partitionSize, scratch.begin() + (ptrdiff_t) (2 * partitionSize), output.begin());
+        std::copy (window.begin() + (ptrdiff_t) partitionSize, window.end(), window.begin());
+
+        current = (current + 1) % numPartitions;
+        position = 0;
+    }
+
+    float* getInputSpectrum (size_t index) noexcept     { return inputSpectra.data() + 2 * numBins * index; }
+
+    // Transforms the contents of scratch, storing the real parts of the bins
+    // followed by their imaginary parts so they can be multiplied with SIMD
+    void forwardTransform (float* spectrum) noexcept
+    {
+        fft.performRealOnlyForwardTransform (scratch.data(), true);
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+        {
+            spectrum[bin]           = scratch[2 * bin];
+            spectrum[numBins + bin] = scratch[2 * bin + 1];
+        }
+    }
+
+    void multiplyAndAccumulate (const float* a, const float* b) noexcept
+    {
+        auto* re = outputSpectrum.data();
+        auto* im = re + numBins;
+        const auto n = (int) numBins;
+
+        FloatVectorOperations::addWithMultiply      (re, a,           b,           n);
+        FloatVectorOperations::subtractWithMultiply (re, a + numBins, b + numBins, n);
+        FloatVectorOperations::addWithMultiply      (im, a,           b + numBins, n);
+        FloatVectorOperations::addWithMultiply      (im, a + numBins, b,           n);
+    }
+
+    void updateFilterSpectra (const float* coefficients) noexcept
+    {
+        std::copy (coefficients, coefficients + numTailCoefficients, tailCoefficients.begin());
+
+        for (size_t i = 0; i < numPartitions; ++i)
+        {
+            const auto start = i * partitionSize;
+            const auto num = jmin (partitionSize, numTailCoefficients - start);
+
+            std::fill (scratch.begin(), scratch.end(), 0.0f);
+            std::copy (coefficients + start, coefficients + start + num, scratch.begin());
+            forwardTransform (filterSpectra.data() + 2 * numBins * i);
+        }
+
+        filterSpectraAreValid = true;
+    }
+
+    const size_t partitionSize, numBins, numTailCoefficients, numPartitions;
+    const FFT fft;
+    std::vector<float> window, scratch, output, inputSpectra, filterSpectra, outputSpectrum, tailCoefficients;
+    size_t current = 0, position = 0;
+    bool filterSpectraAreValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE (PartitionedConvolution)
+};
+
+//==============================================================================
+template <typename SampleType>
+FIR::detail::FilterState<SampleType>::FilterState() = default;
+
+template <typename SampleType>
+FIR::detail::FilterState<SampleType>::~FilterState() = default;
+
+template <typename SampleType>
+FIR::detail::FilterState<SampleType>::FilterState (FilterState&&) noexcept = default;
+
+template <typename SampleType>
+FIR::detail::FilterState<SampleType>& FIR::detail::FilterState<SampleType>::operator= (FilterState&&) noexcept = default;
+
+template <typename SampleType>
+void FIR::detail::FilterState<SampleType>::reset (size_t newNumCoefficients)
+{
+    if (newNumCoefficients != numCoefficients)
+    {
+        numCoefficients = newNumCoefficients;
+        partitions.reset();
+        headSize = numCoefficients;
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            if (numCoefficients >= minPartitionedSize)
+            {
+                // A longer first partition means fewer partitions to multiply, but more work in the time domain
+                headSize = jlimit ((size_t) 128, (size_t) 1024, (size_t) nextPowerOfTwo ((int) std::sqrt ((double) numCoefficients)) * 2);
+                partitions = std::make_unique<PartitionedConvolution> (headSize, numCoefficients - headSize);
+            }
+        }
+
+        // The history is only moved back to the start of the buffer once it's full
+        maxBlockSize = jmax (headSize, (size_t) 256);
+        history.malloc (headSize - 1 + maxBlockSize);
+    }
+
+    FloatVectorOperations::clear (history.get(), (int) (headSize - 1 + maxBlockSize));
+    writePosition = headSize - 1;
+
+    if (partitions != nullptr)
+        partitions->reset();
+}
+
+template <typename SampleType>
+void FIR::detail::FilterState<SampleType>::process (const SampleType* coefficients, const SampleType* input, SampleType* output,
+                                                    size_t numSamples, bool isBypassed) noexcept
+{
+    while (numSamples > 0)
+    {
+        auto num = jmin (numSamples, maxBlockSize);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+            if (partitions != nullptr)
+                num = jmin (num, partitions->getNumSamplesUntilBlockEnd());
+
+        if (writePosition + num > headSize - 1 + maxBlockSize)
+        {
+            std::copy (history + writePosition - (headSize - 1), history + writePosition, history.get());
+            writePosition = headSize - 1;
+        }
+
+        // The input is copied first, in case it's the same buffer as the output
+        FloatVectorOperations::copy (history + writePosition, input, (int) num);
+
+        if (isBypassed)
+            FloatVectorOperations::copy (output, history + writePosition, (int) num);
+        else
+            filterHead (coefficients, output, num);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+            if (partitions != nullptr)
+                partitions->process (coefficients + headSize, history + writePosition, output, num, isBypassed);
+
+        writePosition += num;
+        input += num;
+        output += num;
+        numSamples -= num;
+    }
+}
+
+template <typename SampleType>
+void FIR::detail::FilterState<SampleType>::filterHead (const SampleType* coefficients, SampleType* output, size_t numSamples) const noexcept
+{
+    const auto* x = history + writePosition;
+
+    // Too few samples to be worth a vector operation per coefficient
+    if (numSamples < 8)
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto* xi = x + i;
+            SampleType sum {};
+
+            for (size_t k = 0; k < headSize; ++k)
+                sum += coefficients[k] * *(xi - k);
+
+            output[i] = sum;
+        }
+
+        return;
+    }
+
+    FloatVectorOperations::multiply (output, x, coefficients[0], (int) numSamples);
+
+    for (size_t k = 1; k < headSize; ++k)
+        FloatVectorOperations::addWithMultiply (output, x - k, coefficients[k], (int) numSamples);
+}
+
+template class FIR::detail::FilterState<float>;
+template class FIR::detail::FilterState<double>;
+
 } // namespace juce::dsp
@@ -40,15 +40,68 @@ namespace juce::dsp::FIR
     template <typename NumericType>
     struct Coefficients;
 
+   #ifndef DOXYGEN
+    /** The contents of this namespace are used to implement FIR::Filter and should
+        not be used elsewhere. Their interfaces (and existence) are liable to change!
+    */
+    namespace detail
+    {
+        class PartitionedConvolution;
+
+        /*  The processing state of a Filter with float or double samples.
+
+            Blocks are filtered one coefficient at a time, each one adding a scaled
+            and delayed copy of the input to the output with a SIMD
+            FloatVectorOperations call. Float kernels with at least minPartitionedSize
+            coefficients only handle their first partition like this, and apply the
+            remaining ones with a uniformly partitioned overlap-save FFT convolution
+            once every partition's worth of samples. Each output sample is still
+            available as soon as its input arrives, so there's no added latency.
+        */
+        template <typename SampleType>
+        class FilterState
+        {
+        public:
+            FilterState();
+            ~FilterState();
+
+            FilterState (FilterState&&) noexcept;
+            FilterState& operator= (FilterState&&) noexcept;
+
+            void reset (size_t numCoefficients);
+
+            void process (const SampleType* coefficients, const SampleType* input, SampleType* output,
+                          size_t numSamples, bool isBypassed) noexcept;
+
+            static constexpr size_t minPartitionedSize = 2048;
+
+        private:
+            void filterHead (const SampleType* coefficients, SampleType* output, size_t numSamples) const noexcept;
+
+            HeapBlock<SampleType> history;
+            size_t numCoefficients = 0, headSize = 0, maxBlockSize = 0, writePosition = 0;
+            std::unique_ptr<PartitionedConvolution> partitions;
+        };
+
+        /*  Filters with SIMDRegister samples keep using their own delay line. */
+        struct NoFilterState {};
+    }
+   #endif
+
     //==============================================================================
     /**
-        A processing class that can perform FIR filtering on an audio signal, in the
-        time domain.
+        A processing class that can perform FIR filtering on an audio signal.
+
+        Filters with float or double samples are evaluated with SIMD instructions
+        in the time domain. Float filters with 2048 or more coefficients also move
+        everything after their first partition into the frequency domain, using a
+        partitioned FFT convolution that adds no latency, so long FilterDesign
+        kernels can be used directly. Filters with SIMDRegister samples are always
+        evaluated sample by sample in the time domain.
 
-        Using FIRFilter is fast enough for FIRCoefficients with a size lower than 128
-        samples. For longer filters, it might be more efficient to use the class
-        Convolution instead, which does the same processing in the frequency domain
-        thanks to FFT.
+        The Convolution class is still a better choice for very long impulse
+        responses, or when the impulse response has to be loaded or changed on a
+        background thread.
 
         @see FIRFilter::Coefficients, Convolution, FFT
 
@@ -99,16 +152,24 @@ namespace juce::dsp::FIR
             {
                 auto newSize = coefficients->getFilterOrder() + 1;
 
-                if (newSize != size)
+                if constexpr (usesFilterState)
                 {
-                    memory.malloc (1 + jmax (newSize, size, static_cast<size_t> (128)));
-
-                    fifo = snapPointerToAlignment (memory.getData(), sizeof (SampleType));
+                    state.reset (newSize);
                     size = newSize;
                 }
+                else
+                {
+                    if (newSize != size)
+                    {
+                        memory.malloc (1 + jmax (newSize, size, static_cast<size_t> (128)));
 
-                for (size_t i = 0; i < size; ++i)
-                    fifo[i] = SampleType {0};
+                        fifo = snapPointerToAlignment (memory.getData(), sizeof (SampleType));
+                        size = newSize;
+                    }
+
+                    for (size_t i = 0; i < size; ++i)
+                        fifo[i] = SampleType {0};
+                }
             }
         }
 
@@ -143,6 +204,13 @@ namespace juce::dsp::FIR
             auto* dst = outputBlock.getChannelPointer (0);
 
             auto* fir = coefficients->getRawCoefficients();
+
+            if constexpr (usesFilterState)
+            {
+                state.process (fir, src, dst, numSamples, context.isBypassed);
+                return;
+            }
+
             size_t p = pos;
 
             if (context.isBypassed)
@@ -169,14 +237,26 @@ namespace juce::dsp::FIR
         SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType sample) noexcept
         {
             check();
-            return processSingleSample (sample, fifo, coefficients->getRawCoefficients(), size, pos);
+
+            if constexpr (usesFilterState)
+            {
+                state.process (coefficients->getRawCoefficients(), &sample, &sample, 1, false);
+                return sample;
+            }
+            else
+            {
+                return processSingleSample (sample, fifo, coefficients->getRawCoefficients(), size, pos);
+            }
         }
 
     private:
         //==============================================================================
+        static constexpr bool usesFilterState = std::is_floating_point_v<SampleType>;
+
         HeapBlock<SampleType> memory;
         SampleType* fifo = nullptr;
         size_t pos = 0, size = 0;
+        std::conditional_t<usesFilterState, detail::FilterState<SampleType>, detail::NoFilterState> state;
 
         //==============================================================================
         void check()
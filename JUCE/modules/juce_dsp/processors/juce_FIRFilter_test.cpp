@@ -74,9 +74,6 @@ class FIRFilterTest final : public UnitTest
     };
    #endif
 
-    template <typename Type>
-    static void fillRandom (Random& random, Type* buffer, size_t n) { Helpers<Type>::fillRandom (random, buffer, n); }
-
     template <typename Type>
     static bool checkArrayIsSimilar (Type* a, Type* b, size_t n) noexcept { return Helpers<Type>::checkArrayIsSimilar (a, b, n); }
 
@@ -210,6 +207,101 @@ class FIRFilterTest final : public UnitTest
     }
 
 
+    //==============================================================================
+    // Long filters accumulate more rounding error, so they're compared relative to the output level
+    template <typename FloatType>
+    void runLongFilterTest (size_t size)
+    {
+        Random random (2958103);
+        constexpr size_t n = 4000;
+
+        std::vector<FloatType> input (n), output (n), ref (n), fir (size);
+        fillRandom (random, input.data(), n);
+        fillRandom (random, fir.data(), size);
+
+        FIR::Filter<FloatType> filter (*new FIR::Coefficients<FloatType> (fir.data(), size));
+        filter.prepare ({ 0.0, (uint32) n, 1 });
+
+        // Blocks of irregular sizes that straddle the partitions, some single samples and a bypassed block
+        for (size_t i = 0, blockIndex = 0; i < n; ++blockIndex)
+        {
+            const auto len = jmin (n - i, (size_t) random.nextInt (blockIndex % 4 == 0 ? 3 : 700) + 1);
+            auto* src = input.data() + i;
+            auto* dst = output.data() + i;
+
+            if (len == 1)
+            {
+                *dst = filter.processSample (*src);
+            }
+            else
+            {
+                AudioBlock<const FloatType> inBlock (&src, 1, len);
+                AudioBlock<FloatType> outBlock (&dst, 1, len);
+                ProcessContextNonReplacing<FloatType> context (inBlock, outBlock);
+                context.isBypassed = (blockIndex == 5);
+
+                filter.process (context);
+
+                if (context.isBypassed)
+                {
+                    expect (std::equal (src, src + len, dst));
+                    std::fill (dst, dst + len, FloatType());
+                }
+            }
+
+            i += len;
+        }
+
+        reference<FloatType, FloatType> (fir.data(), size, input.data(), ref.data(), n);
+
+        auto biggestDifference = 0.0, biggestOutput = 0.0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (output[i] == FloatType())
+                continue; // bypassed
+
+            biggestDifference = jmax (biggestDifference, (double) std::abs (output[i] - ref[i]));
+            biggestOutput = jmax (biggestOutput, (double) std::abs (ref[i]));
+        }
+
+        expectLessThan (biggestDifference, biggestOutput * 1.0e-5, String (size) + " coefficients");
+    }
+
+    void runCoefficientChangeTest()
+    {
+        Random random (8812);
+        constexpr size_t n = 3000, size = 2500;
+
+        std::vector<float> input (n), output (n), ref (n), fir (size);
+        fillRandom (random, input.data(), n);
+        fillRandom (random, fir.data(), size);
+
+        FIR::Filter<float> filter (*new FIR::Coefficients<float> (fir.data(), size));
+        filter.prepare ({ 0.0, (uint32) n, 1 });
+
+        auto* src = input.data();
+        auto* dst = output.data();
+        AudioBlock<const float> inBlock (&src, 1, n);
+        AudioBlock<float> outBlock (&dst, 1, n);
+        filter.process (ProcessContextNonReplacing<float> (inBlock, outBlock));
+
+        // The coefficients are changed in place, so the filter has to notice on its own
+        FloatVectorOperations::multiply (filter.coefficients->getRawCoefficients(), -0.5f, (int) size);
+        filter.reset();
+        filter.process (ProcessContextNonReplacing<float> (inBlock, outBlock));
+
+        FloatVectorOperations::multiply (fir.data(), -0.5f, (int) size);
+        reference<float, float> (fir.data(), size, input.data(), ref.data(), n);
+
+        auto biggestDifference = 0.0;
+
+        for (size_t i = 0; i < n; ++i)
+            biggestDifference = jmax (biggestDifference, (double) std::abs (output[i] - ref[i]));
+
+        expectLessThan (biggestDifference, 1.0e-3);
+    }
+
 public:
     FIRFilterTest()
         : UnitTest ("FIR Filter", UnitTestCategories::dsp)
@@ -220,9 +312,80 @@ public:
         runTestForAllTypes<LargeBlockTest> ("Large Blocks");
         runTestForAllTypes<SampleBySampleTest> ("Sample by Sample");
         runTestForAllTypes<SplitBlockTest> ("Split Block");
+
+        beginTest ("Long filters");
+        {
+            for (auto size : { 100, 1024, 2047, 2048, 2100, 5000 })
+            {
+                runLongFilterTest<float>  ((size_t) size);
+                runLongFilterTest<double> ((size_t) size);
+            }
+        }
+
+        beginTest ("Coefficients changed in place");
+        runCoefficientChangeTest();
     }
+
+    // This is shared with the benchmark below
+    template <typename Type>
+    static void fillRandom (Random& random, Type* buffer, size_t n) { Helpers<Type>::fillRandom (random, buffer, n); }
 };
 
 static FIRFilterTest firFilterUnitTest;
 
+//==============================================================================
+class FIRFilterBenchmark final : public UnitTestBenchmark
+{
+public:
+    FIRFilterBenchmark()
+        : UnitTestBenchmark ("FIR Filter Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost per sample");
+
+        for (auto size : { 16, 64, 256, 1024, 2047, 2048, 4096, 16384 })
+        {
+            logMessage (String (size) + " coefficients: float " + String (measureNanosecondsPerSample<float> ((size_t) size), 2)
+                          + " ns, double " + String (measureNanosecondsPerSample<double> ((size_t) size), 2) + " ns per sample");
+        }
+    }
+
+private:
+    template <typename FloatType>
+    double measureNanosecondsPerSample (size_t size)
+    {
+        Random random (13);
+        constexpr size_t blockSize = 512;
+        constexpr int numRounds = 5;
+        const auto numBlocks = jmax ((size_t) 4, (size_t) 4000000 / (size * blockSize));
+
+        std::vector<FloatType> buffer (blockSize), fir (size);
+        FIRFilterTest::fillRandom (random, buffer.data(), blockSize);
+        FIRFilterTest::fillRandom (random, fir.data(), size);
+
+        FIR::Filter<FloatType> filter (*new FIR::Coefficients<FloatType> (fir.data(), size));
+        filter.prepare ({ 0.0, (uint32) blockSize, 1 });
+
+        auto* data = buffer.data();
+        AudioBlock<FloatType> block (&data, 1, blockSize);
+
+        const auto seconds = measureFastestSeconds (numRounds, [&]
+        {
+            for (size_t i = 0; i < numBlocks; ++i)
+            {
+                FIRFilterTest::fillRandom (random, data, 1);
+                filter.process (ProcessContextReplacing<FloatType> (block));
+            }
+        });
+
+        return seconds * 1.0e9 / (double) (numBlocks * blockSize);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static FIRFilterBenchmark firFilterBenchmark;
+#endif
+
 } // namespace juce::dsp
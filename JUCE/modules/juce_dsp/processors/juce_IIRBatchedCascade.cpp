@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp::IIR
+{
+
+template <typename SampleType>
+BatchedCascade<SampleType>::BatchedCascade() = default;
+
+template <typename SampleType>
+void BatchedCascade<SampleType>::prepare (const ProcessSpec& spec, int numSectionsToUse)
+{
+    jassert (numSectionsToUse >= 0);
+
+    numChannels = (int) spec.numChannels;
+    numSections = jmax (0, numSectionsToUse);
+    numLanes = (numChannels + lanesPerRegister - 1) / lanesPerRegister * lanesPerRegister;
+
+    // Every block below is a whole number of runs of numLanes, so each of them stays aligned to a register
+    const auto alignment = (size_t) lanesPerRegister * sizeof (SampleType);
+    const auto numCoefficientValues = (size_t) (numSections * numCoefficients * numLanes);
+    const auto numStateValuesTotal  = (size_t) (numSections * numStateValues * numLanes);
+    const auto numScratchValues     = (size_t) (maxBlockSize * numLanes);
+
+    storage.calloc ((numCoefficientValues + numStateValuesTotal + numScratchValues) * sizeof (SampleType) + alignment);
+    auto* next = snapPointerToAlignment (unalignedPointerCast<SampleType*> (storage.get()), alignment);
+
+    coefficients = next;
+    state        = coefficients + numCoefficientValues;
+    frames       = state + numStateValuesTotal;
+
+    // Until they're given coefficients, the sections just pass their input through
+    for (int section = 0; section < numSections; ++section)
+        std::fill_n (getCoefficients (section, 0), numLanes, (SampleType) 1);
+
+    inputChannels .resize ((size_t) numChannels);
+    outputChannels.resize ((size_t) numChannels);
+}
+
+template <typename SampleType>
+void BatchedCascade<SampleType>::setCoefficients (int section, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        setCoefficients (channel, section, newCoefficients);
+}
+
+template <typename SampleType>
+void BatchedCascade<SampleType>::setCoefficients (int channel, int section, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+    jassert (isPositiveAndBelow (section, numSections));
+
+    const auto* c = newCoefficients.getRawCoefficients();
+    SampleType values[numCoefficients] {};
+
+    // A first order section is a second order one with b2 and a2 left at zero
+    switch (newCoefficients.getFilterOrder())
+    {
+        case 1:
+            values[0] = c[0];
+            values[1] = c[1];
+            values[3] = c[2];
+            break;
+
+        case 2:
+            std::copy (c, c + numCoefficients, values);
+            break;
+
+        default:
+            jassertfalse; // Only first and second order sections are supported
+            return;
+    }
+
+    for (int i = 0; i < numCoefficients; ++i)
+        getCoefficients (section, i)[channel] = values[i];
+}
+
+template <typename SampleType>
+void BatchedCascade<SampleType>::reset() noexcept
+{
+    std::fill (state, frames, SampleType());
+}
+
+//==============================================================================
+template <typename SampleType>
+void BatchedCascade<SampleType>::process (const SampleType* const* input, SampleType* const* output,
+                                          size_t numChannelsToProcess, size_t numSamples, bool isBypassed) noexcept
+{
+    for (size_t start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const auto num = jmin ((size_t) maxBlockSize, numSamples - start);
+
+        for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            const auto* in = input[channel] + start;
+
+            for (size_t i = 0; i < num; ++i)
+                frames[i * (size_t) numLanes + channel] = in[i];
+        }
+
+        // Channels that aren't in the block are fed silence
+        for (auto channel = numChannelsToProcess; channel < (size_t) numLanes; ++channel)
+            for (size_t i = 0; i < num; ++i)
+                frames[i * (size_t) numLanes + channel] = SampleType();
+
+        processSections (num);
+
+        for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            auto* out = output[channel] + start;
+
+            if (isBypassed)
+            {
+                if (out != input[channel] + start)
+                    std::copy (input[channel] + start, input[channel] + start + num, out);
+            }
+            else
+            {
+                for (size_t i = 0; i < num; ++i)
+                    out[i] = frames[i * (size_t) numLanes + channel];
+            }
+        }
+    }
+
+    for (auto* s = state; s != frames; ++s)
+        util::snapToZero (*s);
+}
+
+template <typename SampleType>
+void BatchedCascade<SampleType>::processSections (size_t numFrames) noexcept
+{
+    // The channel groups are the innermost loop: each section is a chain of dependent
+    // operations from one sample to the next, and the groups are independent of each
+    // other, so the CPU can work on several of them at once.
+    for (int section = 0; section < numSections; ++section)
+    {
+        const auto* b0 = getCoefficients (section, 0);
+        const auto* b1 = getCoefficients (section, 1);
+        const auto* b2 = getCoefficients (section, 2);
+        const auto* a1 = getCoefficients (section, 3);
+        const auto* a2 = getCoefficients (section, 4);
+        auto* s1 = getState (section, 0);
+        auto* s2 = getState (section, 1);
+
+        for (size_t i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * (size_t) numLanes;
+
+           #if JUCE_USE_SIMD
+            using Vec = SIMDRegister<SampleType>;
+
+            for (int lane = 0; lane < numLanes; lane += lanesPerRegister)
+            {
+                const auto in  = Vec::fromRawArray (frame + lane);
+                const auto out = (in * Vec::fromRawArray (b0 + lane)) + Vec::fromRawArray (s1 + lane);
+
+                ((in * Vec::fromRawArray (b1 + lane)) - (out * Vec::fromRawArray (a1 + lane)) + Vec::fromRawArray (s2 + lane)).copyToRawArray (s1 + lane);
+                ((in * Vec::fromRawArray (b2 + lane)) - (out * Vec::fromRawArray (a2 + lane))).copyToRawArray (s2 + lane);
+                out.copyToRawArray (frame + lane);
+            }
+           #else
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto in  = frame[lane];
+                const auto out = (in * b0[lane]) + s1[lane];
+
+                s1[lane] = (in * b1[lane]) - (out * a1[lane]) + s2[lane];
+                s2[lane] = (in * b2[lane]) - (out * a2[lane]);
+                frame[lane] = out;
+            }
+           #endif
+        }
+    }
+}
+
+template class BatchedCascade<float>;
+template class BatchedCascade<double>;
+
+} // namespace juce::dsp::IIR
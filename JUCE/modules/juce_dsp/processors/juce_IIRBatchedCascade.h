@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp::IIR
+{
+
+/**
+    Runs the same chain of first and second order IIR sections on many channels at once.
+
+    Each channel has its own coefficients for every section, so this can be used
+    for a bus of channel EQs as well as for one EQ applied to many channels. The
+    coefficients and state are stored section by section with one lane per channel,
+    which lets a single SIMDRegister run a section for a whole group of channels at
+    a time. The cost therefore grows with the number of registers needed to hold
+    the channels rather than with the number of channels.
+
+    The sections use the same Transposed Direct Form II structure as IIR::Filter,
+    and each channel gives the same output as running its sections through a chain
+    of Filter objects. Like Filter, the state is snapped to zero at the end of each
+    process() call rather than after every sample.
+
+    @see IIR::Filter, ProcessorDuplicator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class BatchedCascade
+{
+public:
+    static_assert (std::is_floating_point_v<SampleType>, "BatchedCascade only supports float and double");
+
+    //==============================================================================
+    /** Creates an empty cascade. Call prepare() before first use. */
+    BatchedCascade();
+
+    /** Allocates the sections for the number of channels in the spec and clears
+        their state. Every section starts out passing its input straight through.
+    */
+    void prepare (const ProcessSpec& spec, int numSections);
+
+    /** Returns the number of channels the cascade was prepared for. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the number of sections the cascade was prepared for. */
+    int getNumSections() const noexcept                 { return numSections; }
+
+    //==============================================================================
+    /** Gives one section the same coefficients on every channel.
+        The coefficients must be of first or second order.
+    */
+    void setCoefficients (int section, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    /** Gives one section of one channel its own coefficients.
+        The coefficients must be of first or second order.
+    */
+    void setCoefficients (int channel, int section, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    /** Clears the state of every section, leaving the coefficients as they are. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes a block of samples.
+        The block may have fewer channels than the cascade was prepared for, in
+        which case the remaining channels are fed silence. A bypassed block is
+        still run through the sections, so switching the bypass off again
+        doesn't cause a discontinuity.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        static_assert (std::is_same_v<typename ProcessContext::SampleType, SampleType>,
+                       "The sample-type of the cascade must match the sample-type supplied to this process callback");
+
+        auto&& inputBlock  = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+        jassert ((int) inputBlock.getNumChannels() <= numChannels);
+
+        const auto numChannelsToProcess = jmin ((size_t) numChannels, inputBlock.getNumChannels());
+
+        for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            inputChannels[channel]  = inputBlock .getChannelPointer (channel);
+            outputChannels[channel] = outputBlock.getChannelPointer (channel);
+        }
+
+        process (inputChannels.data(), outputChannels.data(), numChannelsToProcess,
+                 inputBlock.getNumSamples(), context.isBypassed);
+    }
+
+private:
+    //==============================================================================
+    enum { numCoefficients = 5, numStateValues = 2, maxBlockSize = 64 };
+
+   #if JUCE_USE_SIMD
+    static constexpr int lanesPerRegister = (int) SIMDRegister<SampleType>::SIMDNumElements;
+   #else
+    static constexpr int lanesPerRegister = 4;
+   #endif
+
+    void process (const SampleType* const* input, SampleType* const* output,
+                  size_t numChannelsToProcess, size_t numSamples, bool isBypassed) noexcept;
+
+    void processSections (size_t numFrames) noexcept;
+
+    // Each of these is a run of numLanes values, one per channel
+    SampleType* getCoefficients (int section, int index) const noexcept  { return coefficients + (section * numCoefficients + index) * numLanes; }
+    SampleType* getState (int section, int index) const noexcept         { return state + (section * numStateValues + index) * numLanes; }
+
+    //==============================================================================
+    int numChannels = 0, numSections = 0;
+
+    // The number of channels rounded up to whole registers; the spare lanes carry silence
+    int numLanes = 0;
+
+    HeapBlock<char> storage;
+    SampleType* coefficients = nullptr;
+    SampleType* state = nullptr;
+
+    // Per-block scratch, one frame of numLanes values per sample
+    SampleType* frames = nullptr;
+
+    std::vector<const SampleType*> inputChannels;
+    std::vector<SampleType*> outputChannels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchedCascade)
+};
+
+} // namespace juce::dsp::IIR
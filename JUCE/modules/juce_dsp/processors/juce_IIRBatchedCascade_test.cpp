@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp::IIR
+{
+
+class BatchedCascadeTest final : public UnitTest
+{
+public:
+    BatchedCascadeTest()
+        : UnitTest ("IIR Batched Cascade", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Every channel matches a chain of IIR::Filters");
+        {
+            for (auto numChannels : { 1, 5, 32 })
+            {
+                expectChannelsMatchReference<float>  (numChannels, 1.0e-5);
+                expectChannelsMatchReference<double> (numChannels, 1.0e-12);
+            }
+        }
+
+        beginTest ("Channels missing from a block are fed silence");
+        {
+            BatchedCascade<float> cascade;
+            cascade.prepare ({ 44100.0, 512, 4 }, 1);
+            cascade.setCoefficients (0, *Coefficients<float>::makeLowPass (44100.0, 1000.0f));
+
+            AudioBuffer<float> buffer (4, 512);
+            fillRandom (buffer, getRandom());
+            AudioBlock<float> block (buffer);
+            cascade.process (ProcessContextReplacing<float> (block));
+
+            // Two channels' worth of silence, then the last two should only hold their decaying tails
+            buffer.clear();
+            auto firstTwo = block.getSubsetChannelBlock (0, 2);
+            cascade.process (ProcessContextReplacing<float> (firstTwo));
+            cascade.process (ProcessContextReplacing<float> (block));
+
+            expectLessThan (buffer.getMagnitude (2, 0, 512), 1.0e-3f);
+            expectLessThan (buffer.getMagnitude (3, 0, 512), 1.0e-3f);
+        }
+    }
+
+    // These are shared with the benchmark below
+    static constexpr int numSections = 4;
+
+    // A low shelf, two peaks and a first order high-pass, with frequencies that differ from channel to channel
+    template <typename SampleType>
+    static typename Coefficients<SampleType>::Ptr makeSection (int channel, int section)
+    {
+        const auto sampleRate = 44100.0;
+        const auto frequency = (SampleType) (200.0 * (section + 1) + 37.0 * channel);
+
+        switch (section)
+        {
+            case 0:   return Coefficients<SampleType>::makeLowShelf (sampleRate, frequency, (SampleType) 0.7, (SampleType) 2.0);
+            case 1:   return Coefficients<SampleType>::makePeakFilter (sampleRate, frequency * 4, (SampleType) 1.5, (SampleType) 0.5);
+            case 2:   return Coefficients<SampleType>::makePeakFilter (sampleRate, frequency * 10, (SampleType) 3.0, (SampleType) 1.8);
+            default:  return Coefficients<SampleType>::makeFirstOrderHighPass (sampleRate, frequency / 10);
+        }
+    }
+
+    template <typename SampleType>
+    static void fillRandom (AudioBuffer<SampleType>& buffer, Random random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, (SampleType) (random.nextDouble() * 2.0 - 1.0));
+    }
+
+private:
+    template <typename SampleType>
+    void expectChannelsMatchReference (int numChannels, double tolerance)
+    {
+        const int blockSizes[] = { 100, 37, 512, 1, 64, 300 };
+        const auto numSamples = std::accumulate (std::begin (blockSizes), std::end (blockSizes), 0);
+
+        BatchedCascade<SampleType> cascade;
+        cascade.prepare ({ 44100.0, 512, (uint32) numChannels }, numSections);
+
+        std::vector<std::vector<Filter<SampleType>>> references ((size_t) numChannels);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int section = 0; section < numSections; ++section)
+            {
+                const auto coefficients = makeSection<SampleType> (channel, section);
+                cascade.setCoefficients (channel, section, *coefficients);
+                references[(size_t) channel].emplace_back (coefficients);
+            }
+        }
+
+        AudioBuffer<SampleType> input (numChannels, numSamples), expected, actual;
+        fillRandom (input, getRandom());
+        expected.makeCopyOf (input);
+        actual.makeCopyOf (input);
+
+        int start = 0, blockIndex = 0;
+
+        for (auto blockSize : blockSizes)
+        {
+            // A bypassed block still runs through the whole cascade, so that the blocks after it match
+            const auto isBypassed = blockIndex++ == 2;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto block = AudioBlock<SampleType> (expected).getSubsetChannelBlock ((size_t) channel, 1)
+                                                              .getSubBlock ((size_t) start, (size_t) blockSize);
+                AudioBuffer<SampleType> filtered (1, blockSize);
+                AudioBlock<SampleType> filteredBlock (filtered);
+                filteredBlock.copyFrom (block);
+
+                for (auto& filter : references[(size_t) channel])
+                    filter.process (ProcessContextReplacing<SampleType> (filteredBlock));
+
+                if (! isBypassed)
+                    block.copyFrom (filteredBlock);
+            }
+
+            auto block = AudioBlock<SampleType> (actual).getSubBlock ((size_t) start, (size_t) blockSize);
+            ProcessContextReplacing<SampleType> context (block);
+            context.isBypassed = isBypassed;
+            cascade.process (context);
+
+            start += blockSize;
+        }
+
+        auto biggestDifference = 0.0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                biggestDifference = jmax (biggestDifference, (double) std::abs (expected.getSample (channel, i) - actual.getSample (channel, i)));
+
+        expectLessOrEqual (biggestDifference, tolerance, String (numChannels) + " channels");
+    }
+};
+
+static BatchedCascadeTest batchedCascadeUnitTest;
+
+//==============================================================================
+class BatchedCascadeBenchmark final : public UnitTestBenchmark
+{
+public:
+    BatchedCascadeBenchmark()
+        : UnitTestBenchmark ("IIR Batched Cascade Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost per channel");
+
+        for (auto numChannels : { 2, 8, 32 })
+        {
+            const auto reference = measureNanosecondsPerSample<float> (numChannels, false);
+            const auto batched   = measureNanosecondsPerSample<float> (numChannels, true);
+
+            logMessage (String (numChannels) + " channels of 4 sections: IIR::Filter " + String (reference, 2)
+                          + " ns, BatchedCascade " + String (batched, 2) + " ns per sample per channel");
+        }
+    }
+
+private:
+    using Tests = BatchedCascadeTest;
+
+    template <typename SampleType>
+    double measureNanosecondsPerSample (int numChannels, bool batched)
+    {
+        constexpr int blockSize = 512, numBlocks = 40, numRounds = 5;
+
+        BatchedCascade<SampleType> cascade;
+        cascade.prepare ({ 44100.0, (uint32) blockSize, (uint32) numChannels }, Tests::numSections);
+
+        std::vector<std::vector<Filter<SampleType>>> filters ((size_t) numChannels);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int section = 0; section < Tests::numSections; ++section)
+            {
+                const auto coefficients = Tests::makeSection<SampleType> (channel, section);
+                cascade.setCoefficients (channel, section, *coefficients);
+                filters[(size_t) channel].emplace_back (coefficients);
+            }
+        }
+
+        AudioBuffer<SampleType> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        Tests::fillRandom (input, getRandom());
+
+        const auto seconds = measureFastestSeconds (numRounds, [&]
+        {
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.makeCopyOf (input, true);
+                AudioBlock<SampleType> block (buffer);
+
+                if (batched)
+                {
+                    cascade.process (ProcessContextReplacing<SampleType> (block));
+                    continue;
+                }
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    auto channelBlock = block.getSingleChannelBlock ((size_t) channel);
+
+                    for (auto& filter : filters[(size_t) channel])
+                        filter.process (ProcessContextReplacing<SampleType> (channelBlock));
+                }
+            }
+        });
+
+        return seconds * 1.0e9 / (double) (numBlocks * blockSize * numChannels);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static BatchedCascadeBenchmark batchedCascadeBenchmark;
+#endif
+
+} // namespace juce::dsp::IIR
@@ -38,6 +38,13 @@ namespace juce::dsp
 /**
     Processor wrapper around juce::Reverb for easy integration into ProcessorChain.
 
+    Mono and stereo blocks go through a single juce::Reverb. When the processor is
+    prepared for more than two channels, each pair of channels gets its own reverb
+    instead, and the pairs are all processed together in a ReverbBank. With an odd
+    number of channels, the last one is processed as mono.
+
+    @see ReverbBank
+
     @tags{DSP}
 */
 class Reverb
@@ -57,7 +64,13 @@ public:
         Note that this doesn't attempt to lock the reverb, so if you call this in parallel with
         the process method, you may get artifacts.
     */
-    void setParameters (const Parameters& newParams)    { reverb.setParameters (newParams); }
+    void setParameters (const Parameters& newParams)
+    {
+        reverb.setParameters (newParams);
+
+        for (int i = 0; i < bank.getNumInstances(); ++i)
+            bank.setParameters (i, newParams);
+    }
 
     /** Returns true if the reverb is enabled. */
     bool isEnabled() const noexcept                     { return enabled; }
@@ -70,12 +83,19 @@ public:
     void prepare (const ProcessSpec& spec)
     {
         reverb.setSampleRate (spec.sampleRate);
+
+        const auto numPairs = spec.numChannels > 2 ? (int) (spec.numChannels + 1) / 2 : 0;
+        bank.prepare (spec.sampleRate, numPairs);
+        leftChannels .resize ((size_t) numPairs);
+        rightChannels.resize ((size_t) numPairs);
+        setParameters (getParameters());
     }
 
     /** Resets the reverb's internal state. */
     void reset() noexcept
     {
         reverb.reset();
+        bank.reset();
     }
 
     //==============================================================================
@@ -106,6 +126,18 @@ public:
                                   outputBlock.getChannelPointer (1),
                                   (int) numSamples);
         }
+        else if (numInChannels == numOutChannels && numOutChannels > 2
+                 && (int) (numOutChannels + 1) / 2 == bank.getNumInstances())
+        {
+            for (size_t pair = 0; pair < leftChannels.size(); ++pair)
+            {
+                leftChannels[pair]  = outputBlock.getChannelPointer (pair * 2);
+                rightChannels[pair] = pair * 2 + 1 < numOutChannels ? outputBlock.getChannelPointer (pair * 2 + 1)
+                                                                    : nullptr;
+            }
+
+            bank.processStereo (leftChannels.data(), rightChannels.data(), (int) numSamples);
+        }
         else
         {
             jassertfalse;   // invalid channel configuration
@@ -115,6 +147,8 @@ public:
 private:
     //==============================================================================
     juce::Reverb reverb;
+    ReverbBank bank;
+    std::vector<float*> leftChannels, rightChannels;
     bool enabled = true;
 };
 
@@ -0,0 +1,434 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+ReverbBank::Instance::Instance()
+{
+    setParameters (Parameters());
+    setSampleRate (44100.0);
+}
+
+void ReverbBank::Instance::setParameters (const Parameters& newParams)
+{
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+    const float roomScaleFactor = 0.28f;
+    const float roomOffset = 0.7f;
+    const float dampScaleFactor = 0.4f;
+
+    const float wet = newParams.wetLevel * wetScaleFactor;
+    dryGain.setTargetValue (newParams.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue (0.5f * wet * (1.0f + newParams.width));
+    wetGain2.setTargetValue (0.5f * wet * (1.0f - newParams.width));
+
+    const auto frozen = newParams.freezeMode >= 0.5f;
+    gain = frozen ? 0.0f : 0.015f;
+    damping.setTargetValue (frozen ? 0.0f : newParams.damping * dampScaleFactor);
+    feedback.setTargetValue (frozen ? 1.0f : newParams.roomSize * roomScaleFactor + roomOffset);
+
+    parameters = newParams;
+}
+
+void ReverbBank::Instance::setSampleRate (const double sampleRate)
+{
+    const double smoothTime = 0.01;
+    damping .reset (sampleRate, smoothTime);
+    feedback.reset (sampleRate, smoothTime);
+    dryGain .reset (sampleRate, smoothTime);
+    wetGain1.reset (sampleRate, smoothTime);
+    wetGain2.reset (sampleRate, smoothTime);
+}
+
+//==============================================================================
+ReverbBank::ReverbBank()
+{
+    prepare (44100.0, 0);
+}
+
+const ReverbBank::Parameters& ReverbBank::getParameters (const int instance) const noexcept
+{
+    jassert (isPositiveAndBelow (instance, getNumInstances()));
+    return instances[(size_t) instance].parameters;
+}
+
+void ReverbBank::setParameters (const int instance, const Parameters& newParams)
+{
+    jassert (isPositiveAndBelow (instance, getNumInstances()));
+    instances[(size_t) instance].setParameters (newParams);
+}
+
+//==============================================================================
+void ReverbBank::prepare (const double sampleRate, const int numInstances)
+{
+    jassert (sampleRate > 0 && numInstances >= 0);
+
+    static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
+    static const short allPassTunings[] = { 556, 441, 341, 225 };
+    const int stereoSpread = 23;
+    const int intSampleRate = (int) sampleRate;
+
+    instances.resize ((size_t) numInstances);
+
+    for (auto& instance : instances)
+        instance.setSampleRate (sampleRate);
+
+    numLanes = (numInstances + lanesPerRegister - 1) / lanesPerRegister * lanesPerRegister;
+
+    size_t numFrames = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int i = 0; i < numCombs; ++i)
+        {
+            combs[channel][i] = { nullptr, (intSampleRate * (combTunings[i] + channel * stereoSpread)) / 44100, 0 };
+            numFrames += (size_t) combs[channel][i].size;
+        }
+
+        for (int i = 0; i < numAllPasses; ++i)
+        {
+            allPasses[channel][i] = { nullptr, (intSampleRate * (allPassTunings[i] + channel * stereoSpread)) / 44100, 0 };
+            numFrames += (size_t) allPasses[channel][i].size;
+        }
+    }
+
+    // Every block below is a whole number of frames, so each of them stays aligned to a register
+    const auto frameSize = (size_t) numLanes;
+    const auto alignment = (size_t) lanesPerRegister * sizeof (float);
+    numStateValues = (numFrames + numChannels * numCombs) * frameSize;
+    const auto numScratchValues = (size_t) maxBlockSize * (3 + numChannels) * frameSize;
+
+    storage.calloc ((numStateValues + numScratchValues) * sizeof (float) + alignment);
+    auto* next = snapPointerToAlignment (unalignedPointerCast<float*> (storage.get()), alignment);
+
+    auto take = [&next] (size_t numValues)
+    {
+        auto* block = next;
+        next += numValues;
+        return block;
+    };
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (auto& comb : combs[channel])
+            comb.frames = take ((size_t) comb.size * frameSize);
+
+        for (auto& allPass : allPasses[channel])
+            allPass.frames = take ((size_t) allPass.size * frameSize);
+    }
+
+    combLast = take (numChannels * numCombs * frameSize);
+
+    inputFrames    = take (maxBlockSize * frameSize);
+    dampingFrames  = take (maxBlockSize * frameSize);
+    feedbackFrames = take (maxBlockSize * frameSize);
+
+    for (auto& output : outputFrames)
+        output = take (maxBlockSize * frameSize);
+
+    dryRamps .calloc ((size_t) numInstances * maxBlockSize);
+    wet1Ramps.calloc ((size_t) numInstances * maxBlockSize);
+    wet2Ramps.calloc ((size_t) numInstances * maxBlockSize);
+}
+
+void ReverbBank::reset() noexcept
+{
+    if (numStateValues > 0)
+        FloatVectorOperations::clear (combs[0][0].frames, numStateValues);
+}
+
+void ReverbBank::reset (const int instance) noexcept
+{
+    jassert (isPositiveAndBelow (instance, getNumInstances()));
+
+    auto clearLane = [this, instance] (float* frames, int numFrames)
+    {
+        for (int i = 0; i < numFrames; ++i)
+            frames[i * numLanes + instance] = 0.0f;
+    };
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (auto& comb : combs[channel])
+            clearLane (comb.frames, comb.size);
+
+        for (auto& allPass : allPasses[channel])
+            clearLane (allPass.frames, allPass.size);
+    }
+
+    clearLane (combLast, numChannels * numCombs);
+}
+
+//==============================================================================
+void ReverbBank::processStereo (float* const* left, float* const* right, const int numSamples) noexcept
+{
+    jassert (left != nullptr && right != nullptr);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+        processBlock (left, right, start, jmin ((int) maxBlockSize, numSamples - start));
+}
+
+void ReverbBank::processMono (float* const* samples, const int numSamples) noexcept
+{
+    jassert (samples != nullptr);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+        processBlock (samples, nullptr, start, jmin ((int) maxBlockSize, numSamples - start));
+}
+
+void ReverbBank::processBlock (float* const* left, float* const* right, const int start, const int numSamples) noexcept
+{
+    prepareBlock (left, right, start, numSamples);
+
+    // The right-hand network is only needed when at least one instance is stereo
+    for (int channel = 0; channel < (anyStereo ? 2 : 1); ++channel)
+    {
+        processCombs (channel, numSamples);
+        processAllPasses (channel, numSamples);
+    }
+
+    writeOutput (left, right, start, numSamples);
+}
+
+void ReverbBank::prepareBlock (float* const* left, float* const* right, const int start, const int numSamples) noexcept
+{
+    auto fillRamp = [numSamples] (SmoothedValue<float>& value, float* dest, int stride)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i * stride] = value.getNextValue();
+    };
+
+    anyStereo = false;
+
+    for (int k = 0; k < getNumInstances(); ++k)
+    {
+        auto& instance = instances[(size_t) k];
+        const auto* l = left[k];
+        const auto* r = right != nullptr ? right[k] : nullptr;
+
+        fillRamp (instance.damping,  dampingFrames + k, numLanes);
+        fillRamp (instance.feedback, feedbackFrames + k, numLanes);
+        fillRamp (instance.dryGain,  dryRamps + k * maxBlockSize, 1);
+        fillRamp (instance.wetGain1, wet1Ramps + k * maxBlockSize, 1);
+
+        // Like juce::Reverb::processMono(), a mono instance leaves its cross-channel gain alone
+        if (r != nullptr)
+            fillRamp (instance.wetGain2, wet2Ramps + k * maxBlockSize, 1);
+
+        auto* input = inputFrames + k;
+
+        if (l == nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                input[i * numLanes] = 0.0f;
+        }
+        else if (r == nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                input[i * numLanes] = l[start + i] * instance.gain;
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                input[i * numLanes] = (l[start + i] + r[start + i]) * instance.gain;
+
+            anyStereo = true;
+        }
+    }
+}
+
+void ReverbBank::processCombs (const int channel, const int numSamples) noexcept
+{
+    auto* const output = outputFrames[channel];
+    FloatVectorOperations::clear (output, numSamples * numLanes);
+
+    // Combs are added to the output one after another, which is the order juce::Reverb sums them in
+    for (int j = 0; j < numCombs; ++j)
+    {
+        auto& comb = combs[channel][j];
+        auto* const last = combLast + (channel * numCombs + j) * numLanes;
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto num = jmin (numSamples - start, comb.size - comb.index);
+            auto* const frames = comb.frames + comb.index * numLanes;
+
+            for (int lane = 0; lane < numLanes; lane += lanesPerRegister)
+            {
+               #if JUCE_USE_SIMD
+                using Vec = SIMDRegister<float>;
+                auto lastValue = Vec::fromRawArray (last + lane);
+
+                for (int i = 0; i < num; ++i)
+                {
+                    const auto frame = i * numLanes + lane;
+                    const auto scratch = (start + i) * numLanes + lane;
+
+                    const auto delayed = Vec::fromRawArray (frames + frame);
+                    const auto damp = Vec::fromRawArray (dampingFrames + scratch);
+
+                    lastValue = (delayed * (Vec::expand (1.0f) - damp)) + (lastValue * damp);
+                    JUCE_UNDENORMALISE (lastValue);
+
+                    auto temp = Vec::fromRawArray (inputFrames + scratch) + (lastValue * Vec::fromRawArray (feedbackFrames + scratch));
+                    JUCE_UNDENORMALISE (temp);
+                    temp.copyToRawArray (frames + frame);
+
+                    (Vec::fromRawArray (output + scratch) + delayed).copyToRawArray (output + scratch);
+                }
+
+                lastValue.copyToRawArray (last + lane);
+               #else
+                for (int l = lane; l < lane + lanesPerRegister; ++l)
+                {
+                    for (int i = 0; i < num; ++i)
+                    {
+                        const auto frame = i * numLanes + l;
+                        const auto scratch = (start + i) * numLanes + l;
+
+                        const float delayed = frames[frame];
+                        const float damp = dampingFrames[scratch];
+
+                        last[l] = (delayed * (1.0f - damp)) + (last[l] * damp);
+                        JUCE_UNDENORMALISE (last[l]);
+
+                        float temp = inputFrames[scratch] + (last[l] * feedbackFrames[scratch]);
+                        JUCE_UNDENORMALISE (temp);
+                        frames[frame] = temp;
+
+                        output[scratch] += delayed;
+                    }
+                }
+               #endif
+            }
+
+            if ((comb.index += num) == comb.size)
+                comb.index = 0;
+
+            start += num;
+        }
+    }
+}
+
+void ReverbBank::processAllPasses (const int channel, const int numSamples) noexcept
+{
+    auto* const output = outputFrames[channel];
+
+    for (auto& allPass : allPasses[channel])
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const auto num = jmin (numSamples - start, allPass.size - allPass.index);
+
+            // Both runs are contiguous frames, so the lanes and samples can be walked as one flat array
+            auto* const frames = allPass.frames + allPass.index * numLanes;
+            auto* const io = output + start * numLanes;
+            const auto numValues = num * numLanes;
+
+           #if JUCE_USE_SIMD
+            using Vec = SIMDRegister<float>;
+
+            for (int v = 0; v < numValues; v += lanesPerRegister)
+            {
+                const auto input = Vec::fromRawArray (io + v);
+                const auto bufferedValue = Vec::fromRawArray (frames + v);
+
+                auto temp = input + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                temp.copyToRawArray (frames + v);
+
+                (bufferedValue - input).copyToRawArray (io + v);
+            }
+           #else
+            for (int v = 0; v < numValues; ++v)
+            {
+                const float bufferedValue = frames[v];
+                float temp = io[v] + (bufferedValue * 0.5f);
+                JUCE_UNDENORMALISE (temp);
+                frames[v] = temp;
+                io[v] = bufferedValue - io[v];
+            }
+           #endif
+
+            if ((allPass.index += num) == allPass.size)
+                allPass.index = 0;
+
+            start += num;
+        }
+    }
+}
+
+void ReverbBank::writeOutput (float* const* left, float* const* right, const int start, const int numSamples) noexcept
+{
+    for (int k = 0; k < getNumInstances(); ++k)
+    {
+        auto* l = left[k];
+        auto* r = right != nullptr ? right[k] : nullptr;
+
+        if (l == nullptr)
+            continue;
+
+        l += start;
+
+        const auto* outputL = outputFrames[0] + k;
+        const auto* dry  = dryRamps  + k * maxBlockSize;
+        const auto* wet1 = wet1Ramps + k * maxBlockSize;
+
+        if (r == nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                l[i] = outputL[i * numLanes] * wet1[i] + l[i] * dry[i];
+
+            continue;
+        }
+
+        r += start;
+
+        const auto* outputR = outputFrames[1] + k;
+        const auto* wet2 = wet2Ramps + k * maxBlockSize;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto outL = outputL[i * numLanes];
+            const auto outR = outputR[i * numLanes];
+
+            l[i] = outL * wet1[i] + outR * wet2[i] + l[i] * dry[i];
+            r[i] = outR * wet1[i] + outL * wet2[i] + r[i] * dry[i];
+        }
+    }
+}
+
+} // namespace juce::dsp
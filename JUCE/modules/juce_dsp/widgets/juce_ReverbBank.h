@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    Runs a set of independent FreeVerb reverbs side by side.
+
+    Each instance behaves exactly like a juce::Reverb with its own parameters, but
+    rather than processing the instances one after another, the bank interleaves
+    them so that each lane of a SIMDRegister holds the same comb or all-pass filter
+    for a different instance. Because every instance uses the same tunings, the
+    delay lines of all instances share one layout and advance together, so a
+    filter can be run for a whole register of instances with aligned loads and
+    stores. Throughput scales with the register width, which makes the bank a good
+    fit for many voices or sends, or for the channel pairs of a multichannel signal.
+
+    All instances are processed on every call. An instance whose channel pointers
+    are null is fed silence and its output is discarded, so its tail keeps decaying.
+
+    @see juce::Reverb, Reverb, ReverbBankAudioSource
+
+    @tags{DSP}
+*/
+class ReverbBank
+{
+public:
+    //==============================================================================
+    /** Creates an empty bank. Call prepare() before first use. */
+    ReverbBank();
+
+    //==============================================================================
+    /** The parameters are the same as the ones used by juce::Reverb. */
+    using Parameters = juce::Reverb::Parameters;
+
+    /** Returns the current parameters of one of the instances. */
+    const Parameters& getParameters (int instance) const noexcept;
+
+    /** Applies a new set of parameters to one of the instances.
+        Note that this doesn't attempt to lock the bank, so if you call this in parallel with
+        the process methods, you may get artifacts.
+    */
+    void setParameters (int instance, const Parameters& newParams);
+
+    //==============================================================================
+    /** Allocates the given number of instances for a sample rate, clearing their state.
+        Instances that already existed keep their parameters; new ones get the defaults.
+    */
+    void prepare (double sampleRate, int numInstances);
+
+    /** Returns the number of instances the bank was prepared for. */
+    int getNumInstances() const noexcept                { return (int) instances.size(); }
+
+    /** Clears the buffers of all the instances. */
+    void reset() noexcept;
+
+    /** Clears the buffers of a single instance, leaving the others untouched. */
+    void reset (int instance) noexcept;
+
+    //==============================================================================
+    /** Applies each instance to its own pair of channels.
+
+        Both arrays must hold getNumInstances() pointers. An instance with a null right
+        channel is processed like juce::Reverb::processMono(), and one with a null left
+        channel is fed silence.
+    */
+    void processStereo (float* const* left, float* const* right, int numSamples) noexcept;
+
+    /** Applies each instance to a single mono channel.
+        The array must hold getNumInstances() pointers, which may be null.
+    */
+    void processMono (float* const* samples, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    enum { numCombs = 8, numAllPasses = 4, numChannels = 2, maxBlockSize = 64 };
+
+   #if JUCE_USE_SIMD
+    static constexpr int lanesPerRegister = (int) SIMDRegister<float>::SIMDNumElements;
+   #else
+    static constexpr int lanesPerRegister = 4;
+   #endif
+
+    struct Instance
+    {
+        Instance();
+
+        void setParameters (const Parameters& newParams);
+        void setSampleRate (double sampleRate);
+
+        Parameters parameters;
+        float gain = 0.015f;
+        SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
+    };
+
+    // A delay line holding one frame of numLanes samples per step
+    struct DelayLine
+    {
+        float* frames = nullptr;
+        int size = 0, index = 0;
+    };
+
+    void processBlock (float* const* left, float* const* right, int start, int numSamples) noexcept;
+    void prepareBlock (float* const* left, float* const* right, int start, int numSamples) noexcept;
+    void processCombs (int channel, int numSamples) noexcept;
+    void processAllPasses (int channel, int numSamples) noexcept;
+    void writeOutput (float* const* left, float* const* right, int start, int numSamples) noexcept;
+
+    //==============================================================================
+    std::vector<Instance> instances;
+
+    // The number of instances rounded up to whole registers; the spare lanes carry silence
+    int numLanes = 0;
+
+    // The delay lines and comb states come first in the storage, so that they can be cleared in one go
+    HeapBlock<char> storage;
+    size_t numStateValues = 0;
+    DelayLine combs[numChannels][numCombs], allPasses[numChannels][numAllPasses];
+    float* combLast = nullptr;
+
+    // Per-block scratch, one frame per sample: the comb input, the smoothed filter
+    // parameters, and the output of each channel's comb and all-pass network
+    float* inputFrames = nullptr;
+    float* dampingFrames = nullptr;
+    float* feedbackFrames = nullptr;
+    float* outputFrames[numChannels] = {};
+    bool anyStereo = false;
+
+    // Per-block scratch, one run of samples per instance
+    HeapBlock<float> dryRamps, wet1Ramps, wet2Ramps;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbBank)
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+ReverbBankAudioSource::ReverbBankAudioSource (const int maxNumInputs)
+    : inputs ((size_t) maxNumInputs),
+      leftChannels ((size_t) maxNumInputs),
+      rightChannels ((size_t) maxNumInputs)
+{
+    jassert (maxNumInputs > 0);
+    bank.prepare (44100.0, maxNumInputs);
+}
+
+ReverbBankAudioSource::~ReverbBankAudioSource()
+{
+    removeAllInputs();
+}
+
+//==============================================================================
+int ReverbBankAudioSource::indexOf (AudioSource* const input) const noexcept
+{
+    for (size_t i = 0; i < inputs.size(); ++i)
+        if (inputs[i].source == input)
+            return (int) i;
+
+    return -1;
+}
+
+bool ReverbBankAudioSource::addInputSource (AudioSource* input, const bool deleteWhenRemoved)
+{
+    if (input == nullptr)
+        return false;
+
+    double localRate;
+    int localBufferSize;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (indexOf (input) >= 0)
+            return true;
+
+        if (indexOf (nullptr) < 0)
+            return false;
+
+        localRate = currentSampleRate;
+        localBufferSize = bufferSizeExpected;
+    }
+
+    if (localRate > 0.0)
+        input->prepareToPlay (localBufferSize, localRate);
+
+    const ScopedLock sl (lock);
+    const auto slot = indexOf (nullptr);
+
+    if (slot < 0)
+        return false;
+
+    // A freed slot still holds the tail of whatever played there last
+    bank.reset (slot);
+    bank.setParameters (slot, {});
+    inputs[(size_t) slot] = { input, deleteWhenRemoved };
+    return true;
+}
+
+void ReverbBankAudioSource::removeInputSource (AudioSource* const input)
+{
+    if (input == nullptr)
+        return;
+
+    std::unique_ptr<AudioSource> toDelete;
+
+    {
+        const ScopedLock sl (lock);
+        const auto slot = indexOf (input);
+
+        if (slot < 0)
+            return;
+
+        if (inputs[(size_t) slot].deleteWhenRemoved)
+            toDelete.reset (input);
+
+        inputs[(size_t) slot] = {};
+    }
+
+    input->releaseResources();
+}
+
+void ReverbBankAudioSource::removeAllInputs()
+{
+    OwnedArray<AudioSource> toDelete;
+    Array<AudioSource*> removed;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& input : inputs)
+        {
+            if (input.source != nullptr)
+            {
+                removed.add (input.source);
+
+                if (input.deleteWhenRemoved)
+                    toDelete.add (input.source);
+            }
+
+            input = {};
+        }
+    }
+
+    for (auto* input : removed)
+        input->releaseResources();
+}
+
+//==============================================================================
+ReverbBank::Parameters ReverbBankAudioSource::getParameters (AudioSource* const input) const
+{
+    const ScopedLock sl (lock);
+    const auto slot = indexOf (input);
+
+    jassert (slot >= 0);
+    return slot >= 0 ? bank.getParameters (slot) : ReverbBank::Parameters();
+}
+
+void ReverbBankAudioSource::setParameters (AudioSource* const input, const ReverbBank::Parameters& newParams)
+{
+    const ScopedLock sl (lock);
+    const auto slot = indexOf (input);
+
+    jassert (slot >= 0);
+
+    if (slot >= 0)
+        bank.setParameters (slot, newParams);
+}
+
+void ReverbBankAudioSource::setBypassed (const bool b) noexcept
+{
+    if (b != bypass)
+    {
+        const ScopedLock sl (lock);
+        bank.reset();
+        bypass = b;
+    }
+}
+
+//==============================================================================
+void ReverbBankAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const ScopedLock sl (lock);
+
+    currentSampleRate = sampleRate;
+    bufferSizeExpected = samplesPerBlockExpected;
+
+    voiceBuffer.setSize (2 * (int) inputs.size(), samplesPerBlockExpected);
+    bank.prepare (sampleRate, (int) inputs.size());
+
+    for (auto& input : inputs)
+        if (input.source != nullptr)
+            input.source->prepareToPlay (samplesPerBlockExpected, sampleRate);
+}
+
+void ReverbBankAudioSource::releaseResources()
+{
+    const ScopedLock sl (lock);
+
+    for (auto& input : inputs)
+        if (input.source != nullptr)
+            input.source->releaseResources();
+
+    voiceBuffer.setSize (0, 0);
+
+    currentSampleRate = 0;
+    bufferSizeExpected = 0;
+}
+
+void ReverbBankAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const ScopedLock sl (lock);
+
+    // Every input renders into its own channels, so that the bank can process them all at once
+    const auto numChannelsPerInput = jmin (2, info.buffer->getNumChannels());
+    voiceBuffer.setSize (2 * (int) inputs.size(), info.numSamples, false, false, true);
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        leftChannels[i] = rightChannels[i] = nullptr;
+
+        if (auto* source = inputs[i].source)
+        {
+            AudioBuffer<float> channels (voiceBuffer.getArrayOfWritePointers() + 2 * i, numChannelsPerInput, info.numSamples);
+            source->getNextAudioBlock (AudioSourceChannelInfo (channels));
+
+            leftChannels[i] = channels.getWritePointer (0);
+
+            if (numChannelsPerInput > 1)
+                rightChannels[i] = channels.getWritePointer (1);
+        }
+    }
+
+    if (! bypass)
+        bank.processStereo (leftChannels.data(), rightChannels.data(), info.numSamples);
+
+    info.clearActiveBufferRegion();
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+        if (inputs[i].source != nullptr)
+            for (int channel = 0; channel < numChannelsPerInput; ++channel)
+                info.buffer->addFrom (channel, info.startSample, voiceBuffer, 2 * (int) i + channel, 0, info.numSamples);
+}
+
+} // namespace juce::dsp
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+/**
+    An AudioSource that gives each of its inputs its own reverb and mixes the results.
+
+    This does the same job as a MixerAudioSource fed by a set of ReverbAudioSources,
+    but the reverbs of all the inputs run together in a ReverbBank, which is much
+    cheaper when there are many of them. The bank is sized up front for a maximum
+    number of inputs; inputs can be added and removed while the source is running,
+    in the same way as with a MixerAudioSource.
+
+    @see ReverbBank, ReverbAudioSource, MixerAudioSource
+
+    @tags{DSP}
+*/
+class JUCE_API  ReverbBankAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a source with room for the given number of inputs. */
+    explicit ReverbBankAudioSource (int maxNumInputs);
+
+    /** Destructor. */
+    ~ReverbBankAudioSource() override;
+
+    //==============================================================================
+    /** Adds an input source, which gets a reverb of its own with the default parameters.
+
+        If the source is running you'll need to make sure that the input source is ready
+        to play by calling its prepareToPlay() method before adding it.
+
+        @param newInput             the source to add
+        @param deleteWhenRemoved    if true, then this source will be deleted when
+                                    no longer needed
+        @returns false if all the slots are already in use
+    */
+    bool addInputSource (AudioSource* newInput, bool deleteWhenRemoved);
+
+    /** Removes an input source.
+        If the source was added by calling addInputSource() with the deleteWhenRemoved
+        flag set, it will be deleted by this method.
+    */
+    void removeInputSource (AudioSource* input);
+
+    /** Removes all the input sources. */
+    void removeAllInputs();
+
+    //==============================================================================
+    /** Returns the parameters of the reverb applied to one of the inputs. */
+    ReverbBank::Parameters getParameters (AudioSource* input) const;
+
+    /** Changes the parameters of the reverb applied to one of the inputs. */
+    void setParameters (AudioSource* input, const ReverbBank::Parameters& newParams);
+
+    void setBypassed (bool isBypassed) noexcept;
+    bool isBypassed() const noexcept                            { return bypass; }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+private:
+    //==============================================================================
+    struct Input
+    {
+        AudioSource* source = nullptr;
+        bool deleteWhenRemoved = false;
+    };
+
+    int indexOf (AudioSource* input) const noexcept;
+
+    CriticalSection lock;
+    ReverbBank bank;
+    std::vector<Input> inputs;
+    AudioBuffer<float> voiceBuffer;
+    std::vector<float*> leftChannels, rightChannels;
+    double currentSampleRate = 0.0;
+    int bufferSizeExpected = 0;
+    std::atomic<bool> bypass { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbBankAudioSource)
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,402 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class ReverbBankTest final : public UnitTest
+{
+public:
+    ReverbBankTest()
+        : UnitTest ("Reverb Bank", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Every instance matches its own juce::Reverb");
+        {
+            for (auto numInstances : { 1, 5, 13 })
+                expectInstancesMatchReference (44100.0, numInstances, false);
+
+            expectInstancesMatchReference (48000.0, 6, false);
+        }
+
+        beginTest ("Parameter changes are smoothed in the same way");
+        {
+            expectInstancesMatchReference (44100.0, 7, true);
+        }
+
+        beginTest ("Resetting one instance leaves the others alone");
+        {
+            ReverbBank bank;
+            bank.prepare (44100.0, 3);
+
+            Buffers buffers (3, 2, 4096);
+            fillRandom (buffers.buffer, getRandom());
+            bank.processStereo (buffers.left.data(), buffers.right.data(), 4096);
+
+            bank.reset (1);
+
+            // Cleared through the write pointers, so that the buffer doesn't flag itself as silent
+            for (int channel = 0; channel < buffers.buffer.getNumChannels(); ++channel)
+                FloatVectorOperations::clear (buffers.buffer.getWritePointer (channel), 4096);
+            bank.processStereo (buffers.left.data(), buffers.right.data(), 4096);
+
+            expectEquals (buffers.buffer.getMagnitude (2, 0, 4096), 0.0f);
+            expectEquals (buffers.buffer.getMagnitude (3, 0, 4096), 0.0f);
+            expectGreaterThan (buffers.buffer.getMagnitude (0, 0, 4096), 0.0f);
+            expectGreaterThan (buffers.buffer.getMagnitude (4, 0, 4096), 0.0f);
+        }
+
+        beginTest ("Multichannel dsp::Reverb processes channel pairs");
+        {
+            for (auto numChannels : { 5, 6 })
+                expectMultichannelMatchesReference (numChannels);
+        }
+
+        beginTest ("ReverbBankAudioSource mixes one reverb per input");
+        {
+            expectAudioSourceMatchesReference();
+        }
+    }
+
+    // These are shared with the benchmark below
+
+    /*  One buffer holding the channels of every instance, with the pointer arrays the bank expects. */
+    struct Buffers
+    {
+        Buffers (int numInstances, int numChannelsPerInstance, int numSamples)
+            : buffer (numInstances * numChannelsPerInstance, numSamples),
+              left ((size_t) numInstances),
+              right ((size_t) numInstances)
+        {
+            for (int i = 0; i < numInstances; ++i)
+            {
+                left[(size_t) i] = buffer.getWritePointer (i * numChannelsPerInstance);
+                right[(size_t) i] = numChannelsPerInstance > 1 ? buffer.getWritePointer (i * numChannelsPerInstance + 1)
+                                                               : nullptr;
+            }
+        }
+
+        AudioBuffer<float> buffer;
+        std::vector<float*> left, right;
+    };
+
+    static void fillRandom (AudioBuffer<float>& buffer, Random random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+private:
+    static constexpr float tolerance = 1.0e-5f;
+
+    static ReverbBank::Parameters randomParameters (Random& random)
+    {
+        ReverbBank::Parameters params;
+        params.roomSize   = random.nextFloat();
+        params.damping    = random.nextFloat();
+        params.wetLevel   = random.nextFloat();
+        params.dryLevel   = random.nextFloat();
+        params.width      = random.nextFloat();
+        params.freezeMode = random.nextInt (8) == 0 ? 1.0f : 0.0f;
+        return params;
+    }
+
+    void expectBuffersMatch (const AudioBuffer<float>& expected, const AudioBuffer<float>& actual)
+    {
+        auto maxError = 0.0f;
+
+        for (int channel = 0; channel < expected.getNumChannels(); ++channel)
+            for (int i = 0; i < expected.getNumSamples(); ++i)
+                maxError = jmax (maxError, std::abs (expected.getSample (channel, i) - actual.getSample (channel, i)));
+
+        expectLessOrEqual (maxError, tolerance);
+    }
+
+    void expectInstancesMatchReference (double sampleRate, int numInstances, bool changeParameters)
+    {
+        auto random = getRandom();
+
+        // Every third instance is mono, and every fifth one has no input, which silences it
+        const auto isMono   = [] (int i) { return i % 3 == 2; };
+        const auto isSilent = [] (int i) { return i % 5 == 4; };
+
+        std::vector<juce::Reverb> references ((size_t) numInstances);
+        ReverbBank bank;
+        bank.prepare (sampleRate, numInstances);
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            const auto params = randomParameters (random);
+            references[(size_t) i].setSampleRate (sampleRate);
+            references[(size_t) i].setParameters (params);
+            bank.setParameters (i, params);
+        }
+
+        // Long enough for every comb and all-pass to wrap around several times
+        const auto numSamples = (int) sampleRate / 2;
+        Buffers actual (numInstances, 2, numSamples);
+        fillRandom (actual.buffer, getRandom());
+
+        AudioBuffer<float> expected;
+        expected.makeCopyOf (actual.buffer);
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            if (isMono (i))
+                actual.right[(size_t) i] = nullptr;
+
+            if (isSilent (i))
+                actual.left[(size_t) i] = actual.right[(size_t) i] = nullptr;
+        }
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto blockSize = jmin (numSamples - start, 1 + random.nextInt (700));
+
+            if (changeParameters && random.nextInt (4) == 0)
+            {
+                const auto instance = random.nextInt (numInstances);
+                const auto params = randomParameters (random);
+                references[(size_t) instance].setParameters (params);
+                bank.setParameters (instance, params);
+            }
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                if (isSilent (i))
+                    continue;
+
+                auto* left = expected.getWritePointer (2 * i, start);
+
+                if (isMono (i))
+                    references[(size_t) i].processMono (left, blockSize);
+                else
+                    references[(size_t) i].processStereo (left, expected.getWritePointer (2 * i + 1, start), blockSize);
+            }
+
+            std::vector<float*> left, right;
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                left.push_back (actual.left[(size_t) i] != nullptr ? actual.left[(size_t) i] + start : nullptr);
+                right.push_back (actual.right[(size_t) i] != nullptr ? actual.right[(size_t) i] + start : nullptr);
+            }
+
+            bank.processStereo (left.data(), right.data(), blockSize);
+            start += blockSize;
+        }
+
+        expectBuffersMatch (expected, actual.buffer);
+    }
+
+    void expectMultichannelMatchesReference (int numChannels)
+    {
+        constexpr int numSamples = 22050, blockSize = 512;
+        const auto numPairs = (numChannels + 1) / 2;
+
+        juce::Reverb::Parameters params;
+        params.roomSize = 0.8f;
+        params.width = 0.7f;
+
+        std::vector<juce::Reverb> references ((size_t) numPairs);
+
+        for (auto& reference : references)
+        {
+            reference.setSampleRate (44100.0);
+            reference.setParameters (params);
+        }
+
+        dsp::Reverb reverb;
+        reverb.setParameters (params);
+        reverb.prepare ({ 44100.0, (uint32) blockSize, (uint32) numChannels });
+
+        AudioBuffer<float> expected (numChannels, numSamples), actual;
+        fillRandom (expected, getRandom());
+        actual.makeCopyOf (expected);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const auto num = jmin (blockSize, numSamples - start);
+
+            for (int pair = 0; pair < numPairs; ++pair)
+            {
+                auto* left = expected.getWritePointer (2 * pair, start);
+
+                if (2 * pair + 1 < numChannels)
+                    references[(size_t) pair].processStereo (left, expected.getWritePointer (2 * pair + 1, start), num);
+                else
+                    references[(size_t) pair].processMono (left, num);
+            }
+
+            AudioBlock<float> block (actual.getArrayOfWritePointers(), (size_t) numChannels, (size_t) start, (size_t) num);
+            reverb.process (ProcessContextReplacing<float> (block));
+        }
+
+        expectBuffersMatch (expected, actual);
+    }
+
+    void expectAudioSourceMatchesReference()
+    {
+        constexpr int numInputs = 3, numSamples = 8192, blockSize = 256;
+        auto random = getRandom();
+
+        OwnedArray<AudioBuffer<float>> inputs;
+        std::vector<juce::Reverb> references (numInputs);
+        ReverbBankAudioSource source (numInputs + 1);
+        AudioBuffer<float> expected (2, numSamples);
+        expected.clear();
+
+        for (int i = 0; i < numInputs; ++i)
+        {
+            auto* input = inputs.add (new AudioBuffer<float> (2, numSamples));
+            fillRandom (*input, getRandom());
+
+            const auto params = randomParameters (random);
+            auto* memorySource = new MemoryAudioSource (*input, true);
+            expect (source.addInputSource (memorySource, true));
+            source.setParameters (memorySource, params);
+
+            AudioBuffer<float> wet;
+            wet.makeCopyOf (*input);
+            // Preparing the source jumps straight to the parameters, which setSampleRate() also does
+            references[(size_t) i].setParameters (params);
+            references[(size_t) i].setSampleRate (44100.0);
+
+            for (int start = 0; start < numSamples; start += blockSize)
+                references[(size_t) i].processStereo (wet.getWritePointer (0, start), wet.getWritePointer (1, start), blockSize);
+
+            for (int channel = 0; channel < 2; ++channel)
+                expected.addFrom (channel, 0, wet, channel, 0, numSamples);
+        }
+
+        // Fill the last slot, check that nothing more fits, then free it again
+        auto* extra = new MemoryAudioSource (*inputs[0], true);
+        MemoryAudioSource rejected (*inputs[0], true);
+        expect (source.addInputSource (extra, true));
+        expect (! source.addInputSource (&rejected, false));
+        source.removeInputSource (extra);
+
+        AudioBuffer<float> actual (2, numSamples);
+        source.prepareToPlay (blockSize, 44100.0);
+
+        for (int start = 0; start < numSamples; start += blockSize)
+            source.getNextAudioBlock (AudioSourceChannelInfo (&actual, start, blockSize));
+
+        source.releaseResources();
+        expectBuffersMatch (expected, actual);
+    }
+};
+
+static ReverbBankTest reverbBankUnitTest;
+
+//==============================================================================
+class ReverbBankBenchmark final : public UnitTestBenchmark
+{
+public:
+    ReverbBankBenchmark()
+        : UnitTestBenchmark ("Reverb Bank Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cost per instance");
+
+        for (auto numInstances : { 4, 16, 64 })
+        {
+            const auto reference = measureReferenceNanosecondsPerSample (numInstances);
+            const auto batched = measureBankNanosecondsPerSample (numInstances);
+
+            logMessage (String (numInstances) + " stereo instances: juce::Reverb " + String (reference, 2)
+                          + " ns, ReverbBank " + String (batched, 2) + " ns per sample per instance");
+        }
+    }
+
+private:
+    double measureReferenceNanosecondsPerSample (int numInstances)
+    {
+        std::vector<juce::Reverb> references ((size_t) numInstances);
+
+        for (auto& reference : references)
+            reference.setSampleRate (44100.0);
+
+        return measureNanosecondsPerSample (numInstances, [&] (ReverbBankTest::Buffers& buffers, int numSamples)
+        {
+            for (size_t i = 0; i < references.size(); ++i)
+                references[i].processStereo (buffers.left[i], buffers.right[i], numSamples);
+        });
+    }
+
+    double measureBankNanosecondsPerSample (int numInstances)
+    {
+        ReverbBank bank;
+        bank.prepare (44100.0, numInstances);
+
+        return measureNanosecondsPerSample (numInstances, [&] (ReverbBankTest::Buffers& buffers, int numSamples)
+        {
+            bank.processStereo (buffers.left.data(), buffers.right.data(), numSamples);
+        });
+    }
+
+    template <typename ProcessFn>
+    double measureNanosecondsPerSample (int numInstances, ProcessFn&& process)
+    {
+        constexpr int blockSize = 512, numBlocks = 20, numRounds = 5;
+
+        ReverbBankTest::Buffers buffers (numInstances, 2, blockSize);
+        AudioBuffer<float> input (buffers.buffer.getNumChannels(), blockSize);
+        ReverbBankTest::fillRandom (input, getRandom());
+
+        const auto seconds = measureFastestSeconds (numRounds, [&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                    buffers.buffer.copyFrom (channel, 0, input, channel, 0, blockSize);
+
+                process (buffers, blockSize);
+            }
+        });
+
+        return seconds * 1.0e9 / (double) (numBlocks * blockSize * numInstances);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static ReverbBankBenchmark reverbBankBenchmark;
+#endif
+
+} // namespace juce::dsp
@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+SIMDReverb::SIMDReverb()
+{
+    setParameters (Parameters());
+    setSampleRate (44100.0);
+}
+
+//==============================================================================
+void SIMDReverb::setParameters (const Parameters& newParams)
+{
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+
+    const float wet = newParams.wetLevel * wetScaleFactor;
+    dryGain.setTargetValue (newParams.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue (0.5f * wet * (1.0f + newParams.width));
+    wetGain2.setTargetValue (0.5f * wet * (1.0f - newParams.width));
+
+    gain = isFrozen (newParams.freezeMode) ? 0.0f : 0.015f;
+    parameters = newParams;
+    updateDamping();
+}
+
+void SIMDReverb::updateDamping() noexcept
+{
+    const float roomScaleFactor = 0.28f;
+    const float roomOffset = 0.7f;
+    const float dampScaleFactor = 0.4f;
+
+    if (isFrozen (parameters.freezeMode))
+    {
+        damping.setTargetValue (0.0f);
+        feedback.setTargetValue (1.0f);
+    }
+    else
+    {
+        damping.setTargetValue (parameters.damping * dampScaleFactor);
+        feedback.setTargetValue (parameters.roomSize * roomScaleFactor + roomOffset);
+    }
+}
+
+//==============================================================================
+void SIMDReverb::setSampleRate (const double sampleRate)
+{
+    jassert (sampleRate > 0);
+
+    static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 }; // (at 44100Hz)
+    static const short allPassTunings[] = { 556, 441, 341, 225 };
+    const int stereoSpread = 23;
+    const int intSampleRate = (int) sampleRate;
+
+    int longestComb = 0;
+    size_t totalAllPassSize = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int i = 0; i < numCombs; ++i)
+        {
+            const auto size = (intSampleRate * (combTunings[i] + channel * stereoSpread)) / 44100;
+            combSizes[channel * numCombs + i] = size;
+            longestComb = jmax (longestComb, size);
+        }
+
+        for (int i = 0; i < numAllPasses; ++i)
+        {
+            auto& allPass = allPasses[channel][i];
+            allPass.size = (intSampleRate * (allPassTunings[i] + channel * stereoSpread)) / 44100;
+            allPass.index = 0;
+            totalAllPassSize += (size_t) allPass.size;
+        }
+    }
+
+    // One spare frame, so a comb never writes to the frame that's being read
+    numCombFrames = longestComb + 1;
+    combStorage.calloc ((size_t) numCombFrames * numLanes * sizeof (float) + laneAlignment);
+    combFrames = snapPointerToAlignment (unalignedPointerCast<float*> (combStorage.get()), laneAlignment);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        combReadRows[channel] = 0;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        combWriteRows[lane] = combSizes[lane];
+
+    std::fill (std::begin (combLast), std::end (combLast), 0.0f);
+
+    allPassStorage.calloc (totalAllPassSize);
+    auto* nextAllPass = allPassStorage.get();
+
+    for (auto& channelAllPasses : allPasses)
+    {
+        for (auto& allPass : channelAllPasses)
+        {
+            allPass.samples = nextAllPass;
+            nextAllPass += allPass.size;
+        }
+    }
+
+    const double smoothTime = 0.01;
+    damping .reset (sampleRate, smoothTime);
+    feedback.reset (sampleRate, smoothTime);
+    dryGain .reset (sampleRate, smoothTime);
+    wetGain1.reset (sampleRate, smoothTime);
+    wetGain2.reset (sampleRate, smoothTime);
+}
+
+void SIMDReverb::reset()
+{
+    FloatVectorOperations::clear (combFrames, numCombFrames * numLanes);
+    std::fill (std::begin (combLast), std::end (combLast), 0.0f);
+
+    for (auto& channelAllPasses : allPasses)
+        for (auto& allPass : channelAllPasses)
+            FloatVectorOperations::clear (allPass.samples, allPass.size);
+}
+
+//==============================================================================
+template <int numActiveChannels>
+void SIMDReverb::processCombs (const float* const input, const int numSamples) noexcept
+{
+    constexpr int numActiveLanes = numActiveChannels * numCombs;
+
+   #if JUCE_USE_SIMD
+    using Vec = SIMDRegister<float>;
+    constexpr int lanesPerRegister = (int) Vec::SIMDNumElements;
+    constexpr int numRegisters = numActiveLanes / lanesPerRegister;
+    static_assert (numCombs % lanesPerRegister == 0, "Each channel's combs must fill whole registers");
+
+    Vec last[(size_t) numRegisters];
+
+    for (int r = 0; r < numRegisters; ++r)
+        last[r] = Vec::fromRawArray (combLast + r * lanesPerRegister);
+   #else
+    float* const last = combLast;
+   #endif
+
+    for (int start = 0; start < numSamples;)
+    {
+        // Runs up to the next point where a read or write row wraps around the ring
+        auto num = numSamples - start;
+
+        for (int channel = 0; channel < numActiveChannels; ++channel)
+            num = jmin (num, numCombFrames - combReadRows[channel]);
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+            num = jmin (num, numCombFrames - combWriteRows[lane]);
+
+        const float* readFrames[(size_t) numActiveChannels];
+        float* writeLanes[(size_t) numActiveLanes];
+
+        for (int channel = 0; channel < numActiveChannels; ++channel)
+            readFrames[channel] = combFrames + combReadRows[channel] * numLanes + channel * numCombs;
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+            writeLanes[lane] = combFrames + combWriteRows[lane] * numLanes + lane;
+
+        for (int i = 0; i < num; ++i)
+        {
+            const auto n = start + i;
+
+            // Summed in the same order as juce::Reverb, so the two give identical results
+            for (int channel = 0; channel < numActiveChannels; ++channel)
+            {
+                const auto* delayed = readFrames[channel] + i * numLanes;
+                float output = 0;
+
+                for (int j = 0; j < numCombs; ++j)
+                    output += delayed[j];
+
+                combOutput[channel][n] = output;
+            }
+
+            const float damp = dampingRamp[n];
+            const float undamped = 1.0f - damp;
+            const float feedbackLevel = feedbackRamp[n];
+
+           #if JUCE_USE_SIMD
+            const auto in = Vec::expand (input[n]);
+
+            for (int r = 0; r < numRegisters; ++r)
+            {
+                const auto lane = r * lanesPerRegister;
+                const auto channel = lane / numCombs;
+                const auto output = Vec::fromRawArray (readFrames[channel] + i * numLanes + lane % numCombs);
+
+                last[r] = (output * undamped) + (last[r] * damp);
+                JUCE_UNDENORMALISE (last[r]);
+
+                auto temp = in + (last[r] * feedbackLevel);
+                JUCE_UNDENORMALISE (temp);
+                temp.copyToRawArray (combWritten + lane);
+            }
+           #else
+            for (int lane = 0; lane < numActiveLanes; ++lane)
+            {
+                const auto output = readFrames[lane / numCombs][i * numLanes + lane % numCombs];
+
+                last[lane] = (output * undamped) + (last[lane] * damp);
+                JUCE_UNDENORMALISE (last[lane]);
+
+                float temp = input[n] + (last[lane] * feedbackLevel);
+                JUCE_UNDENORMALISE (temp);
+                combWritten[lane] = temp;
+            }
+           #endif
+
+            for (int lane = 0; lane < numActiveLanes; ++lane)
+                writeLanes[lane][i * numLanes] = combWritten[lane];
+        }
+
+        for (int channel = 0; channel < numActiveChannels; ++channel)
+            if ((combReadRows[channel] += num) == numCombFrames)
+                combReadRows[channel] = 0;
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+            if ((combWriteRows[lane] += num) == numCombFrames)
+                combWriteRows[lane] = 0;
+
+        start += num;
+    }
+
+   #if JUCE_USE_SIMD
+    for (int r = 0; r < numRegisters; ++r)
+        last[r].copyToRawArray (combLast + r * lanesPerRegister);
+   #endif
+}
+
+void SIMDReverb::processStereo (float* const left, float* const right, const int numSamples) noexcept
+{
+    jassert (left != nullptr && right != nullptr);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const auto blockSize = jmin ((int) maxBlockSize, numSamples - start);
+        auto* blockLeft  = left  + start;
+        auto* blockRight = right + start;
+
+        fillRamps (blockSize, true);
+
+        FloatVectorOperations::add (combInput, blockLeft, blockRight, blockSize);
+        FloatVectorOperations::multiply (combInput, gain, blockSize);
+
+        processCombs<2> (combInput, blockSize);
+        processAllPasses (0, combOutput[0], blockSize);
+        processAllPasses (1, combOutput[1], blockSize);
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const auto outL = combOutput[0][i];
+            const auto outR = combOutput[1][i];
+
+            blockLeft[i]  = outL * wet1Ramp[i] + outR * wet2Ramp[i] + blockLeft[i]  * dryRamp[i];
+            blockRight[i] = outR * wet1Ramp[i] + outL * wet2Ramp[i] + blockRight[i] * dryRamp[i];
+        }
+    }
+}
+
+void SIMDReverb::processMono (float* const samples, const int numSamples) noexcept
+{
+    jassert (samples != nullptr);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const auto blockSize = jmin ((int) maxBlockSize, numSamples - start);
+        auto* block = samples + start;
+
+        fillRamps (blockSize, false);
+        FloatVectorOperations::multiply (combInput, block, gain, blockSize);
+
+        processCombs<1> (combInput, blockSize);
+        processAllPasses (0, combOutput[0], blockSize);
+
+        for (int i = 0; i < blockSize; ++i)
+            block[i] = combOutput[0][i] * wet1Ramp[i] + block[i] * dryRamp[i];
+    }
+}
+
+//==============================================================================
+void SIMDReverb::fillRamps (const int numSamples, const bool needsCrossGain) noexcept
+{
+    auto fill = [numSamples] (SmoothedValue<float>& value, float* dest)
+    {
+        if (value.isSmoothing())
+        {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = value.getNextValue();
+        }
+        else
+        {
+            FloatVectorOperations::fill (dest, value.getTargetValue(), numSamples);
+        }
+    };
+
+    fill (damping, dampingRamp);
+    fill (feedback, feedbackRamp);
+    fill (dryGain, dryRamp);
+    fill (wetGain1, wet1Ramp);
+
+    // processMono() never uses the cross-channel gain, so like juce::Reverb it doesn't advance it
+    if (needsCrossGain)
+        fill (wetGain2, wet2Ramp);
+}
+
+void SIMDReverb::processAllPasses (const int channel, float* const samples, const int numSamples) noexcept
+{
+    // Each sample only touches its own slot in the delay buffer, so a filter can take a whole run at once
+    for (auto& allPass : allPasses[channel])
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            const auto num = jmin (numSamples - start, allPass.size - allPass.index);
+            auto* const buffer = allPass.samples + allPass.index;
+            auto* const io = samples + start;
+
+            // temp = input + buffered * 0.5, and the output is buffered - input
+            FloatVectorOperations::copy (allPassScratch, io, num);
+            FloatVectorOperations::addWithMultiply (allPassScratch, buffer, 0.5f, num);
+           #if JUCE_INTEL
+            FloatVectorOperations::add (allPassScratch, 0.1f, num);
+            FloatVectorOperations::add (allPassScratch, -0.1f, num);
+           #endif
+            FloatVectorOperations::subtract (io, buffer, io, num);
+            FloatVectorOperations::copy (buffer, allPassScratch, num);
+
+            if ((allPass.index += num) == allPass.size)
+                allPass.index = 0;
+
+            start += num;
+        }
+    }
+}
+
+} // namespace juce::dsp
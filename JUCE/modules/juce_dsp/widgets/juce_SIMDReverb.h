@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    A vectorised version of juce::Reverb.
+
+    This runs the same FreeVerb network with the same tunings as juce::Reverb, but the
+    comb filters of both channels are treated as lanes of SIMDRegisters rather than
+    being processed one after another. The combs share a single ring buffer made of
+    frames holding one sample for every comb, and each comb writes its input into the
+    frame it will be read back from, so that a whole frame of comb outputs can be loaded
+    with a couple of aligned reads. The all-pass stages and the parameter smoothing are
+    evaluated a block at a time instead of once per sample.
+
+    The output matches juce::Reverb to within floating point rounding, so it can be used
+    as a drop-in replacement for it.
+
+    @see juce::Reverb, Reverb
+
+    @tags{DSP}
+*/
+class SIMDReverb
+{
+public:
+    //==============================================================================
+    /** Creates a reverb with the default parameters and a sample rate of 44100 Hz. */
+    SIMDReverb();
+
+    //==============================================================================
+    /** The parameters are the same as the ones used by juce::Reverb. */
+    using Parameters = juce::Reverb::Parameters;
+
+    /** Returns the reverb's current parameters. */
+    const Parameters& getParameters() const noexcept    { return parameters; }
+
+    /** Applies a new set of parameters to the reverb.
+        Note that this doesn't attempt to lock the reverb, so if you call this in parallel with
+        the process method, you may get artifacts.
+    */
+    void setParameters (const Parameters& newParams);
+
+    //==============================================================================
+    /** Sets the sample rate that will be used for the reverb.
+        You must call this before the process methods, in order to tell it the correct sample rate.
+    */
+    void setSampleRate (double sampleRate);
+
+    /** Clears the reverb's buffers. */
+    void reset();
+
+    //==============================================================================
+    /** Applies the reverb to two stereo channels of audio data. */
+    void processStereo (float* left, float* right, int numSamples) noexcept;
+
+    /** Applies the reverb to a single mono channel of audio data. */
+    void processMono (float* samples, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    enum { numCombs = 8, numAllPasses = 4, numChannels = 2, numLanes = numCombs * numChannels, maxBlockSize = 256 };
+
+   #if JUCE_USE_SIMD
+    static constexpr size_t laneAlignment = SIMDRegister<float>::SIMDRegisterSize;
+   #else
+    static constexpr size_t laneAlignment = 16;
+   #endif
+
+    struct AllPass
+    {
+        float* samples = nullptr;
+        int size = 0, index = 0;
+    };
+
+    static bool isFrozen (float freezeMode) noexcept  { return freezeMode >= 0.5f; }
+
+    void updateDamping() noexcept;
+    void fillRamps (int numSamples, bool needsCrossGain) noexcept;
+    void processAllPasses (int channel, float* samples, int numSamples) noexcept;
+
+    template <int numActiveChannels>
+    void processCombs (const float* input, int numSamples) noexcept;
+
+    //==============================================================================
+    Parameters parameters;
+    float gain = 0.015f;
+
+    // Lane n of a frame holds comb (n % numCombs) of channel (n / numCombs). Each channel reads
+    // one frame per sample, and each comb writes a whole comb length ahead of its channel's read row.
+    HeapBlock<char> combStorage;
+    float* combFrames = nullptr;
+    int numCombFrames = 0;
+    int combSizes[numLanes] = {}, combReadRows[numChannels] = {}, combWriteRows[numLanes] = {};
+    alignas (laneAlignment) float combLast[numLanes] = {};
+    alignas (laneAlignment) float combWritten[numLanes] = {};
+
+    HeapBlock<float> allPassStorage;
+    AllPass allPasses[numChannels][numAllPasses];
+
+    SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
+
+    // Per-block scratch: the smoothed parameters and the summed comb outputs of each channel
+    float dampingRamp[maxBlockSize], feedbackRamp[maxBlockSize], dryRamp[maxBlockSize],
+          wet1Ramp[maxBlockSize], wet2Ramp[maxBlockSize], combInput[maxBlockSize],
+          allPassScratch[maxBlockSize], combOutput[numChannels][maxBlockSize];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SIMDReverb)
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class SIMDReverbTest final : public UnitTest
+{
+public:
+    SIMDReverbTest()
+        : UnitTest ("SIMD Reverb", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Stereo output matches juce::Reverb");
+        {
+            for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+                expectMatchesReference (sampleRate, 2, false);
+        }
+
+        beginTest ("Mono output matches juce::Reverb");
+        {
+            for (auto sampleRate : { 44100.0, 48000.0 })
+                expectMatchesReference (sampleRate, 1, false);
+        }
+
+        beginTest ("Parameter changes are smoothed in the same way");
+        {
+            expectMatchesReference (44100.0, 2, true);
+            expectMatchesReference (44100.0, 1, true);
+        }
+
+        beginTest ("Reset clears the tail");
+        {
+            SIMDReverb reverb;
+            AudioBuffer<float> buffer (2, 4096);
+            fillRandom (buffer, getRandom());
+            reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+
+            reverb.reset();
+            buffer.clear();
+            reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+
+            expectEquals (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+        }
+    }
+
+    // These are shared with the benchmark below
+    static void fillRandom (AudioBuffer<float>& buffer, Random random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    template <typename ReverbType>
+    static void process (ReverbType& reverb, AudioBuffer<float>& buffer, int start, int numSamples)
+    {
+        if (buffer.getNumChannels() == 1)
+            reverb.processMono (buffer.getWritePointer (0, start), numSamples);
+        else
+            reverb.processStereo (buffer.getWritePointer (0, start), buffer.getWritePointer (1, start), numSamples);
+    }
+
+private:
+    static constexpr float tolerance = 1.0e-5f;
+
+    void expectMatchesReference (double sampleRate, int numChannels, bool changeParameters)
+    {
+        juce::Reverb reference;
+        SIMDReverb reverb;
+
+        reference.setSampleRate (sampleRate);
+        reverb.setSampleRate (sampleRate);
+
+        // Long enough for every comb and all-pass to wrap around several times
+        const auto numSamples = (int) sampleRate;
+        AudioBuffer<float> expected (numChannels, numSamples);
+        fillRandom (expected, getRandom());
+
+        AudioBuffer<float> actual;
+        actual.makeCopyOf (expected);
+
+        auto random = getRandom();
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto blockSize = jmin (numSamples - start, 1 + random.nextInt (700));
+
+            if (changeParameters && random.nextInt (4) == 0)
+            {
+                juce::Reverb::Parameters params;
+                params.roomSize   = random.nextFloat();
+                params.damping    = random.nextFloat();
+                params.wetLevel   = random.nextFloat();
+                params.dryLevel   = random.nextFloat();
+                params.width      = random.nextFloat();
+                params.freezeMode = random.nextInt (8) == 0 ? 1.0f : 0.0f;
+
+                reference.setParameters (params);
+                reverb.setParameters (params);
+            }
+
+            process (reference, expected, start, blockSize);
+            process (reverb, actual, start, blockSize);
+            start += blockSize;
+        }
+
+        auto maxError = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, std::abs (expected.getSample (channel, i) - actual.getSample (channel, i)));
+
+        expectLessOrEqual (maxError, tolerance);
+    }
+};
+
+static SIMDReverbTest simdReverbUnitTest;
+
+//==============================================================================
+class SIMDReverbBenchmark final : public UnitTestBenchmark
+{
+public:
+    SIMDReverbBenchmark()
+        : UnitTestBenchmark ("SIMD Reverb Benchmark")
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Per-channel cost");
+
+        for (auto numChannels : { 1, 2 })
+        {
+            const auto reference = measureNanosecondsPerSample<juce::Reverb> (numChannels);
+            const auto vectorised = measureNanosecondsPerSample<SIMDReverb> (numChannels);
+
+            logMessage ((numChannels == 1 ? String ("Mono") : String ("Stereo"))
+                          + ": juce::Reverb " + String (reference, 2) + " ns, SIMDReverb "
+                          + String (vectorised, 2) + " ns per sample per channel");
+        }
+    }
+
+private:
+    template <typename ReverbType>
+    double measureNanosecondsPerSample (int numChannels)
+    {
+        constexpr int blockSize = 512, numBlocks = 100, numRounds = 10;
+
+        ReverbType reverb;
+        reverb.setSampleRate (44100.0);
+
+        AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        SIMDReverbTest::fillRandom (input, getRandom());
+
+        const auto seconds = measureFastestSeconds (numRounds, [&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                buffer.makeCopyOf (input, true);
+                SIMDReverbTest::process (reverb, buffer, 0, blockSize);
+            }
+        });
+
+        return seconds * 1.0e9 / (double) (numBlocks * blockSize * numChannels);
+    }
+};
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+static SIMDReverbBenchmark simdReverbBenchmark;
+#endif
+
+} // namespace juce::dsp
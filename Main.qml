@@ -219,6 +219,12 @@ Window {
             text: "No file selected"
         }
 
+        Label {
+            id: underrunLabel
+            Layout.alignment: Qt.AlignCenter
+            text: "Underruns: " + controller.underruns
+        }
+
         Button {
             id: fileButton
             Layout.alignment: Qt.AlignCenter
@@ -233,6 +239,75 @@ Window {
             enabled: fileLabel.text !== "No file selected"
             onClicked: root.playing ? root.stop() : root.play(fileLabel.text)
         }
+
+        Button {
+            id: queueButton
+            Layout.alignment: Qt.AlignCenter
+            text: "Queue"
+            enabled: root.playing && fileLabel.text !== "No file selected"
+            onClicked: controller.onEnqueue(fileLabel.text)
+        }
+
+        RowLayout {
+            id: crossfadeLayout
+            Layout.alignment: Qt.AlignCenter
+            spacing: 10
+
+            Label {
+                id: crossfadeLabel
+                text: "Crossfade"
+            }
+
+            Slider {
+                id: crossfadeSlider
+                from: 0
+                to: 10
+                value: controller.crossfade
+                orientation: Qt.Horizontal
+                onValueChanged: controller.crossfade !== value ? controller.crossfade = value : null
+            }
+        }
+
+        RowLayout {
+            id: effectsLayout
+            Layout.alignment: Qt.AlignCenter
+            spacing: 10
+
+            ComboBox {
+                id: effectComboBox
+                model: ["EQ", "Compressor", "Limiter", "Convolution"]
+            }
+
+            Button {
+                id: insertEffectButton
+                text: "Insert"
+                onClicked: controller.onInsertEffect(effectComboBox.currentText)
+            }
+
+            Button {
+                id: impulseResponseButton
+                text: controller.impulseResponse === "" ? "Select IR" : controller.impulseResponse.split("/").pop()
+                visible: effectComboBox.currentText === "Convolution"
+                onClicked: () => impulseResponseDialog.open()
+            }
+        }
+
+        RowLayout {
+            id: insertedEffectsLayout
+            Layout.alignment: Qt.AlignCenter
+            spacing: 10
+
+            Repeater {
+                model: controller.effects
+
+                Button {
+                    required property int index
+                    required property string modelData
+                    text: modelData + " \u2715"
+                    onClicked: controller.onRemoveEffect(index)
+                }
+            }
+        }
     }
 
     FileDialog {
@@ -244,6 +319,14 @@ Window {
         }
     }
 
+    FileDialog {
+        id: impulseResponseDialog
+        title: "Select an impulse response"
+        onAccepted: {
+            controller.impulseResponse = impulseResponseDialog.selectedFile.toString().replace("file://", "")
+        }
+    }
+
     Connections {
         target: root
         function onPlay(file) {
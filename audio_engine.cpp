@@ -0,0 +1,79 @@
+#include "audio_engine.h"
+
+AudioEngine::AudioEngine(int numReadAheadThreads)
+    : m_formatManager{}
+    , m_readAheadThreads{}
+    , m_trackLoaderPool{juce::ThreadPoolOptions{}.withThreadName("Track loader").withNumberOfThreads(1)}
+    , m_effectBuilderThread{"Effect builder"}
+    , m_deviceManager{}
+    , m_sourcePlayer{}
+    , m_mixer{}
+{
+    m_formatManager.registerBasicFormats();
+
+    for (auto i = 0; i < juce::jmax(1, numReadAheadThreads); ++i)
+    {
+        auto *thread{m_readAheadThreads.add(new juce::TimeSliceThread{"Read-ahead " + juce::String{i}})};
+        thread->startThread(juce::Thread::Priority::high);
+    }
+
+    m_effectBuilderThread.startThread(juce::Thread::Priority::low);
+
+    const auto error{m_deviceManager.initialiseWithDefaultDevices(0, 2)};
+
+    if (error.isNotEmpty())
+    {
+        juce::Logger::writeToLog("Failed to open audio device: " + error);
+    }
+
+    m_sourcePlayer.setSource(&m_mixer);
+    m_deviceManager.addAudioCallback(&m_sourcePlayer);
+}
+
+AudioEngine::~AudioEngine()
+{
+    m_deviceManager.removeAudioCallback(&m_sourcePlayer);
+    m_sourcePlayer.setSource(nullptr);
+    m_mixer.removeAllInputs();
+    m_deviceManager.closeAudioDevice();
+
+    for (auto *thread : m_readAheadThreads)
+    {
+        thread->stopThread(1000);
+    }
+
+    m_trackLoaderPool.removeAllJobs(true, 1000);
+    m_effectBuilderThread.stopThread(1000);
+}
+
+void AudioEngine::addVoice(juce::AudioSource *voice)
+{
+    m_mixer.addInputSource(voice, false);
+    ++m_numVoices;
+}
+
+void AudioEngine::removeVoice(juce::AudioSource *voice)
+{
+    m_mixer.removeInputSource(voice);
+    --m_numVoices;
+}
+
+juce::TimeSliceThread &AudioEngine::readAheadThread()
+{
+    auto *leastBusy{m_readAheadThreads.getFirst()};
+
+    for (auto *thread : m_readAheadThreads)
+    {
+        if (thread->getNumClients() < leastBusy->getNumClients())
+        {
+            leastBusy = thread;
+        }
+    }
+
+    return *leastBusy;
+}
+
+void AudioEngine::setReadAheadSeconds(double seconds)
+{
+    m_readAheadSeconds = juce::jmax(0.1, seconds);
+}
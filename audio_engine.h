@@ -0,0 +1,54 @@
+#ifndef AUDIO_ENGINE_H
+#define AUDIO_ENGINE_H
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+/**
+ * Owns the one audio device the application plays through and sums every active voice into it.
+ *
+ * The device is opened once, when the engine is created. Voices are plain AudioSources attached to a
+ * juce::MixerAudioSource, so starting or stopping a file never touches the device itself.
+ */
+class AudioEngine
+{
+public:
+    explicit AudioEngine(int numReadAheadThreads = 2);
+    ~AudioEngine();
+
+    // Both may be called from any non-audio thread. The voice is prepared before it becomes audible.
+    void addVoice(juce::AudioSource *voice);
+    void removeVoice(juce::AudioSource *voice);
+
+    int numVoices() const { return m_numVoices.load(); }
+
+    // Shared by every voice so that opening a file doesn't re-register the codecs each time
+    juce::AudioFormatManager &formatManager() { return m_formatManager; }
+
+    // Decoding runs on a small pool of background threads; each new stream goes to the least busy one
+    juce::TimeSliceThread &readAheadThread();
+
+    // Opens queued files and decodes their heads, so a slow codec never holds up a read-ahead thread
+    juce::ThreadPool &trackLoaderPool() { return m_trackLoaderPool; }
+
+    // Background thread for slow, non-decoding work such as building effect processors
+    juce::TimeSliceThread &effectBuilderThread() { return m_effectBuilderThread; }
+
+    // How much decoded audio each stream keeps ahead of the play position
+    double readAheadSeconds() const { return m_readAheadSeconds.load(); }
+    void setReadAheadSeconds(double seconds);
+
+private:
+    juce::AudioFormatManager m_formatManager;
+    juce::OwnedArray<juce::TimeSliceThread> m_readAheadThreads;
+    juce::ThreadPool m_trackLoaderPool;
+    juce::TimeSliceThread m_effectBuilderThread;
+    std::atomic<double> m_readAheadSeconds{2.0};
+    juce::AudioDeviceManager m_deviceManager;
+    juce::AudioSourcePlayer m_sourcePlayer;
+    juce::MixerAudioSource m_mixer;
+    std::atomic<int> m_numVoices{0};
+};
+
+#endif // AUDIO_ENGINE_H
@@ -1,14 +1,11 @@
 #include "audio_player.h"
-#include <QPromise>
-#include <QtConcurrent>
 #include <memory>
 #include <juce_audio_processors/juce_audio_processors.h>
 
-#define JUCE_USE_MP3AUDIOFORMAT 1
-
-AudioPlayer::AudioPlayer(const QString &filename, QObject *parent)
+AudioPlayer::AudioPlayer(AudioEngine &engine, const QString &filename, QObject *parent)
     : QObject{parent}
-    , juce::AudioAppComponent()
+    , juce::AudioSource()
+    , m_engine{engine}
     , m_filename{filename}
     , m_volume{1.0}
     , m_wetLevel{0.33}
@@ -18,153 +15,167 @@ AudioPlayer::AudioPlayer(const QString &filename, QObject *parent)
     , m_width{1.0}
     , m_freeze{0.0}
     , m_pan{0.0}
-    , m_formatManager{std::make_unique<juce::AudioFormatManager>()}
-    , m_readerSource{nullptr}
+    , m_playlist{nullptr}
     , m_transportSource{nullptr}
-    , m_reverb{std::make_unique<juce::Reverb>()}
-    , m_reverbSource{}
-    , m_panner{std::make_unique<PanningProcessor>()}
+    , m_parameterBridge{}
+    , m_effects{}
+    , m_log{RealtimeLog::getInstance()}
 {
-    m_formatManager->registerBasicFormats();
-    auto params{juce::Reverb::Parameters{}};
-    params.roomSize = 0.8;
-    params.damping = 0.1;
-    params.wetLevel = 0.1;
-    params.dryLevel = 0.9;
-    params.width = 1.0;
-    params.freezeMode = false;
-    m_reverb->setParameters(params);
-    m_panner->setPan(-1.0f);
-    auto* reader = m_formatManager->createReaderFor(juce::File{filename.toStdString()});
-
-    if (reader == nullptr)
+    publishParameters();
+    m_engine.effectBuilderThread().addTimeSliceClient(this);
+
+    // The audio thread only records that the stream ended; this picks it up on the Qt thread
+    connect(&m_finishedTimer, &QTimer::timeout, this, &AudioPlayer::checkFinished);
+    m_finishedTimer.setInterval(50);
+
+    // Decoding happens on the engine's read-ahead threads; the callback only copies from memory
+    m_playlist = std::make_unique<PlaylistSource>(m_engine);
+
+    if (! m_playlist->open(juce::File{filename.toStdString()}))
     {
-        juce::Logger::writeToLog("Failed to load audio file: " + filename.toStdString());
+        m_playlist.reset();
         return;
     }
 
     juce::Logger::writeToLog("Audio file loaded successfully: " + filename.toStdString());
 
-    m_readerSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
     m_transportSource = std::make_unique<juce::AudioTransportSource>();
-    m_transportSource->setSource(m_readerSource.get());
-    m_reverbSource = std::make_unique<juce::ReverbAudioSource>(m_transportSource.get(), false);
-    m_reverbSource->setParameters(params);
-    // get default audio output configuration
-    auto setup{deviceManager.getAudioDeviceSetup()};
-    setAudioChannels(setup.inputChannels.toInteger(), setup.outputChannels.toInteger());
-
-    connect(this, &AudioPlayer::wetLevelChanged, this, &AudioPlayer::onReverbParametersChanged);
-    connect(this, &AudioPlayer::dryLevelChanged, this, &AudioPlayer::onReverbParametersChanged);
-    connect(this, &AudioPlayer::roomSizeChanged, this, &AudioPlayer::onReverbParametersChanged);
-    connect(this, &AudioPlayer::dampingChanged, this, &AudioPlayer::onReverbParametersChanged);
-    connect(this, &AudioPlayer::widthChanged, this, &AudioPlayer::onReverbParametersChanged);
-    connect(this, &AudioPlayer::freezeChanged, this, &AudioPlayer::onReverbParametersChanged);
+    m_transportSource->setSource(m_playlist.get());
+
+    // Joins the shared mix; the engine prepares us with the device's current settings
+    m_engine.addVoice(this);
 }
 
 AudioPlayer::~AudioPlayer()
 {
+    // Waits for an edit in progress, so nothing touches the chain once we start tearing down
+    m_engine.effectBuilderThread().removeTimeSliceClient(this);
+
+    if (m_transportSource == nullptr)
+    {
+        return;
+    }
+
+    // Stop while still in the mix so the transport sees its fade-out block rather than timing out
     if (m_transportSource->isPlaying())
     {
         m_transportSource->stop();
     }
 
+    m_engine.removeVoice(this);
     m_transportSource->setSource(nullptr);
-    shutdownAudio();
 }
 
 void AudioPlayer::play()
 {
-    if (m_transportSource->isPlaying())
+    if (m_transportSource == nullptr)
+    {
+        juce::Logger::writeToLog("Nothing to play.");
+    }
+    else if (m_transportSource->isPlaying())
     {
         juce::Logger::writeToLog("Audio already playing.");
     }
     else
     {
-        QtConcurrent::run([this]() {
-            qInfo() << "Playing audio...";
-            m_transportSource->setPosition(0.0);
-            m_transportSource->start();
-            while(m_transportSource->isPlaying())
-            {
-                QThread::msleep(100);
-            }
-
-            qInfo() << "Audio playback finished.";
-            emit finished();
-        });
+        qInfo() << "Playing audio...";
+        m_transportSource->setPosition(0.0);
+        m_transportSource->start();
 
+        // Published after start() so the audio thread can never pair the new generation with the old stopped state
+        m_playGeneration.fetch_add(1, std::memory_order_release);
+        m_finishedTimer.start();
         juce::Logger::writeToLog("Audio playback started.");
     }
 }
 
 void AudioPlayer::stop()
 {
-    if (m_transportSource->isPlaying())
+    if (m_transportSource != nullptr && m_transportSource->isPlaying())
     {
         // Stop the transport source
         m_transportSource->stop();
         juce::Logger::writeToLog("Audio playback stopped.");
 
-        // Release resources and set the source to nullptr
-        m_transportSource->setSource(nullptr);
+        // The sources stay alive until we leave the mix, since the audio thread may still be looking at them
 
-        // Explicitly release resources
-        m_transportSource->releaseResources();
+        notifyFinished(m_playGeneration.load(std::memory_order_acquire));
+    }
+}
 
-        // Reset the reader source
-        m_readerSource.reset();
+void AudioPlayer::enqueue(const QString &filename)
+{
+    if (m_playlist != nullptr)
+    {
+        m_playlist->enqueue(juce::File{filename.toStdString()});
     }
 }
 
-void AudioPlayer::releaseResources()
+void AudioPlayer::checkFinished()
 {
-    juce::Logger::writeToLog("Releasing audio resources.");
+    notifyFinished(m_endedGeneration.load(std::memory_order_acquire));
+}
 
-    // Ensure the transport source is not requesting audio blocks
-    if (m_transportSource != nullptr)
+void AudioPlayer::notifyFinished(uint32_t generation)
+{
+    // Whichever of stop() and the end-of-stream check gets here first wins, so finished() fires once per play()
+    if (generation == m_notifiedGeneration)
     {
-        // Stop playback if it's still running
-        if (m_transportSource->isPlaying())
-        {
-            m_transportSource->stop();
-        }
-
-        // Release resources and set the source to nullptr
-        m_transportSource->releaseResources();
-        m_transportSource->setSource(nullptr);
+        return;
     }
 
-    // Reset the reader source
-    if (m_readerSource != nullptr)
+    m_notifiedGeneration = generation;
+    m_finishedTimer.stop();
+
+    qInfo() << "Audio playback finished.";
+    emit finished();
+}
+
+void AudioPlayer::releaseResources()
+{
+    // The device is shared, so a restart must not cost us the reader; only the transport's buffers go
+    if (m_transportSource != nullptr)
     {
-        m_readerSource.reset();
+        m_transportSource->releaseResources();
     }
 }
 
 void AudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-    juce::Logger::writeToLog("Preparing to play: Samples per Block = " +
-                             juce::String(samplesPerBlockExpected) + ", Sample Rate = " + juce::String(sampleRate));
+    m_log.log(LogCategory::player, "Preparing to play, samples per block / sample rate:", samplesPerBlockExpected, sampleRate);
+
+    if (m_transportSource == nullptr)
+    {
+        return;
+    }
+
     m_transportSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
-    m_reverbSource->prepareToPlay(samplesPerBlockExpected, sampleRate);
-    m_panner->prepareToPlay(sampleRate, samplesPerBlockExpected);
+
+    // Pick up whatever the Qt thread published before the device started and jump straight to it
+    m_parameterBridge.consume();
+    m_effects.prepare(sampleRate, samplesPerBlockExpected, m_parameterBridge.current());
 }
 
 void AudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
 {
-    juce::Logger::writeToLog("getNextAudioBlock called.");
-    if (m_readerSource != nullptr && m_transportSource != nullptr)
+    m_log.log(LogCategory::player, "getNextAudioBlock called, samples:", bufferToFill.numSamples);
+    if (m_transportSource != nullptr)
     {
-        bufferToFill.buffer->applyGain(static_cast<float>(m_volume));
-        m_reverbSource->getNextAudioBlock(bufferToFill);
-        juce::dsp::AudioBlock<float> audioBlock(*bufferToFill.buffer);
-        juce::dsp::ProcessContextReplacing<float> context(audioBlock);
-        // Create an empty MidiBuffer to pass to processBlock
-        juce::MidiBuffer midiMessages;
-
-        // Call the custom processBlock method
-        m_panner->processBlock(*bufferToFill.buffer, midiMessages);
+        if (m_parameterBridge.consume())
+        {
+            m_effects.setParameters(m_parameterBridge.current());
+        }
+
+        m_transportSource->getNextAudioBlock(bufferToFill);
+        m_effects.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+        // The transport drops out of the playing state by itself once its source runs dry
+        const auto generation{m_playGeneration.load(std::memory_order_acquire)};
+
+        if (! m_transportSource->isPlaying())
+        {
+            m_endedGeneration.store(generation, std::memory_order_release);
+        }
     }
     else
     {
@@ -207,55 +218,121 @@ qreal AudioPlayer::pan() const {
 void AudioPlayer::setVolume(qreal volume) {
     qInfo() << "AudioPlayer::setVolume(" << volume << ")";
     m_volume = volume;
-    m_transportSource->setGain(static_cast<float>(m_volume));
+    publishParameters();
     emit volumeChanged();
 }
 
 void AudioPlayer::setWetLevel(qreal wetLevel) {
     m_wetLevel = wetLevel;
+    publishParameters();
     emit wetLevelChanged();
 }
 
 void AudioPlayer::setDryLevel(qreal dryLevel) {
     m_dryLevel = dryLevel;
+    publishParameters();
     emit dryLevelChanged();
 }
 
 void AudioPlayer::setRoomSize(qreal roomSize) {
     m_roomSize = roomSize;
+    publishParameters();
     emit roomSizeChanged();
 }
 
 void AudioPlayer::setDamping(qreal damping) {
     m_damping = damping;
+    publishParameters();
     emit dampingChanged();
 }
 
 void AudioPlayer::setWidth(qreal width) {
     m_width = width;
+    publishParameters();
     emit widthChanged();
 }
 
 void AudioPlayer::setFreeze(qreal freeze) {
     m_freeze = freeze;
+    publishParameters();
     emit freezeChanged();
 }
 
 void AudioPlayer::setPan(qreal pan) {
     m_pan = pan;
-    m_panner->setPan(static_cast<float>(pan));
+    publishParameters();
     emit panChanged();
 }
 
+void AudioPlayer::setCrossfade(qreal seconds) {
+    if (m_playlist != nullptr)
+    {
+        m_playlist->setCrossfadeSeconds(seconds);
+    }
+}
+
+void AudioPlayer::insertEffect(int index, const QString &name, const QString &impulseResponse)
+{
+    const auto effect{insertEffectFromName(name.toStdString())};
+
+    if (! effect.has_value())
+    {
+        qWarning() << "Unknown effect" << name;
+        return;
+    }
+
+    const juce::ScopedLock lock{m_effectEditLock};
+    m_effectEdits.push_back({index, effect, juce::File{impulseResponse.toStdString()}});
+    m_engine.effectBuilderThread().moveToFrontOfQueue(this);
+}
+
+void AudioPlayer::removeEffect(int index)
+{
+    const juce::ScopedLock lock{m_effectEditLock};
+    m_effectEdits.push_back({index, std::nullopt, {}});
+    m_engine.effectBuilderThread().moveToFrontOfQueue(this);
+}
+
+int AudioPlayer::useTimeSlice()
+{
+    auto edits{std::vector<EffectEdit>{}};
+
+    {
+        const juce::ScopedLock lock{m_effectEditLock};
+        std::swap(edits, m_effectEdits);
+    }
+
+    // Building a processor can take a while (the convolution loads its impulse response), which is why it's done here
+    for (const auto &edit : edits)
+    {
+        if (edit.insert.has_value())
+        {
+            m_effects.insertEffect(edit.index, createInsertEffect(*edit.insert, edit.impulseResponse));
+        }
+        else
+        {
+            m_effects.removeEffect(edit.index);
+        }
+    }
+
+    return 100;
+}
+
 void AudioPlayer::onReverbParametersChanged()
 {
-    auto params{juce::Reverb::Parameters{}};
-    params.roomSize = static_cast<float>(m_roomSize);
-    params.damping = static_cast<float>(m_damping);
+    publishParameters();
+}
+
+void AudioPlayer::publishParameters()
+{
+    auto params{PlayerParameters{}};
+    params.volume = static_cast<float>(m_volume);
     params.wetLevel = static_cast<float>(m_wetLevel);
     params.dryLevel = static_cast<float>(m_dryLevel);
+    params.roomSize = static_cast<float>(m_roomSize);
+    params.damping = static_cast<float>(m_damping);
     params.width = static_cast<float>(m_width);
-    params.freezeMode = m_freeze > 0.0;
-    m_reverb->setParameters(params);
-    m_reverbSource->setParameters(params);
+    params.freeze = static_cast<float>(m_freeze);
+    params.pan = static_cast<float>(m_pan);
+    m_parameterBridge.publish(params);
 }
\ No newline at end of file
@@ -3,14 +3,20 @@
 
 #include <QObject>
 #include <QQmlEngine>
+#include <QTimer>
 #include <juce_audio_formats/juce_audio_formats.h>
-#include <juce_audio_utils/juce_audio_utils.h>
+#include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "panning_processor.h"
+#include "audio_engine.h"
+#include "effect_chain.h"
+#include "insert_effects.h"
+#include "parameter_bridge.h"
+#include "playlist_source.h"
+#include "realtime_log.h"
 
 
-class AudioPlayer : public QObject, public juce::AudioAppComponent
+class AudioPlayer : public QObject, public juce::AudioSource, private juce::TimeSliceClient
 {
     Q_OBJECT
     Q_PROPERTY(qreal volume READ volume WRITE setVolume NOTIFY volumeChanged)
@@ -21,13 +27,18 @@ class AudioPlayer : public QObject, public juce::AudioAppComponent
     Q_PROPERTY(qreal width READ width WRITE setWidth NOTIFY widthChanged)
     Q_PROPERTY(qreal freeze READ freeze WRITE setFreeze NOTIFY freezeChanged)
     Q_PROPERTY(qreal pan READ pan WRITE setPan NOTIFY panChanged)
+    Q_PROPERTY(int underruns READ underruns)
 public:
-    explicit AudioPlayer(const QString &filename, QObject *parent = nullptr);
+    explicit AudioPlayer(AudioEngine &engine, const QString &filename, QObject *parent = nullptr);
     ~AudioPlayer() override;
 
+    bool isLoaded() const { return m_transportSource != nullptr; }
     void play();
     void stop();
 
+    // Queues a file to follow the current one without a gap
+    void enqueue(const QString &filename);
+
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
     void releaseResources() override;
     void getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill) override;
@@ -41,6 +52,9 @@ public:
     qreal freeze() const;
     qreal pan() const;
 
+    // Blocks in which the read-ahead thread hadn't decoded far enough and part of the output was silence
+    int underruns() const { return m_playlist != nullptr ? m_playlist->underruns() : 0; }
+
     void setVolume(qreal volume);
     void setWetLevel(qreal wetLevel);
     void setDryLevel(qreal dryLevel);
@@ -49,6 +63,11 @@ public:
     void setWidth(qreal width);
     void setFreeze(qreal freeze);
     void setPan(qreal pan);
+    void setCrossfade(qreal seconds);
+
+    // Effect edits are queued and applied in order on the engine's effect builder thread
+    void insertEffect(int index, const QString &name, const QString &impulseResponse);
+    void removeEffect(int index);
 
 public slots:
     void onReverbParametersChanged();
@@ -65,6 +84,19 @@ signals:
     void panChanged();
 
 private:
+    struct EffectEdit
+    {
+        int index;
+        std::optional<InsertEffect> insert;
+        juce::File impulseResponse;
+    };
+
+    int useTimeSlice() override;
+    void publishParameters();
+    void checkFinished();
+    void notifyFinished(uint32_t generation);
+
+    AudioEngine &m_engine;
     QString m_filename;
     qreal m_volume;
     qreal m_wetLevel;
@@ -74,12 +106,19 @@ private:
     qreal m_width;
     qreal m_freeze;
     qreal m_pan;
-    std::unique_ptr<juce::AudioFormatManager> m_formatManager;
-    std::unique_ptr<juce::AudioFormatReaderSource> m_readerSource;
+    std::unique_ptr<PlaylistSource> m_playlist;
     std::unique_ptr<juce::AudioTransportSource> m_transportSource;
-    std::unique_ptr<juce::Reverb> m_reverb;
-    std::unique_ptr<juce::ReverbAudioSource> m_reverbSource;
-    std::unique_ptr<PanningProcessor> m_panner;
+    juce::CriticalSection m_effectEditLock;
+    std::vector<EffectEdit> m_effectEdits;
+    QTimer m_finishedTimer;
+    uint32_t m_notifiedGeneration{0};
+
+    // Everything below is owned by the audio thread once playback starts
+    ParameterBridge m_parameterBridge;
+    EffectChain m_effects;
+    std::atomic<uint32_t> m_playGeneration{0};
+    std::atomic<uint32_t> m_endedGeneration{0};
+    RealtimeLog &m_log;
 };
 
 #endif // AUDIO_PLAYER_H
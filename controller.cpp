@@ -4,16 +4,42 @@
 
 Controller::Controller(QObject *parent)
     : QObject{parent}
-    , player{}
+    , m_engine{}
+    , m_players{}
+    , m_statisticsTimer{}
     , playing{false}
-{}
+{
+    connect(&m_statisticsTimer, &QTimer::timeout, this, &Controller::updateStatistics);
+    m_statisticsTimer.start(500);
+}
+
+void Controller::updateStatistics()
+{
+    auto underruns{m_retiredUnderruns};
+
+    for (const auto &player : m_players)
+    {
+        underruns += player->underruns();
+    }
+
+    if (underruns != m_underruns)
+    {
+        m_underruns = underruns;
+        emit underrunsChanged();
+    }
+}
 
 void Controller::onPlay(const QString &file)
 {
     qInfo().nospace() << "Controller:onPlay(" << file << ")";
 
-    // Create the AudioPlayer object
-    player = std::make_unique<AudioPlayer>(file);
+    // Create a new voice on the shared engine; anything already playing keeps going
+    auto player{std::make_unique<AudioPlayer>(m_engine, file)};
+
+    if (! player->isLoaded())
+    {
+        return;
+    }
 
     // Connect signals from controller to player
     connect(player.get(), &AudioPlayer::finished, this, &Controller::onStopped);
@@ -25,6 +51,9 @@ void Controller::onPlay(const QString &file)
     connect(this, &Controller::widthChanged, player.get(), &AudioPlayer::setWidth);
     connect(this, &Controller::freezeChanged, player.get(), &AudioPlayer::setFreeze);
     connect(this, &Controller::panChanged, player.get(), &AudioPlayer::setPan);
+    connect(this, &Controller::crossfadeChanged, player.get(), &AudioPlayer::setCrossfade);
+    connect(this, &Controller::effectInserted, player.get(), &AudioPlayer::insertEffect);
+    connect(this, &Controller::effectRemoved, player.get(), &AudioPlayer::removeEffect);
 
     // Immediately apply the current property values to the player
     player->setVolume(m_volume);
@@ -35,35 +64,109 @@ void Controller::onPlay(const QString &file)
     player->setWidth(m_width);
     player->setFreeze(m_freeze);
     player->setPan(m_pan);
+    player->setCrossfade(m_crossfade);
+
+    for (auto i = 0; i < m_effects.size(); ++i)
+    {
+        player->insertEffect(i, m_effects[i].name, m_effects[i].impulseResponse);
+    }
 
     // Start playback
     player->play();
+    m_players.push_back(std::move(player));
     playing = true;
     emit playingChanged();
 }
 
+void Controller::onEnqueue(const QString &file)
+{
+    qInfo().nospace() << "Controller:onEnqueue(" << file << ")";
+
+    // Queued files follow the most recently started voice; with nothing playing this is just play
+    if (m_players.empty())
+    {
+        onPlay(file);
+        return;
+    }
+
+    m_players.back()->enqueue(file);
+}
 
 void Controller::onStop()
 {
     qInfo().nospace() << "Controller:onStop()";
-    player->stop();
+
+    for (auto &player : m_players)
+    {
+        player->stop();
+    }
 }
 
 void Controller::onStopped()
 {
     qInfo().nospace() << "Controller:onStopped()";
-    playing = false;
-    emit playingChanged();
-    emit stopped();
+
+    // We're inside the finished() emission of the sender, so it can only be dropped once that returns
+    auto *finishedPlayer{qobject_cast<AudioPlayer *>(sender())};
+
+    QMetaObject::invokeMethod(this, [this, finishedPlayer]() {
+        std::erase_if(m_players, [this, finishedPlayer](const auto &player) {
+            if (player.get() != finishedPlayer)
+            {
+                return false;
+            }
+
+            m_retiredUnderruns += player->underruns();
+            return true;
+        });
+
+        if (m_players.empty() && playing)
+        {
+            playing = false;
+            emit playingChanged();
+            emit stopped();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void Controller::onInsertEffect(const QString &name)
+{
+    qInfo().nospace() << "Controller:onInsertEffect(" << name << ")";
+    m_effects.append({name, m_impulseResponse});
+    emit effectInserted(m_effects.size() - 1, name, m_impulseResponse);
+    emit effectsChanged();
+}
+
+void Controller::onRemoveEffect(int index)
+{
+    qInfo().nospace() << "Controller:onRemoveEffect(" << index << ")";
+
+    if (index < 0 || index >= m_effects.size())
+    {
+        return;
+    }
+
+    m_effects.removeAt(index);
+    emit effectRemoved(index);
+    emit effectsChanged();
+}
+
+QStringList Controller::effects() const
+{
+    QStringList names;
+
+    for (const auto &effect : m_effects)
+    {
+        names.append(effect.name);
+    }
+
+    return names;
 }
 
 void Controller::setVolume(qreal volume)
 {
     qInfo().nospace() << "Controller:setVolume(" << volume << ")";
     m_volume = volume;
-    if(player != nullptr) {
-        player->setVolume(m_volume);
-    }
     emit volumeChanged(m_volume);
 }
 
@@ -71,7 +174,6 @@ void Controller::setWetLevel(qreal wetLevel)
 {
     qInfo().nospace() << "Controller:setWetLevel(" << wetLevel << ")";
     m_wetLevel = wetLevel;
-    player->setWetLevel(m_wetLevel);
     emit wetLevelChanged(m_wetLevel);
 }
 
@@ -79,14 +181,12 @@ void Controller::setDryLevel(qreal dryLevel)
 {
     qInfo().nospace() << "Controller:setDryLevel(" << dryLevel << ")";
     m_dryLevel = dryLevel;
-    player->setDryLevel(m_dryLevel);
     emit dryLevelChanged(m_dryLevel);
 }
 
 void Controller::setRoomSize(qreal roomSize) {
     qInfo().nospace() << "Controller:setRoomSize(" << roomSize << ")";
     m_roomSize = roomSize;
-    player->setRoomSize(m_roomSize);
     emit roomSizeChanged(m_roomSize);
 }
 
@@ -94,7 +194,6 @@ void Controller::setDamping(qreal damping)
 {
     qInfo().nospace() << "Controller:setDamping(" << damping << ")";
     m_damping = damping;
-    player->setDamping(m_damping);
     emit dampingChanged(m_damping);
 }
 
@@ -102,7 +201,6 @@ void Controller::setWidth(qreal width)
 {
     qInfo().nospace() << "Controller:setWidth(" << width << ")";
     m_width = width;
-    player->setWidth(m_width);
     emit widthChanged(m_width);
 }
 
@@ -110,7 +208,6 @@ void Controller::setFreeze(qreal freeze)
 {
     qInfo().nospace() << "Controller:setFreeze(" << freeze << ")";
     m_freeze = freeze;
-    player->setFreeze(m_freeze);
     emit freezeChanged(m_freeze);
 }
 
@@ -118,7 +215,19 @@ void Controller::setPan(qreal pan)
 {
     qInfo().nospace() << "Controller:setPan(" << pan << ")";
     m_pan = pan;
-    player->setPan(m_pan);
     emit panChanged(m_pan);
 }
 
+void Controller::setCrossfade(qreal crossfade)
+{
+    qInfo().nospace() << "Controller:setCrossfade(" << crossfade << ")";
+    m_crossfade = crossfade;
+    emit crossfadeChanged(m_crossfade);
+}
+
+void Controller::setImpulseResponse(const QString &impulseResponse)
+{
+    qInfo().nospace() << "Controller:setImpulseResponse(" << impulseResponse << ")";
+    m_impulseResponse = impulseResponse;
+    emit impulseResponseChanged(m_impulseResponse);
+}
@@ -4,7 +4,9 @@
 #include "audio_player.h"
 
 #include <QObject>
+#include <QStringList>
 #include <QQmlEngine>
+#include <QTimer>
 
 class Controller : public QObject
 {
@@ -12,6 +14,7 @@ class Controller : public QObject
     QML_ELEMENT
 
     Q_PROPERTY(bool playing READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(int underruns READ underruns NOTIFY underrunsChanged)
     Q_PROPERTY(qreal volume MEMBER m_volume READ volume WRITE setVolume NOTIFY volumeChanged)
     Q_PROPERTY(qreal wetLevel MEMBER m_wetLevel READ wetLevel WRITE setWetLevel NOTIFY wetLevelChanged)
     Q_PROPERTY(qreal dryLevel MEMBER m_dryLevel READ dryLevel WRITE setDryLevel NOTIFY dryLevelChanged)
@@ -20,15 +23,22 @@ class Controller : public QObject
     Q_PROPERTY(qreal width MEMBER m_width READ width WRITE setWidth NOTIFY widthChanged)
     Q_PROPERTY(qreal freeze MEMBER m_freeze READ freeze WRITE setFreeze NOTIFY freezeChanged)
     Q_PROPERTY(qreal pan MEMBER m_pan READ pan WRITE setPan NOTIFY panChanged)
+    Q_PROPERTY(qreal crossfade MEMBER m_crossfade READ crossfade WRITE setCrossfade NOTIFY crossfadeChanged)
+    Q_PROPERTY(QStringList effects READ effects NOTIFY effectsChanged)
+    Q_PROPERTY(QString impulseResponse MEMBER m_impulseResponse READ impulseResponse WRITE setImpulseResponse NOTIFY impulseResponseChanged)
 public:
     explicit Controller(QObject *parent = nullptr);
 
 public slots:
     void onPlay(const QString &file);
+    void onEnqueue(const QString &file);
     void onStop();
     void onStopped();
+    void onInsertEffect(const QString &name);
+    void onRemoveEffect(int index);
 
     bool isPlaying() const { return playing; }
+    int underruns() const { return m_underruns; }
 
     qreal volume() const { return m_volume; }
     qreal wetLevel() const { return m_wetLevel; }
@@ -38,6 +48,9 @@ public slots:
     qreal width() const { return m_width; }
     qreal freeze() const { return m_freeze; }
     qreal pan() const { return m_pan; }
+    qreal crossfade() const { return m_crossfade; }
+    QStringList effects() const;
+    QString impulseResponse() const { return m_impulseResponse; }
 
     void setVolume(qreal volume);
     void setWetLevel(qreal wetLevel);
@@ -47,10 +60,13 @@ public slots:
     void setWidth(qreal width);
     void setFreeze(qreal freeze);
     void setPan(qreal pan);
+    void setCrossfade(qreal crossfade);
+    void setImpulseResponse(const QString &impulseResponse);
 
 signals:
     void stopped();
     void playingChanged();
+    void underrunsChanged();
     void volumeChanged(qreal volume);
     void wetLevelChanged(qreal wetLevel);
     void dryLevelChanged(qreal dryLevel);
@@ -59,8 +75,22 @@ signals:
     void widthChanged(qreal width);
     void freezeChanged(qreal freeze);
     void panChanged(qreal pan);
+    void crossfadeChanged(qreal crossfade);
+    void effectsChanged();
+    void impulseResponseChanged(const QString &impulseResponse);
+    void effectInserted(int index, const QString &name, const QString &impulseResponse);
+    void effectRemoved(int index);
 
 private:
+    // An insert keeps the impulse response it was created with, so later voices replay it unchanged
+    struct InsertedEffect
+    {
+        QString name;
+        QString impulseResponse;
+    };
+
+    void updateStatistics();
+
     qreal m_volume = 1.0;
     qreal m_wetLevel = 0.33;
     qreal m_dryLevel = 0.4;
@@ -69,7 +99,14 @@ private:
     qreal m_width = 1.0;
     qreal m_freeze = 0.0;
     qreal m_pan = 0.0;
-    std::unique_ptr<AudioPlayer> player;
+    qreal m_crossfade = 0.0;
+    QList<InsertedEffect> m_effects;
+    QString m_impulseResponse;
+    AudioEngine m_engine;
+    std::vector<std::unique_ptr<AudioPlayer>> m_players;
+    QTimer m_statisticsTimer;
+    int m_underruns = 0;
+    int m_retiredUnderruns = 0;
     bool playing = false;
 };
 
@@ -0,0 +1,172 @@
+#include "effect_chain.h"
+
+namespace
+{
+constexpr int insertChannels = 2;
+}
+
+EffectChain::EffectChain()
+    : m_reverb{}
+    , m_panner{}
+    , m_gain{}
+    , m_midiMessages{}
+    , m_activeInserts{std::make_unique<Inserts>()}
+{
+}
+
+EffectChain::~EffectChain()
+{
+    deleteRetiredInserts();
+    delete m_pendingInserts.exchange(nullptr);
+}
+
+void EffectChain::prepare(double sampleRate, int maximumBlockSize, const PlayerParameters &parameters)
+{
+    const juce::ScopedLock lock{m_editLock};
+
+    m_reverb.setSampleRate(sampleRate);
+    m_reverb.reset();
+    m_panner.prepareToPlay(sampleRate, maximumBlockSize);
+
+    // Start at the requested values rather than ramping in from the defaults
+    m_gain.reset(sampleRate, 0.05);
+    m_gain.setCurrentAndTargetValue(parameters.volume);
+    m_reverb.setParameters(parameters.toReverbParameters());
+    m_panner.setPan(parameters.pan);
+
+    m_sampleRate = sampleRate;
+    m_blockSize = maximumBlockSize;
+
+    // The audio thread isn't running us while we're being prepared, so the latest list can be adopted directly
+    if (auto *pending{m_pendingInserts.exchange(nullptr)})
+    {
+        m_activeInserts.reset(pending);
+    }
+
+    deleteRetiredInserts();
+
+    for (const auto &processor : m_activeInserts->processors)
+    {
+        processor->setPlayConfigDetails(insertChannels, insertChannels, sampleRate, maximumBlockSize);
+        processor->prepareToPlay(sampleRate, maximumBlockSize);
+    }
+}
+
+void EffectChain::setParameters(const PlayerParameters &parameters)
+{
+    m_gain.setTargetValue(parameters.volume);
+    m_reverb.setParameters(parameters.toReverbParameters());
+    m_panner.setPan(parameters.pan);
+}
+
+void EffectChain::process(juce::AudioBuffer<float> &buffer, int startSample, int numSamples)
+{
+    if (buffer.getNumChannels() == 0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    // Only swap when the old list has somewhere to go, so it's never freed here
+    if (m_retiredFifo.getFreeSpace() > 0)
+    {
+        if (auto *pending{m_pendingInserts.exchange(nullptr)})
+        {
+            m_retiredFifo.write(1).forEach([this](int index) {
+                m_retired[static_cast<size_t>(index)] = m_activeInserts.release();
+            });
+            m_activeInserts.reset(pending);
+        }
+    }
+
+    const auto startGain{m_gain.getCurrentValue()};
+    const auto endGain{m_gain.skip(numSamples)};
+
+    for (auto channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        buffer.applyGainRamp(channel, startSample, numSamples, startGain, endGain);
+    }
+
+    auto *left{buffer.getWritePointer(0, startSample)};
+
+    if (buffer.getNumChannels() > 1)
+    {
+        m_reverb.processStereo(left, buffer.getWritePointer(1, startSample), numSamples);
+    }
+    else
+    {
+        m_reverb.processMono(left, numSamples);
+    }
+
+    // Refers to the caller's channels, so only the requested region is processed and nothing is allocated
+    juce::AudioBuffer<float> region{buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, numSamples};
+    m_panner.processBlock(region, m_midiMessages);
+
+    if (buffer.getNumChannels() < insertChannels)
+    {
+        return;
+    }
+
+    // Inserts are stereo; any further channels pass through
+    juce::AudioBuffer<float> stereo{buffer.getArrayOfWritePointers(), insertChannels, startSample, numSamples};
+
+    for (const auto &processor : m_activeInserts->processors)
+    {
+        processor->processBlock(stereo, m_midiMessages);
+    }
+}
+
+void EffectChain::insertEffect(int index, std::unique_ptr<juce::AudioProcessor> processor)
+{
+    if (processor == nullptr)
+    {
+        return;
+    }
+
+    const juce::ScopedLock lock{m_editLock};
+
+    // Prepared here, before the audio thread can see it
+    if (m_sampleRate > 0.0)
+    {
+        processor->setPlayConfigDetails(insertChannels, insertChannels, m_sampleRate, m_blockSize);
+        processor->prepareToPlay(m_sampleRate, m_blockSize);
+    }
+
+    const auto position{juce::jlimit(0, static_cast<int>(m_editedInserts.size()), index)};
+    m_editedInserts.insert(m_editedInserts.begin() + position, std::shared_ptr<juce::AudioProcessor>{std::move(processor)});
+    publish();
+}
+
+void EffectChain::removeEffect(int index)
+{
+    const juce::ScopedLock lock{m_editLock};
+
+    if (index < 0 || index >= static_cast<int>(m_editedInserts.size()))
+    {
+        return;
+    }
+
+    // The processor lives on in the list the audio thread is using until that list is retired
+    m_editedInserts.erase(m_editedInserts.begin() + index);
+    publish();
+}
+
+int EffectChain::numEffects() const
+{
+    const juce::ScopedLock lock{m_editLock};
+    return static_cast<int>(m_editedInserts.size());
+}
+
+void EffectChain::publish()
+{
+    deleteRetiredInserts();
+
+    // A list the audio thread never picked up is simply superseded
+    delete m_pendingInserts.exchange(new Inserts{m_editedInserts});
+}
+
+void EffectChain::deleteRetiredInserts()
+{
+    m_retiredFifo.read(m_retiredFifo.getNumReady()).forEach([this](int index) {
+        delete m_retired[static_cast<size_t>(index)];
+    });
+}
@@ -0,0 +1,73 @@
+#ifndef EFFECT_CHAIN_H
+#define EFFECT_CHAIN_H
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include "panning_processor.h"
+#include "parameter_bridge.h"
+
+/**
+ * The volume -> reverb -> pan -> inserts chain an AudioPlayer applies to its voice.
+ *
+ * It has no knowledge of where its audio comes from, so the live callback and the offline renderer
+ * run exactly the same processing. Everything is allocated in prepare(); process() is real-time safe.
+ *
+ * Inserts (EQ, compressor, ...) can be added and removed while the chain is running. Edits happen on
+ * the caller's thread, which must not be the audio thread: the new processor is prepared there and
+ * the chain publishes a new immutable list of inserts that the audio thread picks up at the start of
+ * its next block. Lists the audio thread has let go of come back through a FIFO and are freed by the
+ * next edit, so neither the swap nor the render path ever allocates or frees.
+ */
+class EffectChain
+{
+public:
+    EffectChain();
+    ~EffectChain();
+
+    void prepare(double sampleRate, int maximumBlockSize, const PlayerParameters &parameters);
+
+    // Ramps towards new parameter values from the next block on
+    void setParameters(const PlayerParameters &parameters);
+
+    void process(juce::AudioBuffer<float> &buffer, int startSample, int numSamples);
+
+    // Never call these from the audio thread
+    void insertEffect(int index, std::unique_ptr<juce::AudioProcessor> processor);
+    void removeEffect(int index);
+    int numEffects() const;
+
+private:
+    struct Inserts
+    {
+        // Shared so that consecutive lists can hold the same processors; only ever released off the audio thread
+        std::vector<std::shared_ptr<juce::AudioProcessor>> processors;
+    };
+
+    void publish();
+    void deleteRetiredInserts();
+
+    // Vectorised drop-in for juce::Reverb, with the same tunings and parameters
+    juce::dsp::SIMDReverb m_reverb;
+    PanningProcessor m_panner;
+    juce::SmoothedValue<float> m_gain;
+    juce::MidiBuffer m_midiMessages;
+
+    // Editing side
+    juce::CriticalSection m_editLock;
+    std::vector<std::shared_ptr<juce::AudioProcessor>> m_editedInserts;
+    double m_sampleRate{0.0};
+    int m_blockSize{0};
+
+    // Hand-off to the audio thread, and back again for deletion
+    std::unique_ptr<Inserts> m_activeInserts;
+    std::atomic<Inserts *> m_pendingInserts{nullptr};
+    juce::AbstractFifo m_retiredFifo{16};
+    std::array<Inserts *, 16> m_retired{};
+};
+
+#endif // EFFECT_CHAIN_H
@@ -0,0 +1,173 @@
+#include "insert_effects.h"
+#include <juce_dsp/juce_dsp.h>
+
+namespace
+{
+/**
+ * AudioProcessor boilerplate around a juce::dsp processor; subclasses only prepare and process.
+ */
+class DspInsert : public juce::AudioProcessor
+{
+public:
+    explicit DspInsert(const juce::String &name)
+        : m_name{name}
+    {
+    }
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override
+    {
+        prepare({sampleRate, static_cast<juce::uint32>(juce::jmax(1, samplesPerBlock)),
+                 static_cast<juce::uint32>(juce::jmax(1, getTotalNumOutputChannels()))});
+    }
+
+    void processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) override
+    {
+        juce::ScopedNoDenormals noDenormals;
+        auto block{juce::dsp::AudioBlock<float>{buffer}};
+        process(juce::dsp::ProcessContextReplacing<float>{block});
+    }
+
+    void releaseResources() override {}
+
+    const juce::String getName() const override { return m_name; }
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool isMidiEffect() const override { return false; }
+    bool hasEditor() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int index) override {}
+    const juce::String getProgramName(int index) override { return "Default"; }
+    void changeProgramName(int index, const juce::String &newName) override {}
+    juce::AudioProcessorEditor *createEditor() override { return nullptr; }
+    void getStateInformation(juce::MemoryBlock &destData) override {}
+    void setStateInformation(const void *data, int sizeInBytes) override {}
+
+protected:
+    virtual void prepare(const juce::dsp::ProcessSpec &spec) = 0;
+    virtual void process(const juce::dsp::ProcessContextReplacing<float> &context) = 0;
+
+private:
+    const juce::String m_name;
+};
+
+class EqualiserInsert : public DspInsert
+{
+public:
+    EqualiserInsert() : DspInsert{"EQ"} {}
+
+protected:
+    void prepare(const juce::dsp::ProcessSpec &spec) override
+    {
+        // A gentle low lift, a little less boxiness in the upper mids and some air on top
+        using Coefficients = juce::dsp::IIR::Coefficients<float>;
+        m_bands.get<0>().state = Coefficients::makeLowShelf(spec.sampleRate, 120.0, 0.7, juce::Decibels::decibelsToGain(3.0f));
+        m_bands.get<1>().state = Coefficients::makePeakFilter(spec.sampleRate, 2500.0, 1.0, juce::Decibels::decibelsToGain(-2.0f));
+        m_bands.get<2>().state = Coefficients::makeHighShelf(spec.sampleRate, 8000.0, 0.7, juce::Decibels::decibelsToGain(2.0f));
+        m_bands.prepare(spec);
+    }
+
+    void process(const juce::dsp::ProcessContextReplacing<float> &context) override { m_bands.process(context); }
+
+private:
+    using Band = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>;
+    juce::dsp::ProcessorChain<Band, Band, Band> m_bands;
+};
+
+class CompressorInsert : public DspInsert
+{
+public:
+    CompressorInsert() : DspInsert{"Compressor"}
+    {
+        m_compressor.setThreshold(-18.0f);
+        m_compressor.setRatio(3.0f);
+        m_compressor.setAttack(10.0f);
+        m_compressor.setRelease(150.0f);
+    }
+
+protected:
+    void prepare(const juce::dsp::ProcessSpec &spec) override { m_compressor.prepare(spec); }
+    void process(const juce::dsp::ProcessContextReplacing<float> &context) override { m_compressor.process(context); }
+
+private:
+    juce::dsp::Compressor<float> m_compressor;
+};
+
+class LimiterInsert : public DspInsert
+{
+public:
+    LimiterInsert() : DspInsert{"Limiter"}
+    {
+        m_limiter.setThreshold(-1.0f);
+        m_limiter.setRelease(100.0f);
+    }
+
+protected:
+    void prepare(const juce::dsp::ProcessSpec &spec) override { m_limiter.prepare(spec); }
+    void process(const juce::dsp::ProcessContextReplacing<float> &context) override { m_limiter.process(context); }
+
+private:
+    juce::dsp::Limiter<float> m_limiter;
+};
+
+class ConvolutionInsert : public DspInsert
+{
+public:
+    explicit ConvolutionInsert(const juce::File &impulseResponse) : DspInsert{"Convolution"}
+    {
+        if (impulseResponse.existsAsFile())
+        {
+            m_convolution.loadImpulseResponse(impulseResponse, juce::dsp::Convolution::Stereo::yes,
+                                              juce::dsp::Convolution::Trim::yes, 0,
+                                              juce::dsp::Convolution::Normalise::yes);
+        }
+    }
+
+protected:
+    void prepare(const juce::dsp::ProcessSpec &spec) override { m_convolution.prepare(spec); }
+    void process(const juce::dsp::ProcessContextReplacing<float> &context) override { m_convolution.process(context); }
+
+private:
+    juce::dsp::Convolution m_convolution;
+};
+}
+
+juce::String insertEffectName(InsertEffect effect)
+{
+    switch (effect)
+    {
+    case InsertEffect::equaliser: return "EQ";
+    case InsertEffect::compressor: return "Compressor";
+    case InsertEffect::limiter: return "Limiter";
+    case InsertEffect::convolution: return "Convolution";
+    }
+
+    return {};
+}
+
+std::optional<InsertEffect> insertEffectFromName(const juce::String &name)
+{
+    for (const auto effect : {InsertEffect::equaliser, InsertEffect::compressor, InsertEffect::limiter, InsertEffect::convolution})
+    {
+        if (name.equalsIgnoreCase(insertEffectName(effect)))
+        {
+            return effect;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::unique_ptr<juce::AudioProcessor> createInsertEffect(InsertEffect effect, const juce::File &impulseResponse)
+{
+    switch (effect)
+    {
+    case InsertEffect::equaliser: return std::make_unique<EqualiserInsert>();
+    case InsertEffect::compressor: return std::make_unique<CompressorInsert>();
+    case InsertEffect::limiter: return std::make_unique<LimiterInsert>();
+    case InsertEffect::convolution: return std::make_unique<ConvolutionInsert>(impulseResponse);
+    }
+
+    return {};
+}
@@ -0,0 +1,30 @@
+#ifndef INSERT_EFFECTS_H
+#define INSERT_EFFECTS_H
+
+#include <memory>
+#include <optional>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Effects that can be inserted into an EffectChain at runtime
+enum class InsertEffect
+{
+    equaliser,
+    compressor,
+    limiter,
+    convolution
+};
+
+// Names as shown in the UI ("EQ", "Compressor", "Limiter", "Convolution")
+juce::String insertEffectName(InsertEffect effect);
+std::optional<InsertEffect> insertEffectFromName(const juce::String &name);
+
+/**
+ * Creates a stereo AudioProcessor for the effect with fixed, musically neutral-ish settings.
+ *
+ * Construction may be slow (the convolution loads and resamples its impulse response), so this belongs
+ * on a background thread. impulseResponse is only used by the convolution; without one it passes audio
+ * through unchanged.
+ */
+std::unique_ptr<juce::AudioProcessor> createInsertEffect(InsertEffect effect, const juce::File &impulseResponse = {});
+
+#endif // INSERT_EFFECTS_H
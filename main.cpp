@@ -1,8 +1,15 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include "render_command.h"
 
 int main(int argc, char *argv[])
 {
+    // Offline rendering needs neither a window nor an audio device
+    if (isRenderCommand(argc, argv))
+    {
+        return runRenderCommand(argc, argv);
+    }
+
     QGuiApplication app(argc, argv);
 
     QQmlApplicationEngine engine;
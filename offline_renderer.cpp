@@ -0,0 +1,137 @@
+#include "offline_renderer.h"
+
+namespace
+{
+int chooseBitDepth(juce::AudioFormat &format)
+{
+    const auto depths(format.getPossibleBitDepths());
+    return depths.contains(24) || depths.isEmpty() ? 24 : depths.getLast();
+}
+
+// How long rendering waits for the writer to make room for a block before the job is failed
+constexpr auto writerStallTimeoutMs{30000.0};
+}
+
+OfflineRenderer::OfflineRenderer(int blockSize, int writerBufferSize)
+    : m_blockSize{juce::jmax(64, blockSize)}
+    // An AbstractFifo holds one sample less than its size, so anything smaller could never take a full block
+    , m_writerBufferSize{juce::jmax(writerBufferSize, 2 * m_blockSize)}
+    , m_formatManager{}
+    , m_writerThread{"Render writer"}
+    , m_buffer{}
+    , m_effects{}
+{
+    m_formatManager.registerBasicFormats();
+    m_writerThread.startThread();
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    m_writerThread.stopThread(1000);
+}
+
+RenderResult OfflineRenderer::render(const RenderJob &job)
+{
+    auto result{RenderResult{}};
+    const auto startTime{juce::Time::getMillisecondCounterHiRes()};
+
+    const std::unique_ptr<juce::AudioFormatReader> reader{m_formatManager.createReaderFor(job.input)};
+
+    if (reader == nullptr)
+    {
+        result.error = "Cannot read " + job.input.getFullPathName();
+        return result;
+    }
+
+    auto *format{m_formatManager.findFormatForFileExtension(job.output.getFileExtension())};
+
+    if (format == nullptr)
+    {
+        result.error = "No writable format for " + job.output.getFileName();
+        return result;
+    }
+
+    // A crash part way through leaves only the partial file behind, never a truncated output
+    const auto partial{job.output.getSiblingFile(job.output.getFileNameWithoutExtension() + ".partial"
+                                                 + job.output.getFileExtension())};
+    const auto numChannels{juce::jmax(2, static_cast<int>(reader->numChannels))};
+
+    job.output.getParentDirectory().createDirectory();
+    partial.deleteFile();
+    auto stream{std::make_unique<juce::FileOutputStream>(partial)};
+
+    if (stream->failedToOpen())
+    {
+        result.error = "Cannot create " + partial.getFullPathName();
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer{
+        format->createWriterFor(stream.get(), reader->sampleRate, static_cast<unsigned int>(numChannels),
+                                chooseBitDepth(*format), {}, 0)};
+
+    if (writer == nullptr)
+    {
+        result.error = "Cannot encode " + job.output.getFileName() + " as " + format->getFormatName();
+        return result;
+    }
+
+    // The writer owns the stream from here on
+    stream.release();
+
+    {
+        juce::AudioFormatWriter::ThreadedWriter threadedWriter{writer.release(), m_writerThread, m_writerBufferSize};
+        m_buffer.setSize(numChannels, m_blockSize, false, false, true);
+        m_effects.prepare(reader->sampleRate, m_blockSize, job.parameters);
+
+        for (juce::int64 position = 0; position < reader->lengthInSamples;)
+        {
+            const auto numSamples{static_cast<int>(juce::jmin(static_cast<juce::int64>(m_blockSize),
+                                                              reader->lengthInSamples - position))};
+
+            // Mono sources are spread to both sides exactly as the playback path does
+            reader->read(&m_buffer, 0, numSamples, position, true, true);
+            m_effects.process(m_buffer, 0, numSamples);
+
+            // The writer's FIFO is full only when encoding is slower than processing; wait for it to drain,
+            // but fail the job rather than hang if the writer stops making progress
+            const auto waitStart{juce::Time::getMillisecondCounterHiRes()};
+
+            while (! threadedWriter.write(m_buffer.getArrayOfReadPointers(), numSamples))
+            {
+                if (juce::Time::getMillisecondCounterHiRes() - waitStart > writerStallTimeoutMs)
+                {
+                    result.error = "Writer stalled while encoding " + job.output.getFileName();
+                    break;
+                }
+
+                juce::Thread::sleep(1);
+            }
+
+            if (result.error.isNotEmpty())
+            {
+                break;
+            }
+
+            position += numSamples;
+        }
+    }
+
+    if (result.error.isNotEmpty())
+    {
+        partial.deleteFile();
+        return result;
+    }
+
+    // ThreadedWriter flushes what's left when it goes out of scope, so the timing includes the encode
+    if (! partial.moveFileTo(job.output))
+    {
+        result.error = "Cannot move " + partial.getFileName() + " to " + job.output.getFullPathName();
+        return result;
+    }
+
+    result.succeeded = true;
+    result.audioSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+    result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef OFFLINE_RENDERER_H
+#define OFFLINE_RENDERER_H
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "effect_chain.h"
+#include "parameter_bridge.h"
+
+struct RenderJob
+{
+    juce::File input;
+    juce::File output;
+    PlayerParameters parameters;
+};
+
+struct RenderResult
+{
+    bool succeeded = false;
+    juce::String error;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    // Render speed as a multiple of real time
+    double speed() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+};
+
+/**
+ * Runs the player's effect chain over whole files without an audio device, as fast as the CPU allows.
+ *
+ * Each file streams from its AudioFormatReader through an EffectChain in large blocks and out through
+ * a ThreadedWriter, so encoding and disk writes overlap with processing. The writer's FIFO is bounded
+ * and rendering waits whenever it is full, so memory use doesn't grow with the length of the file; a job
+ * fails instead of waiting forever if the writer stops draining it.
+ *
+ * A renderer keeps its format manager, effect chain, block buffer and writer thread between files, so
+ * one instance per thread can work through any number of jobs. It is not itself thread-safe.
+ */
+class OfflineRenderer
+{
+public:
+    // The writer buffer is enlarged to at least two blocks so that a whole block always fits
+    explicit OfflineRenderer(int blockSize = 16384, int writerBufferSize = 65536);
+    ~OfflineRenderer();
+
+    // The output is written next to its final name and only moved into place once it is complete
+    RenderResult render(const RenderJob &job);
+
+    juce::AudioFormatManager &formatManager() { return m_formatManager; }
+
+private:
+    const int m_blockSize;
+    const int m_writerBufferSize;
+    juce::AudioFormatManager m_formatManager;
+    juce::TimeSliceThread m_writerThread;
+    juce::AudioBuffer<float> m_buffer;
+    EffectChain m_effects;
+};
+
+#endif // OFFLINE_RENDERER_H
@@ -4,12 +4,64 @@
 
 #include "panning_processor.h"
 #include <QDebug>
+#include <array>
+#include <numeric>
+
+namespace
+{
+constexpr int panLawTableSize = 256;
+
+// std::sin isn't constexpr yet; a Taylor series over [0, pi/2] is exact to float precision
+constexpr double constexprSin(double x)
+{
+    auto term{x};
+    auto sum{x};
+
+    for (auto n = 1; n < 12; ++n)
+    {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+
+    return sum;
+}
+
+// Constant-power (sin, -3 dB) law with the same sqrt(2) make-up as juce::dsp::Panner::Rule::sin3dB,
+// so the centre position stays at unity gain
+constexpr auto panLawTable{[] {
+    std::array<float, panLawTableSize + 1> table{};
+
+    for (auto i = 0; i <= panLawTableSize; ++i)
+    {
+        const auto angle{0.5 * juce::MathConstants<double>::pi * i / panLawTableSize};
+        table[static_cast<size_t>(i)] = static_cast<float>(constexprSin(angle) * juce::MathConstants<double>::sqrt2);
+    }
+
+    return table;
+}()};
+
+static_assert(panLawTable[0] == 0.0f);
+
+// Gain for a channel that is fully on at position 1 and silent at position 0
+float panLawGain(float position)
+{
+    const auto index{juce::jlimit(0.0f, static_cast<float>(panLawTableSize), position * panLawTableSize)};
+    const auto lower{juce::jmin(static_cast<int>(index), panLawTableSize - 1)};
+    const auto fraction{index - static_cast<float>(lower)};
+    return panLawTable[static_cast<size_t>(lower)]
+           + fraction * (panLawTable[static_cast<size_t>(lower) + 1] - panLawTable[static_cast<size_t>(lower)]);
+}
+
+float leftGainFor(float pan) { return panLawGain(0.5f * (1.0f - pan)); }
+float rightGainFor(float pan) { return panLawGain(0.5f * (1.0f + pan)); }
+}
 
 PanningProcessor::PanningProcessor(QObject *parent)
     : QObject{parent}
     , juce::AudioProcessor()
     , m_panParameter{nullptr}
-    , m_panner{}
+    , m_pan{}
+    , m_log{RealtimeLog::getInstance()}
 {
     m_panParameter = new juce::AudioParameterFloat("pan", "Pan", -1.0f, 1.0f, 0.0f);
     addParameter(m_panParameter);
@@ -20,26 +72,77 @@ PanningProcessor::~PanningProcessor() = default;
 void PanningProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     qInfo() << "PanningProcessor::prepareToPlay()";
-    juce::dsp::ProcessSpec spec{};
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
-    m_panner.prepare(spec);
+    m_pan.reset(sampleRate, 0.05);
+
+    // Index ramp 0, 1, 2, ... from which each block's gain ramps are built with vector operations
+    m_indexRamp.resize(static_cast<size_t>(juce::jmax(1, samplesPerBlock)));
+    std::iota(m_indexRamp.begin(), m_indexRamp.end(), 0.0f);
+    m_leftGains.resize(m_indexRamp.size());
+    m_rightGains.resize(m_indexRamp.size());
 }
 
 void PanningProcessor::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages)
 {
-    qInfo() << "PanningProcessor::processBlock() with " << buffer.getNumChannels() << " channels.";
-        juce::ScopedNoDenormals noDenormals;
-        juce::dsp::AudioBlock<float> audioBlock(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(audioBlock);
+    m_log.log(LogCategory::panner, "PanningProcessor::processBlock(), channels:", buffer.getNumChannels());
+    juce::ScopedNoDenormals noDenormals;
+
+    if (buffer.getNumChannels() < 2 || m_indexRamp.empty())
+    {
+        return;
+    }
+
+    for (auto start = 0; start < buffer.getNumSamples();)
+    {
+        const auto numSamples{juce::jmin(buffer.getNumSamples() - start, static_cast<int>(m_indexRamp.size()))};
+        const auto gains{nextGains(numSamples)};
+
+        // Even channels are treated as left and odd channels as right, so stereo pairs in wider layouts pan together
+        for (auto channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto *samples{buffer.getWritePointer(channel, start)};
+            const auto isLeft{channel % 2 == 0};
+
+            if (gains.ramping)
+            {
+                juce::FloatVectorOperations::multiply(samples, isLeft ? m_leftGains.data() : m_rightGains.data(), numSamples);
+            }
+            else
+            {
+                juce::FloatVectorOperations::multiply(samples, isLeft ? gains.left : gains.right, numSamples);
+            }
+        }
+
+        start += numSamples;
+    }
+}
+
+PanningProcessor::BlockGains PanningProcessor::nextGains(int numSamples)
+{
+    const auto startPan{m_pan.getCurrentValue()};
+    const auto endPan{m_pan.skip(numSamples)};
+    const auto startLeft{leftGainFor(startPan)};
+    const auto startRight{rightGainFor(startPan)};
+
+    if (startPan == endPan)
+    {
+        return {startLeft, startRight, false};
+    }
 
-        // Apply the panning effect
-        m_panner.process(context);
+    // Within one block the gains are interpolated linearly between the law's values at either end,
+    // which keeps the per-sample work to a multiply-add over the shared index ramp
+    const auto endLeft{leftGainFor(endPan)};
+    const auto endRight{rightGainFor(endPan)};
+    const auto scale{1.0f / static_cast<float>(numSamples)};
+
+    juce::FloatVectorOperations::copyWithMultiply(m_leftGains.data(), m_indexRamp.data(), (endLeft - startLeft) * scale, numSamples);
+    juce::FloatVectorOperations::add(m_leftGains.data(), startLeft, numSamples);
+    juce::FloatVectorOperations::copyWithMultiply(m_rightGains.data(), m_indexRamp.data(), (endRight - startRight) * scale, numSamples);
+    juce::FloatVectorOperations::add(m_rightGains.data(), startRight, numSamples);
+
+    return {endLeft, endRight, true};
 }
 
 void PanningProcessor::setPan(float pan)
 {
-    qInfo() << "PanningProcessor::setPan()";
-    m_panner.setPan(pan);
-}
\ No newline at end of file
+    m_pan.setTargetValue(juce::jlimit(-1.0f, 1.0f, pan));
+}
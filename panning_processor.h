@@ -7,7 +7,7 @@
 
 #include <QObject>
 #include "juce_audio_processors/juce_audio_processors.h"
-#include "juce_dsp/juce_dsp.h"
+#include "realtime_log.h"
 
 class PanningProcessor : public QObject, public juce::AudioProcessor
 {
@@ -36,8 +36,22 @@ public:
     void getStateInformation(juce::MemoryBlock &destData) override {}
     void setStateInformation(const void *data, int sizeInBytes) override {}
 private:
+    struct BlockGains
+    {
+        float left;
+        float right;
+        bool ramping;
+    };
+
+    // Advances the pan by one block; while it is moving the per-sample gains are left in m_leftGains/m_rightGains
+    BlockGains nextGains(int numSamples);
+
     juce::AudioParameterFloat* m_panParameter;
-    juce::dsp::Panner<float> m_panner;
+    juce::SmoothedValue<float> m_pan;
+    std::vector<float> m_indexRamp;
+    std::vector<float> m_leftGains;
+    std::vector<float> m_rightGains;
+    RealtimeLog &m_log;
 };
 
 
@@ -0,0 +1,38 @@
+#include "parameter_bridge.h"
+
+static_assert(std::atomic<int>::is_always_lock_free);
+static_assert(std::is_trivially_copyable_v<PlayerParameters>);
+
+juce::Reverb::Parameters PlayerParameters::toReverbParameters() const
+{
+    auto params{juce::Reverb::Parameters{}};
+    params.roomSize = roomSize;
+    params.damping = damping;
+    params.wetLevel = wetLevel;
+    params.dryLevel = dryLevel;
+    params.width = width;
+    params.freezeMode = freeze > 0.0f ? 1.0f : 0.0f;
+    return params;
+}
+
+ParameterBridge::ParameterBridge(const PlayerParameters &initial)
+{
+    m_buffers.fill(initial);
+}
+
+void ParameterBridge::publish(const PlayerParameters &parameters)
+{
+    m_buffers[static_cast<size_t>(m_back)] = parameters;
+    m_back = m_middle.exchange(m_back | dirtyFlag, std::memory_order_acq_rel) & ~dirtyFlag;
+}
+
+bool ParameterBridge::consume()
+{
+    if ((m_middle.load(std::memory_order_relaxed) & dirtyFlag) == 0)
+    {
+        return false;
+    }
+
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~dirtyFlag;
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef PARAMETER_BRIDGE_H
+#define PARAMETER_BRIDGE_H
+
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Plain copy of every user-facing AudioPlayer parameter.
+ * A snapshot is written on the Qt thread and read on the audio thread, so it must stay trivially copyable.
+ */
+struct PlayerParameters
+{
+    float volume = 1.0f;
+    float wetLevel = 0.33f;
+    float dryLevel = 0.4f;
+    float roomSize = 0.5f;
+    float damping = 0.5f;
+    float width = 1.0f;
+    float freeze = 0.0f;
+    float pan = 0.0f;
+
+    juce::Reverb::Parameters toReverbParameters() const;
+};
+
+/**
+ * Lock-free single-producer/single-consumer hand-off of PlayerParameters snapshots.
+ *
+ * The Qt thread calls publish() whenever a property changes; the audio thread calls consume() once
+ * per block. Both sides are wait-free: three buffers rotate through one atomic index, so the reader
+ * always sees a complete snapshot. Intermediate snapshots may be skipped under heavy automation, but
+ * the most recent one is never lost.
+ */
+class ParameterBridge
+{
+public:
+    explicit ParameterBridge(const PlayerParameters &initial = {});
+
+    // Producer side (Qt thread)
+    void publish(const PlayerParameters &parameters);
+
+    // Consumer side (audio thread). Returns true if a newer snapshot was picked up.
+    bool consume();
+    const PlayerParameters &current() const { return m_buffers[static_cast<size_t>(m_front)]; }
+
+private:
+    static constexpr int dirtyFlag = 4;
+
+    std::array<PlayerParameters, 3> m_buffers;
+    int m_back = 0;
+    int m_front = 1;
+    std::atomic<int> m_middle{2};
+};
+
+#endif // PARAMETER_BRIDGE_H
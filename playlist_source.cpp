@@ -0,0 +1,391 @@
+#include "playlist_source.h"
+
+class PlaylistSource::Track : public juce::PositionableAudioSource
+{
+public:
+    Track(juce::AudioFormatReader *reader, juce::TimeSliceThread &readAheadThread, double prefetchSeconds,
+          double readAheadSeconds, std::atomic<int> &underruns)
+        : m_length{reader->lengthInSamples}
+        , m_headLength{juce::jmin(m_length, static_cast<juce::int64>(prefetchSeconds * reader->sampleRate))}
+        , m_underruns{underruns}
+    {
+        const auto numChannels{juce::jmax(2, static_cast<int>(reader->numChannels))};
+
+        // Decode the head up front; only the remainder is streamed
+        m_headBuffer.setSize(numChannels, static_cast<int>(m_headLength));
+        reader->read(&m_headBuffer, 0, m_headBuffer.getNumSamples(), 0, true, true);
+        m_head = std::make_unique<juce::MemoryAudioSource>(m_headBuffer, false);
+
+        m_readerSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+        m_tail = std::make_unique<juce::BufferingAudioSource>(m_readerSource.get(), readAheadThread, false,
+                                                              juce::roundToInt(readAheadSeconds * reader->sampleRate),
+                                                              numChannels, false);
+        m_tail->setNextReadPosition(m_headLength);
+    }
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override
+    {
+        m_head->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        m_tail->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+
+    void releaseResources() override
+    {
+        m_head->releaseResources();
+        m_tail->releaseResources();
+    }
+
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill) override
+    {
+        const auto position{m_position.load()};
+        auto done{0};
+
+        if (position < m_headLength)
+        {
+            done = static_cast<int>(juce::jmin(static_cast<juce::int64>(bufferToFill.numSamples), m_headLength - position));
+            m_head->getNextAudioBlock({bufferToFill.buffer, bufferToFill.startSample, done});
+        }
+
+        if (done < bufferToFill.numSamples)
+        {
+            const juce::AudioSourceChannelInfo tail{bufferToFill.buffer, bufferToFill.startSample + done, bufferToFill.numSamples - done};
+
+            if (! m_tail->waitForNextAudioBlockReady(tail, 0))
+            {
+                m_underruns.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            m_tail->getNextAudioBlock(tail);
+        }
+
+        m_position = position + bufferToFill.numSamples;
+    }
+
+    void setNextReadPosition(juce::int64 newPosition) override
+    {
+        m_position = newPosition;
+        m_head->setNextReadPosition(juce::jmin(newPosition, m_headLength));
+        m_tail->setNextReadPosition(juce::jmax(newPosition, m_headLength));
+    }
+
+    juce::int64 getNextReadPosition() const override { return m_position.load(); }
+    juce::int64 getTotalLength() const override { return m_length; }
+    bool isLooping() const override { return false; }
+
+private:
+    const juce::int64 m_length;
+    const juce::int64 m_headLength;
+    std::atomic<juce::int64> m_position{0};
+    std::atomic<int> &m_underruns;
+    juce::AudioBuffer<float> m_headBuffer;
+    std::unique_ptr<juce::MemoryAudioSource> m_head;
+    std::unique_ptr<juce::AudioFormatReaderSource> m_readerSource;
+    std::unique_ptr<juce::BufferingAudioSource> m_tail;
+};
+
+class PlaylistSource::Loader : public juce::ThreadPoolJob
+{
+public:
+    explicit Loader(PlaylistSource &owner)
+        : juce::ThreadPoolJob{"Track loader"}
+        , m_owner{owner}
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        m_owner.loadNextQueued();
+        return jobHasFinished;
+    }
+
+private:
+    PlaylistSource &m_owner;
+};
+
+PlaylistSource::PlaylistSource(AudioEngine &engine)
+    : m_engine{engine}
+    , m_pollThread{engine.readAheadThread()}
+    , m_loaderPool{engine.trackLoaderPool()}
+    , m_loader{std::make_unique<Loader>(*this)}
+{
+    m_pollThread.addTimeSliceClient(this);
+}
+
+PlaylistSource::~PlaylistSource()
+{
+    m_pollThread.removeTimeSliceClient(this);
+    m_loaderPool.removeJob(m_loader.get(), true, -1);
+    deleteRetiredTracks();
+    delete m_next.exchange(nullptr);
+}
+
+bool PlaylistSource::open(const juce::File &file)
+{
+    jassert(m_current == nullptr);
+
+    m_current = loadTrack(file);
+    updateTotalLength();
+    return m_current != nullptr;
+}
+
+void PlaylistSource::enqueue(const juce::File &file)
+{
+    const juce::ScopedLock lock{m_queueLock};
+    m_queue.add(file);
+    m_pollThread.moveToFrontOfQueue(this);
+}
+
+std::unique_ptr<PlaylistSource::Track> PlaylistSource::loadTrack(const juce::File &file)
+{
+    auto *reader{m_engine.formatManager().createReaderFor(file)};
+
+    if (reader == nullptr)
+    {
+        juce::Logger::writeToLog("Failed to load audio file: " + file.getFullPathName());
+        return {};
+    }
+
+    return std::make_unique<Track>(reader, m_engine.readAheadThread(), m_prefetchSeconds.load(),
+                                   m_engine.readAheadSeconds(), m_underruns);
+}
+
+int PlaylistSource::useTimeSlice()
+{
+    deleteRetiredTracks();
+
+    // Only checks whether the next load can start: decoding a head here would stall the tails of every
+    // other stream sharing this read-ahead thread
+    if (m_next.load() != nullptr || m_loaderPool.contains(m_loader.get()))
+    {
+        return 50;
+    }
+
+    const juce::ScopedLock lock{m_queueLock};
+
+    if (! m_queue.isEmpty())
+    {
+        m_loaderPool.addJob(m_loader.get(), false);
+    }
+
+    return 50;
+}
+
+void PlaylistSource::loadNextQueued()
+{
+    for (;;)
+    {
+        auto file{juce::File{}};
+
+        {
+            const juce::ScopedLock lock{m_queueLock};
+
+            if (m_queue.isEmpty())
+            {
+                return;
+            }
+
+            file = m_queue.removeAndReturn(0);
+        }
+
+        // A file that fails to open is skipped in favour of the one after it
+        if (auto track{loadTrack(file)})
+        {
+            const juce::ScopedLock lock{m_queueLock};
+
+            if (m_sampleRate > 0.0)
+            {
+                track->prepareToPlay(m_blockSize, m_sampleRate);
+            }
+
+            m_next = track.release();
+            return;
+        }
+    }
+}
+
+void PlaylistSource::deleteRetiredTracks()
+{
+    // Tracks the audio thread has finished with are deleted here, never on the audio thread
+    m_retiredFifo.read(m_retiredFifo.getNumReady()).forEach([this](int index) {
+        delete m_retired[static_cast<size_t>(index)];
+    });
+}
+
+void PlaylistSource::retire(Track *track)
+{
+    if (track == nullptr)
+    {
+        return;
+    }
+
+    const auto scope{m_retiredFifo.write(1)};
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        // The polling thread is far behind; leaking is the only option that doesn't free on the audio thread
+        jassertfalse;
+        return;
+    }
+
+    scope.forEach([this, track](int index) { m_retired[static_cast<size_t>(index)] = track; });
+}
+
+void PlaylistSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    const juce::ScopedLock queueLock{m_queueLock};
+    const juce::SpinLock::ScopedLockType trackLock{m_trackLock};
+
+    m_blockSize = samplesPerBlockExpected;
+    m_sampleRate = sampleRate;
+    m_scratch.setSize(2, samplesPerBlockExpected);
+
+    for (auto *track : {m_current.get(), m_incoming.get(), m_next.load()})
+    {
+        if (track != nullptr)
+        {
+            track->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        }
+    }
+}
+
+void PlaylistSource::releaseResources()
+{
+    const juce::ScopedLock queueLock{m_queueLock};
+    const juce::SpinLock::ScopedLockType trackLock{m_trackLock};
+
+    m_sampleRate = 0.0;
+
+    for (auto *track : {m_current.get(), m_incoming.get(), m_next.load()})
+    {
+        if (track != nullptr)
+        {
+            track->releaseResources();
+        }
+    }
+}
+
+void PlaylistSource::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill)
+{
+    const juce::SpinLock::ScopedTryLockType lock{m_trackLock};
+
+    if (! lock.isLocked() || m_current == nullptr)
+    {
+        // A seek is in progress on another thread; one block of silence is cheaper than waiting for it
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    auto &buffer{*bufferToFill.buffer};
+    auto done{0};
+
+    while (done < bufferToFill.numSamples)
+    {
+        if (m_incoming == nullptr)
+        {
+            m_incoming.reset(m_next.exchange(nullptr));
+
+            if (m_incoming != nullptr)
+            {
+                // A track that arrives late only gets whatever overlap is still left
+                const auto crossfade{static_cast<juce::int64>(m_crossfadeSeconds.load() * m_sampleRate)};
+                const auto remaining{m_current->getTotalLength() - m_current->getNextReadPosition()};
+                m_overlap = juce::jmax(static_cast<juce::int64>(0),
+                                       juce::jmin(crossfade, remaining, m_incoming->getTotalLength()));
+            }
+        }
+
+        const auto start{bufferToFill.startSample + done};
+        const auto wanted{static_cast<juce::int64>(bufferToFill.numSamples - done)};
+        const auto remaining{m_current->getTotalLength() - m_current->getNextReadPosition()};
+
+        if (remaining <= 0)
+        {
+            if (m_incoming == nullptr)
+            {
+                // End of the playlist: keep counting so the transport sees the stream run out
+                buffer.clear(start, static_cast<int>(wanted));
+                break;
+            }
+
+            m_trackStart = m_position.load() + done - m_incoming->getNextReadPosition();
+            retire(m_current.release());
+            m_current = std::move(m_incoming);
+            m_overlap = 0;
+            continue;
+        }
+
+        if (m_incoming == nullptr || remaining > m_overlap)
+        {
+            const auto solo{m_incoming == nullptr ? remaining : remaining - m_overlap};
+            const auto num{static_cast<int>(juce::jmin(wanted, solo))};
+            m_current->getNextAudioBlock({&buffer, start, num});
+            done += num;
+            continue;
+        }
+
+        // Crossfade: the outgoing track ramps down while the incoming one ramps up over the overlap
+        const auto num{static_cast<int>(juce::jmin(wanted, remaining, static_cast<juce::int64>(m_scratch.getNumSamples())))};
+        const auto startGain{static_cast<float>(remaining) / static_cast<float>(m_overlap)};
+        const auto endGain{static_cast<float>(remaining - num) / static_cast<float>(m_overlap)};
+
+        m_current->getNextAudioBlock({&buffer, start, num});
+        m_incoming->getNextAudioBlock({&m_scratch, 0, num});
+
+        for (auto channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.applyGainRamp(channel, start, num, startGain, endGain);
+
+            if (channel < m_scratch.getNumChannels())
+            {
+                buffer.addFromWithRamp(channel, start, m_scratch.getReadPointer(channel), num, 1.0f - startGain, 1.0f - endGain);
+            }
+        }
+
+        done += num;
+    }
+
+    m_position += bufferToFill.numSamples;
+    updateTotalLength();
+}
+
+void PlaylistSource::setNextReadPosition(juce::int64 newPosition)
+{
+    // Seeking stays within the current track
+    const juce::SpinLock::ScopedLockType lock{m_trackLock};
+
+    if (m_current == nullptr)
+    {
+        return;
+    }
+
+    const auto local{juce::jlimit(static_cast<juce::int64>(0), m_current->getTotalLength(), newPosition - m_trackStart)};
+    m_current->setNextReadPosition(local);
+    m_position = m_trackStart + local;
+
+    if (m_incoming != nullptr)
+    {
+        m_incoming->setNextReadPosition(0);
+    }
+}
+
+void PlaylistSource::updateTotalLength()
+{
+    if (m_current == nullptr)
+    {
+        m_totalLength = 0;
+        return;
+    }
+
+    auto total{m_trackStart + m_current->getTotalLength()};
+
+    if (m_incoming != nullptr)
+    {
+        total += m_incoming->getTotalLength() - m_overlap;
+    }
+    else if (const auto *next{m_next.load()})
+    {
+        total += next->getTotalLength();
+    }
+
+    m_totalLength = total;
+}
@@ -0,0 +1,88 @@
+#ifndef PLAYLIST_SOURCE_H
+#define PLAYLIST_SOURCE_H
+
+#include <array>
+#include <atomic>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "audio_engine.h"
+
+/**
+ * Gapless queue of files presented to the transport as one continuous PositionableAudioSource.
+ *
+ * Every track keeps its first few seconds pre-decoded in a MemoryAudioSource and streams the rest
+ * through a BufferingAudioSource, so a queued track is ready to sound the moment it is needed. Queued
+ * files are opened and pre-decoded on the engine's track loader pool while the current track plays,
+ * so the read-ahead threads stay free to keep every voice's tail buffered; the audio thread switches to
+ * the next track at the exact sample where the current one ends, optionally overlapping the two with an
+ * equal-gain crossfade.
+ */
+class PlaylistSource : public juce::PositionableAudioSource, private juce::TimeSliceClient
+{
+public:
+    explicit PlaylistSource(AudioEngine &engine);
+    ~PlaylistSource() override;
+
+    // Loads the first track synchronously, before the source is handed to a transport
+    bool open(const juce::File &file);
+
+    // Appends a file to the queue; it is loaded in the background
+    void enqueue(const juce::File &file);
+
+    void setCrossfadeSeconds(double seconds) { m_crossfadeSeconds = juce::jmax(0.0, seconds); }
+    void setPrefetchSeconds(double seconds) { m_prefetchSeconds = juce::jmax(0.0, seconds); }
+
+    // Blocks in which a track's read-ahead buffer hadn't caught up and part of the output was silence
+    int underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override { return m_position.load(); }
+    juce::int64 getTotalLength() const override { return m_totalLength.load(); }
+    bool isLooping() const override { return false; }
+
+private:
+    class Track;
+    class Loader;
+
+    std::unique_ptr<Track> loadTrack(const juce::File &file);
+    void loadNextQueued();
+    int useTimeSlice() override;
+    void deleteRetiredTracks();
+    void retire(Track *track);
+    void updateTotalLength();
+
+    AudioEngine &m_engine;
+    juce::TimeSliceThread &m_pollThread;
+    juce::ThreadPool &m_loaderPool;
+    std::unique_ptr<Loader> m_loader;
+
+    // Tracks owned by the audio thread; other threads only touch them while holding m_trackLock
+    juce::SpinLock m_trackLock;
+    std::unique_ptr<Track> m_current;
+    std::unique_ptr<Track> m_incoming;
+    juce::int64 m_trackStart{0};
+    juce::int64 m_overlap{0};
+    juce::AudioBuffer<float> m_scratch;
+
+    // Hand-off from the loader pool to the audio thread, and back to the polling thread for deletion
+    std::atomic<Track *> m_next{nullptr};
+    juce::AbstractFifo m_retiredFifo{16};
+    std::array<Track *, 16> m_retired{};
+
+    juce::CriticalSection m_queueLock;
+    juce::Array<juce::File> m_queue;
+    int m_blockSize{0};
+    double m_sampleRate{0.0};
+
+    std::atomic<juce::int64> m_position{0};
+    std::atomic<juce::int64> m_totalLength{0};
+    std::atomic<double> m_crossfadeSeconds{0.0};
+    std::atomic<double> m_prefetchSeconds{5.0};
+    std::atomic<int> m_underruns{0};
+};
+
+#endif // PLAYLIST_SOURCE_H
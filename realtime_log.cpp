@@ -0,0 +1,179 @@
+#include "realtime_log.h"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+namespace
+{
+const char *categoryName(LogCategory category)
+{
+    switch (category)
+    {
+    case LogCategory::player: return "player";
+    case LogCategory::panner: return "panner";
+    case LogCategory::transport: return "transport";
+    case LogCategory::numCategories: break;
+    }
+
+    return "unknown";
+}
+}
+
+RealtimeLog &RealtimeLog::getInstance()
+{
+    static RealtimeLog instance;
+    return instance;
+}
+
+RealtimeLog::RealtimeLog()
+    : juce::Thread{"Realtime log"}
+    , m_ticksPerSecond{juce::Time::getHighResolutionTicksPerSecond()}
+{
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    startThread(juce::Thread::Priority::low);
+}
+
+RealtimeLog::~RealtimeLog()
+{
+    stopThread(1000);
+    flush();
+}
+
+bool RealtimeLog::log(LogCategory category, const char *message) noexcept
+{
+    return push(category, message, 0, 0.0, 0.0);
+}
+
+bool RealtimeLog::log(LogCategory category, const char *message, double value) noexcept
+{
+    return push(category, message, 1, value, 0.0);
+}
+
+bool RealtimeLog::log(LogCategory category, const char *message, double value1, double value2) noexcept
+{
+    return push(category, message, 2, value1, value2);
+}
+
+void RealtimeLog::setRateLimit(LogCategory category, int recordsPerSecond) noexcept
+{
+    m_limiters[static_cast<size_t>(category)].limit.store(juce::jmax(0, recordsPerSecond), std::memory_order_relaxed);
+}
+
+bool RealtimeLog::admit(LogCategory category, int64_t ticks) noexcept
+{
+    auto &limiter{m_limiters[static_cast<size_t>(category)]};
+    const auto limit{limiter.limit.load(std::memory_order_relaxed)};
+
+    if (limit == 0)
+    {
+        return true;
+    }
+
+    // Fixed one-second windows; whoever notices the window has expired restarts it
+    auto windowStart{limiter.windowStart.load(std::memory_order_relaxed)};
+
+    if (ticks - windowStart >= m_ticksPerSecond
+        && limiter.windowStart.compare_exchange_strong(windowStart, ticks, std::memory_order_relaxed))
+    {
+        limiter.count.store(0, std::memory_order_relaxed);
+    }
+
+    return limiter.count.fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+bool RealtimeLog::push(LogCategory category, const char *message, int numValues, double value1, double value2) noexcept
+{
+    const auto ticks{juce::Time::getHighResolutionTicks()};
+
+    if (! admit(category, ticks))
+    {
+        m_droppedRateLimited.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Bounded multi-producer ring: a slot is free for position p once its sequence equals p.
+    // Producers give up after a few contended attempts rather than spin on the audio thread.
+    auto position{m_writePosition.load(std::memory_order_relaxed)};
+
+    for (auto attempt = 0; attempt < maxPushAttempts; ++attempt)
+    {
+        auto &slot{m_slots[position % capacity]};
+        const auto sequence{slot.sequence.load(std::memory_order_acquire)};
+        const auto difference{static_cast<int64_t>(sequence - position)};
+
+        if (difference < 0)
+        {
+            break;
+        }
+
+        if (difference > 0)
+        {
+            position = m_writePosition.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (m_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+            slot.record = Record{ticks, message, {value1, value2}, category, static_cast<uint8_t>(numValues)};
+            slot.sequence.store(position + 1, std::memory_order_release);
+            m_written.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    m_droppedFull.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void RealtimeLog::run()
+{
+    while (! threadShouldExit())
+    {
+        flush();
+        wait(50);
+    }
+}
+
+void RealtimeLog::flush()
+{
+    for (;;)
+    {
+        auto &slot{m_slots[m_readPosition % capacity]};
+
+        if (slot.sequence.load(std::memory_order_acquire) != m_readPosition + 1)
+        {
+            break;
+        }
+
+        const auto record{slot.record};
+        slot.sequence.store(m_readPosition + capacity, std::memory_order_release);
+        ++m_readPosition;
+
+        auto line{juce::String{"["} + categoryName(record.category) + "] "
+                  + juce::String{juce::Time::highResolutionTicksToSeconds(record.ticks), 6} + " "
+                  + record.message};
+
+        for (auto i = 0; i < record.numValues; ++i)
+        {
+            line << " " << record.values[i];
+        }
+
+        juce::Logger::writeToLog(line);
+    }
+
+    const auto drops{numDroppedFull() + numDroppedRateLimited()};
+    const auto now{juce::Time::getHighResolutionTicks()};
+
+    if (drops != m_reportedDrops && now - m_lastDropReport >= m_ticksPerSecond)
+    {
+        juce::Logger::writeToLog("[log] " + juce::String{static_cast<juce::int64>(drops - m_reportedDrops)}
+                                 + " records dropped (full: " + juce::String{static_cast<juce::int64>(numDroppedFull())}
+                                 + ", rate limited: " + juce::String{static_cast<juce::int64>(numDroppedRateLimited())} + ")");
+        m_reportedDrops = drops;
+        m_lastDropReport = now;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef REALTIME_LOG_H
+#define REALTIME_LOG_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+
+enum class LogCategory : uint8_t
+{
+    player,
+    panner,
+    transport,
+    numCategories
+};
+
+/**
+ * Logging channel that is safe to call from the audio callback.
+ *
+ * log() copies a fixed-size binary record into a bounded ring and never blocks, allocates or takes a
+ * lock; when the ring is full or a category is over its rate limit the record is counted and dropped.
+ * A background thread drains the ring, formats the records and hands them to juce::Logger.
+ *
+ * Messages are stored by pointer, so they must be string literals or otherwise outlive the log.
+ */
+class RealtimeLog : private juce::Thread
+{
+public:
+    static RealtimeLog &getInstance();
+
+    ~RealtimeLog() override;
+
+    bool log(LogCategory category, const char *message) noexcept;
+    bool log(LogCategory category, const char *message, double value) noexcept;
+    bool log(LogCategory category, const char *message, double value1, double value2) noexcept;
+
+    // Maximum number of records accepted per category per second, 0 means unlimited
+    void setRateLimit(LogCategory category, int recordsPerSecond) noexcept;
+
+    uint64_t numWritten() const noexcept { return m_written.load(std::memory_order_relaxed); }
+    uint64_t numDroppedFull() const noexcept { return m_droppedFull.load(std::memory_order_relaxed); }
+    uint64_t numDroppedRateLimited() const noexcept { return m_droppedRateLimited.load(std::memory_order_relaxed); }
+
+private:
+    RealtimeLog();
+
+    struct Record
+    {
+        int64_t ticks;
+        const char *message;
+        double values[2];
+        LogCategory category;
+        uint8_t numValues;
+    };
+
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
+    struct RateLimiter
+    {
+        std::atomic<int> limit{20};
+        std::atomic<int64_t> windowStart{0};
+        std::atomic<int> count{0};
+    };
+
+    static constexpr size_t capacity = 4096;
+    static constexpr int maxPushAttempts = 4;
+
+    bool push(LogCategory category, const char *message, int numValues, double value1, double value2) noexcept;
+    bool admit(LogCategory category, int64_t ticks) noexcept;
+    void run() override;
+    void flush();
+
+    std::array<Slot, capacity> m_slots;
+    std::atomic<uint64_t> m_writePosition{0};
+    uint64_t m_readPosition{0};
+
+    std::array<RateLimiter, static_cast<size_t>(LogCategory::numCategories)> m_limiters;
+    const int64_t m_ticksPerSecond;
+
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_droppedFull{0};
+    std::atomic<uint64_t> m_droppedRateLimited{0};
+    uint64_t m_reportedDrops{0};
+    int64_t m_lastDropReport{0};
+};
+
+#endif // REALTIME_LOG_H
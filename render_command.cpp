@@ -0,0 +1,151 @@
+#include "render_command.h"
+#include "render_farm.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QMutex>
+#include <QTextStream>
+#include <cstring>
+
+namespace
+{
+struct ParameterOption
+{
+    const char *name;
+    const char *description;
+    float PlayerParameters::*member;
+};
+
+const ParameterOption parameterOptions[] = {
+    {"volume", "Output gain.", &PlayerParameters::volume},
+    {"wet", "Reverb wet level.", &PlayerParameters::wetLevel},
+    {"dry", "Reverb dry level.", &PlayerParameters::dryLevel},
+    {"room-size", "Reverb room size.", &PlayerParameters::roomSize},
+    {"damping", "Reverb damping.", &PlayerParameters::damping},
+    {"width", "Reverb width.", &PlayerParameters::width},
+    {"freeze", "Reverb freeze mode.", &PlayerParameters::freeze},
+    {"pan", "Pan position, -1 to 1.", &PlayerParameters::pan},
+};
+}
+
+bool isRenderCommand(int argc, char *argv[])
+{
+    for (auto i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--render") == 0 || std::strncmp(argv[i], "--render=", 9) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int runRenderCommand(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders files through the player's effect chain without an audio device.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Audio files, or directories to render recursively.", "<inputs...>");
+
+    const QCommandLineOption renderOption("render", "Directory the rendered files are written to.", "directory");
+    const QCommandLineOption jobsOption("jobs", "Number of files rendered in parallel.", "count",
+                                        QString::number(juce::SystemStats::getNumCpus()));
+    const QCommandLineOption blockSizeOption("block-size", "Samples processed per block.", "samples", "16384");
+    const QCommandLineOption formatOption("format", "Output file extension.", "extension", "wav");
+    const QCommandLineOption reportOption("report", "CSV file the per-file throughput is written to.", "file");
+    parser.addOptions({renderOption, jobsOption, blockSizeOption, formatOption, reportOption});
+
+    for (const auto &parameter : parameterOptions)
+    {
+        parser.addOption(QCommandLineOption(parameter.name, parameter.description, "value",
+                                            QString::number(PlayerParameters{}.*parameter.member)));
+    }
+
+    parser.process(app);
+
+    auto options{RenderFarm::Options{}};
+    options.numWorkers = parser.value(jobsOption).toInt();
+    options.outputExtension = parser.value(formatOption).toStdString();
+
+    // Any size is fine from here on, since the renderer grows the writer's FIFO to hold two blocks
+    auto blockSizeOk{false};
+    options.blockSize = parser.value(blockSizeOption).toInt(&blockSizeOk);
+
+    if (! blockSizeOk || options.blockSize <= 0)
+    {
+        qCritical() << "--block-size must be a positive number of samples";
+        return 1;
+    }
+
+    for (const auto &parameter : parameterOptions)
+    {
+        options.parameters.*parameter.member = parser.value(parameter.name).toFloat();
+    }
+
+    const QDir outputDirectory(parser.value(renderOption));
+
+    if (! outputDirectory.mkpath("."))
+    {
+        qCritical() << "Cannot create output directory" << outputDirectory.path();
+        return 1;
+    }
+
+    RenderFarm farm{juce::File{outputDirectory.absolutePath().toStdString()}, options};
+
+    for (const auto &input : parser.positionalArguments())
+    {
+        farm.addInput(juce::File{QDir(input).absolutePath().toStdString()});
+    }
+
+    if (farm.numQueued() == 0)
+    {
+        parser.showHelp(1);
+    }
+
+    // Progress lines come from the worker threads as files finish
+    QMutex outputLock;
+
+    farm.run([&out, &outputLock](const RenderFarm::Entry &entry) {
+        const QMutexLocker locker(&outputLock);
+        const auto name{QString::fromStdString(entry.job.input.getFileName().toStdString())};
+
+        if (! entry.result.succeeded)
+        {
+            out << name << ": failed, " << QString::fromStdString(entry.result.error.toStdString()) << Qt::endl;
+            return;
+        }
+
+        out << name << ": " << QString::number(entry.result.audioSeconds, 'f', 1) << " s in "
+            << QString::number(entry.result.wallSeconds, 'f', 2) << " s ("
+            << QString::number(entry.result.speed(), 'f', 1) << "x real time)" << Qt::endl;
+    });
+
+    auto failures{0};
+    auto audioSeconds{0.0};
+
+    for (const auto &entry : farm.entries())
+    {
+        failures += entry.result.succeeded ? 0 : 1;
+        audioSeconds += entry.result.audioSeconds;
+    }
+
+    if (parser.isSet(reportOption) && ! farm.writeReport(juce::File{QDir(parser.value(reportOption)).absolutePath().toStdString()}))
+    {
+        qCritical() << "Cannot write report" << parser.value(reportOption);
+    }
+
+    // Aggregate speed counts wall time once, so it reflects what the parallelism bought
+    const auto rendered{static_cast<int>(farm.entries().size())};
+    out << "Rendered " << rendered - failures << " of " << rendered << " files (" << farm.numSkipped()
+        << " already done), " << QString::number(audioSeconds, 'f', 1) << " s of audio in "
+        << QString::number(farm.wallSeconds(), 'f', 2) << " s ("
+        << QString::number(farm.wallSeconds() > 0.0 ? audioSeconds / farm.wallSeconds() : 0.0, 'f', 1)
+        << "x real time)" << Qt::endl;
+
+    return failures == 0 ? 0 : 1;
+}
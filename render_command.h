@@ -0,0 +1,16 @@
+#ifndef RENDER_COMMAND_H
+#define RENDER_COMMAND_H
+
+/**
+ * Command line front end for OfflineRenderer:
+ *
+ *     appJUCETest --render <output dir> [--jobs N] [--block-size N] [--format wav] [--report file.csv]
+ *                 [--pan p] ... <files or directories>
+ *
+ * Runs without a window or an audio device and prints the render speed of every file as a multiple
+ * of real time. Running the same command again resumes an interrupted batch.
+ */
+bool isRenderCommand(int argc, char *argv[]);
+int runRenderCommand(int argc, char *argv[]);
+
+#endif // RENDER_COMMAND_H
@@ -0,0 +1,174 @@
+#include "render_farm.h"
+#include <set>
+
+class RenderFarm::Worker : public juce::ThreadPoolJob
+{
+public:
+    Worker(RenderFarm &farm, std::function<void(const Entry &)> onFinished)
+        : juce::ThreadPoolJob{"Render worker"}
+        , m_farm{farm}
+        , m_onFinished{std::move(onFinished)}
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // Built on the pool thread so each worker's allocations stay local to it
+        OfflineRenderer renderer{m_farm.m_options.blockSize, m_farm.m_options.writerBufferSize};
+
+        while (! shouldExit())
+        {
+            const auto index{m_farm.m_nextEntry.fetch_add(1)};
+
+            if (index >= m_farm.m_entries.size())
+            {
+                break;
+            }
+
+            auto &entry{m_farm.m_entries[index]};
+            entry.result = renderer.render(entry.job);
+            m_farm.finish(entry, m_onFinished);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    RenderFarm &m_farm;
+    const std::function<void(const Entry &)> m_onFinished;
+};
+
+RenderFarm::RenderFarm(const juce::File &outputDirectory, const Options &options)
+    : m_outputDirectory{outputDirectory}
+    , m_options{options}
+    , m_optionsHash{hashOptions(options)}
+{
+    auto formatManager{juce::AudioFormatManager{}};
+    formatManager.registerBasicFormats();
+    m_wildcard = formatManager.getWildcardForAllFormats();
+}
+
+void RenderFarm::addInput(const juce::File &input)
+{
+    if (! input.isDirectory())
+    {
+        addFile(input, m_outputDirectory.getChildFile(input.getFileName()));
+        return;
+    }
+
+    for (const auto &item : juce::RangedDirectoryIterator{input, true, m_wildcard, juce::File::findFiles})
+    {
+        // Rendering into a directory below the input must not feed earlier results back in
+        if (item.getFile().isAChildOf(m_outputDirectory))
+        {
+            continue;
+        }
+
+        addFile(item.getFile(), m_outputDirectory.getChildFile(item.getFile().getRelativePathFrom(input)));
+    }
+}
+
+void RenderFarm::addFile(const juce::File &input, const juce::File &output)
+{
+    m_entries.push_back({{input, output.withFileExtension(m_options.outputExtension), m_options.parameters}, {}});
+}
+
+juce::String RenderFarm::hashOptions(const Options &options)
+{
+    // Everything that changes what ends up in an output file; the worker count and FIFO size don't
+    juce::MemoryOutputStream stream;
+    stream.writeString(options.outputExtension.toLowerCase());
+    stream.writeInt(options.blockSize);
+
+    for (const auto value : {options.parameters.volume, options.parameters.wetLevel, options.parameters.dryLevel,
+                             options.parameters.roomSize, options.parameters.damping, options.parameters.width,
+                             options.parameters.freeze, options.parameters.pan})
+    {
+        stream.writeFloat(value);
+    }
+
+    return juce::String::toHexString(stream.getMemoryBlock().toBase64Encoding().hashCode64());
+}
+
+void RenderFarm::run(std::function<void(const Entry &)> onFinished)
+{
+    const auto startTime{juce::Time::getMillisecondCounterHiRes()};
+    m_outputDirectory.createDirectory();
+
+    // Lines are "input path<TAB>options hash<TAB>audio seconds<TAB>wall seconds"; the path and hash decide
+    // what can be skipped, so renders made with other options are redone rather than kept
+    std::set<std::pair<juce::String, juce::String>> done;
+
+    for (const auto &line : juce::StringArray::fromLines(manifestFile().loadFileAsString()))
+    {
+        const auto fields{juce::StringArray::fromTokens(line, "\t", {})};
+
+        if (fields.size() >= 2)
+        {
+            done.emplace(fields[0], fields[1]);
+        }
+    }
+
+    const auto previous{m_entries.size()};
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [this, &done](const Entry &entry) {
+        return done.count({entry.job.input.getFullPathName(), m_optionsHash}) > 0 && entry.job.output.existsAsFile();
+    }), m_entries.end());
+    m_skipped = static_cast<int>(previous - m_entries.size());
+
+    m_manifest = std::make_unique<juce::FileOutputStream>(manifestFile());
+    m_nextEntry = 0;
+
+    const auto numWorkers{juce::jlimit(1, juce::jmax(1, static_cast<int>(m_entries.size())), m_options.numWorkers)};
+    juce::OwnedArray<Worker> workers;
+    juce::ThreadPool pool{numWorkers};
+
+    for (auto i = 0; i < numWorkers; ++i)
+    {
+        pool.addJob(workers.add(new Worker{*this, onFinished}), false);
+    }
+
+    for (auto *worker : workers)
+    {
+        pool.waitForJobToFinish(worker, -1);
+    }
+
+    m_manifest.reset();
+    m_wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+}
+
+void RenderFarm::finish(Entry &entry, const std::function<void(const Entry &)> &onFinished)
+{
+    if (entry.result.succeeded)
+    {
+        // Flushed per file so a crash loses at most the files still in flight
+        const juce::ScopedLock lock{m_manifestLock};
+
+        if (m_manifest != nullptr && m_manifest->openedOk())
+        {
+            *m_manifest << entry.job.input.getFullPathName() << "\t" << m_optionsHash << "\t"
+                        << entry.result.audioSeconds << "\t" << entry.result.wallSeconds << "\n";
+            m_manifest->flush();
+        }
+    }
+
+    if (onFinished)
+    {
+        onFinished(entry);
+    }
+}
+
+bool RenderFarm::writeReport(const juce::File &file) const
+{
+    auto report{juce::String{"file,status,audio seconds,wall seconds,speed\n"}};
+
+    for (const auto &entry : m_entries)
+    {
+        const auto &result{entry.result};
+        report << entry.job.input.getFullPathName().quoted() << ","
+               << (result.succeeded ? juce::String{"ok"} : result.error.quoted()) << ","
+               << juce::String{result.audioSeconds, 3} << "," << juce::String{result.wallSeconds, 3} << ","
+               << juce::String{result.speed(), 1} << "\n";
+    }
+
+    return file.replaceWithText(report);
+}
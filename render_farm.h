@@ -0,0 +1,82 @@
+#ifndef RENDER_FARM_H
+#define RENDER_FARM_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "offline_renderer.h"
+
+/**
+ * Renders a batch of files, typically whole directory trees, across every core.
+ *
+ * The pool runs one long-lived worker per thread. Each worker owns an OfflineRenderer (format manager,
+ * effect chain, buffers and writer thread) and pulls the next file off a shared atomic index, so the
+ * workers share nothing on the hot path and throughput scales with the number of cores until the disks
+ * give out. Memory is bounded by the workers rather than the batch: every worker holds one block and
+ * one writer FIFO, and waits when the FIFO is full.
+ *
+ * Completed files are appended to a manifest in the output directory as they finish, together with a
+ * hash of the options they were rendered with. A batch that is started again after a crash skips
+ * everything the manifest lists with the same options whose output still exists; a batch started with
+ * different effect parameters, output format or block size renders everything again.
+ */
+class RenderFarm
+{
+public:
+    struct Options
+    {
+        int numWorkers = juce::SystemStats::getNumCpus();
+        int blockSize = 16384;
+        int writerBufferSize = 65536;
+        juce::String outputExtension = "wav";
+        PlayerParameters parameters;
+    };
+
+    struct Entry
+    {
+        RenderJob job;
+        RenderResult result;
+    };
+
+    RenderFarm(const juce::File &outputDirectory, const Options &options);
+
+    // Adds a file, or every readable file below a directory with its relative layout kept in the output
+    void addInput(const juce::File &input);
+
+    int numQueued() const { return static_cast<int>(m_entries.size()); }
+
+    // Renders everything that isn't already in the manifest. onFinished is called from worker threads.
+    void run(std::function<void(const Entry &)> onFinished = {});
+
+    // Entries rendered by the last run(), in the order they were added
+    const std::vector<Entry> &entries() const { return m_entries; }
+    int numSkipped() const { return m_skipped; }
+    double wallSeconds() const { return m_wallSeconds; }
+
+    // Writes one line per rendered file: input, status, audio seconds, wall seconds, speed
+    bool writeReport(const juce::File &file) const;
+
+    juce::File manifestFile() const { return m_outputDirectory.getChildFile("render-manifest.txt"); }
+
+private:
+    class Worker;
+
+    void addFile(const juce::File &input, const juce::File &output);
+    static juce::String hashOptions(const Options &options);
+    void finish(Entry &entry, const std::function<void(const Entry &)> &onFinished);
+
+    const juce::File m_outputDirectory;
+    const Options m_options;
+    const juce::String m_optionsHash;
+    juce::String m_wildcard;
+    std::vector<Entry> m_entries;
+    std::atomic<size_t> m_nextEntry{0};
+
+    juce::CriticalSection m_manifestLock;
+    std::unique_ptr<juce::FileOutputStream> m_manifest;
+
+    int m_skipped{0};
+    double m_wallSeconds{0.0};
+};
+
+#endif // RENDER_FARM_H